@@ -19,9 +19,20 @@ SOURCES += \
     src/renderer/animation.cpp \
     src/renderer/skeleton.cpp \
     src/ecs/world.cpp \
+    src/ecs/chunkpool.cpp \
+    src/ecs/commandbuffer.cpp \
+    src/ecs/scheduler.cpp \
+    src/ecs/gameloop.cpp \
+    src/ecs/transformsystem.cpp \
+    src/ecs/nameindex.cpp \
+    src/ecs/prefab.cpp \
+    src/jobs/jobsystem.cpp \
     src/ecs/animatorgraph.cpp \
+    src/physics/aabbtree.cpp \
+    src/physics/bodyarrays.cpp \
     src/physics/butsuri.cpp \
     src/physics/physicssystem.cpp \
+    src/physics/sweepandprune.cpp \
     src/scripting/scriptingengine.cpp \
     src/scripting/scriptinternalcalls.cpp \
     src/editor/scripteditor.cpp
@@ -39,6 +50,17 @@ HEADERS += \
     include/renderer/openglrenderer.h \
     include/renderer/meshloader.h \
     include/ecs/world.h \
+    include/ecs/archetype.h \
+    include/ecs/chunkpool.h \
+    include/ecs/commandbuffer.h \
+    include/ecs/scheduler.h \
+    include/ecs/gameloop.h \
+    include/ecs/systems/transformsystem.h \
+    include/ecs/nameindex.h \
+    include/ecs/prefab.h \
+    include/ecs/memoryreport.h \
+    include/jobs/jobsystem.h \
+    include/ecs/view.h \
     include/ecs/component.h \
     include/ecs/entity.h \
     include/ecs/system.h \
@@ -57,8 +79,11 @@ HEADERS += \
     include/ecs/systems/animationsystem.h \
     include/renderer/animation.h \
     include/renderer/skeleton.h \
+    include/physics/aabbtree.h \
+    include/physics/bodyarrays.h \
     include/physics/simplephysics.h \
     include/physics/physicssystem.h \
+    include/physics/sweepandprune.h \
     include/scripting/scriptingengine.h \
     include/scripting/scriptinternalcalls.h \
     include/editor/scripteditor.h \
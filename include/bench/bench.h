@@ -0,0 +1,47 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <limits>
+
+namespace DabozzEngine {
+namespace Bench {
+
+struct Options {
+    size_t maxThreads = 1;       // scaling runs go from one thread up to this
+    int repeats = 5;             // each timing is the best of this many runs
+    const char* simd = nullptr;  // run the body kernels on only this path
+};
+
+using Clock = std::chrono::steady_clock;
+
+inline double elapsedMs(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Fastest of repeats runs of function, in milliseconds
+template<typename F>
+double bestMs(int repeats, F&& function)
+{
+    double best = std::numeric_limits<double>::max();
+    for (int run = 0; run < std::max(repeats, 1); ++run) {
+        const Clock::time_point start = Clock::now();
+        function();
+        best = std::min(best, elapsedMs(start));
+    }
+    return best;
+}
+
+// Keeps a result alive so the optimizer can't drop the work behind it
+void consume(double value);
+
+void runJobBenchmarks(const Options& options);
+void runEntityBenchmarks(const Options& options);
+void runViewBenchmarks(const Options& options);
+void runBroadPhaseBenchmarks(const Options& options);
+void runBodyBenchmarks(const Options& options);
+
+}
+}
@@ -0,0 +1,353 @@
+#pragma once
+
+#include "ecs/entity.h"
+#include "ecs/component.h"
+#include "ecs/chunkpool.h"
+#include "ecs/memoryreport.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
+
+namespace DabozzEngine {
+namespace ECS {
+
+// Rows per storage chunk. Chunks are never reallocated, so a component keeps
+// its address until its own entity changes archetype or is destroyed (or it
+// is the last row of an archetype another entity leaves).
+constexpr size_t ARCHETYPE_CHUNK_SIZE = 256;
+
+// Unqualified type name, e.g. "Transform", for tools and diagnostics.
+template<typename T>
+const char* componentName() {
+    static const std::string name = [] {
+        std::string full = typeid(T).name();
+#if defined(__GNUG__)
+        int status = 0;
+        if (char* demangled = abi::__cxa_demangle(full.c_str(), nullptr, nullptr, &status)) {
+            full = demangled;
+            std::free(demangled);
+        }
+#endif
+        size_t scope = full.rfind("::");
+        return scope == std::string::npos ? full : full.substr(scope + 2);
+    }();
+    return name.c_str();
+}
+
+// Type-erased storage for one component type inside an archetype.
+class ComponentColumn {
+public:
+    ComponentColumn(ComponentTypeID type, ChunkPool& pool) : m_type(type), m_pool(pool) {}
+    virtual ~ComponentColumn() = default;
+
+    // An empty column of the same type, allocating from pool (which may
+    // belong to another World).
+    virtual std::unique_ptr<ComponentColumn> createEmpty(ChunkPool& pool) const = 0;
+    virtual Component* get(size_t row) = 0;
+    virtual const Component* get(size_t row) const = 0;
+
+    ComponentTypeID type() const { return m_type; }
+
+    // For World::stats(): the component type's name and size, chunk memory
+    // held (live rows or not), and each row's buffers (see MemoryReport).
+    virtual const char* typeName() const = 0;
+    virtual size_t componentSize() const = 0;
+    virtual size_t reservedBytes() const = 0;
+    virtual void reportBuffers(MemoryReport& report) const = 0;
+
+    // Move-constructs src[srcRow] onto the end of this column.
+    virtual void moveAppend(ComponentColumn& src, size_t srcRow) = 0;
+
+    // Copy-constructs src[srcRow] onto the end of this column, stamped with
+    // changeTick. src may belong to another World.
+    virtual void copyAppend(const ComponentColumn& src, size_t srcRow, uint32_t changeTick) = 0;
+
+    // Destroys row and moves the last row into its place.
+    virtual void swapRemove(size_t row) = 0;
+
+    // Destroys every row.
+    virtual void clear() = 0;
+
+    // Snapshot support. share() appends a reference to every chunk; from
+    // then on the column copies a chunk before writing to it. adopt()
+    // replaces all rows with chunks from share(), stamped as changed at tick.
+    virtual void share(std::vector<std::shared_ptr<void>>& chunks) = 0;
+    virtual void adopt(const std::vector<std::shared_ptr<void>>& chunks, size_t size, uint32_t tick) = 0;
+
+    size_t size() const { return m_size; }
+
+    // World change tick at which each row was last added or marked changed.
+    const uint32_t* changeTicks() const { return m_changeTicks.data(); }
+    void setChangeTick(size_t row, uint32_t tick) {
+        m_changeTicks[row] = tick;
+        noteChangeTick(tick);
+    }
+
+    // Newest tick any row has had, so change queries can skip the column.
+    uint32_t lastChangeTick() const { return m_lastChangeTick.load(std::memory_order_relaxed); }
+
+protected:
+    void noteChangeTick(uint32_t tick) {
+        uint32_t last = m_lastChangeTick.load(std::memory_order_relaxed);
+        while (tick > last && !m_lastChangeTick.compare_exchange_weak(last, tick, std::memory_order_relaxed)) {
+        }
+    }
+
+    ComponentTypeID m_type;
+    ChunkPool& m_pool;
+    size_t m_size = 0;
+    std::vector<uint32_t> m_changeTicks;
+    std::atomic<uint32_t> m_lastChangeTick{0};
+};
+
+template<typename T>
+class TypedColumn : public ComponentColumn {
+public:
+    static_assert(alignof(T) <= ChunkPool::CHUNK_ALIGNMENT, "Component alignment exceeds chunk alignment");
+
+    explicit TypedColumn(ChunkPool& pool) : ComponentColumn(componentTypeID<T>(), pool) {}
+
+    ~TypedColumn() override {
+        releaseChunks();
+    }
+
+    std::unique_ptr<ComponentColumn> createEmpty(ChunkPool& pool) const override {
+        return std::make_unique<TypedColumn<T>>(pool);
+    }
+
+    Component* get(size_t row) override { return at(row); }
+    const Component* get(size_t row) const override { return at(row); }
+
+    const char* typeName() const override { return componentName<T>(); }
+    size_t componentSize() const override { return sizeof(T); }
+    size_t reservedBytes() const override { return m_chunks.size() * CHUNK_BYTES; }
+
+    void reportBuffers(MemoryReport& report) const override {
+        for (size_t row = 0; row < m_size; ++row) {
+            reportMemory(*at(row), report);
+        }
+    }
+
+    T* at(size_t row) {
+        return chunkData(row / ARCHETYPE_CHUNK_SIZE) + (row % ARCHETYPE_CHUNK_SIZE);
+    }
+
+    const T* at(size_t row) const {
+        return chunkData(row / ARCHETYPE_CHUNK_SIZE) + (row % ARCHETYPE_CHUNK_SIZE);
+    }
+
+    // Writable access copies the chunk first if a snapshot shares it.
+    T* chunkData(size_t chunk) {
+        if (m_shared[chunk]) {
+            copyShared(chunk);
+        }
+        return std::launder(static_cast<T*>(m_chunks[chunk]));
+    }
+
+    const T* chunkData(size_t chunk) const {
+        return std::launder(static_cast<const T*>(m_chunks[chunk]));
+    }
+
+    size_t chunkCount() const { return m_chunks.size(); }
+
+    // Number of live rows in the given chunk.
+    size_t chunkSize(size_t chunk) const {
+        size_t begin = chunk * ARCHETYPE_CHUNK_SIZE;
+        return std::min(ARCHETYPE_CHUNK_SIZE, m_size - begin);
+    }
+
+    template<typename... Args>
+    T* emplace(uint32_t changeTick, Args&&... args) {
+        T* slot = allocateSlot();
+        new (slot) T(std::forward<Args>(args)...);
+        m_changeTicks.push_back(changeTick);
+        noteChangeTick(changeTick);
+        ++m_size;
+        return slot;
+    }
+
+    void moveAppend(ComponentColumn& src, size_t srcRow) override {
+        T* from = static_cast<TypedColumn<T>&>(src).at(srcRow);
+        emplace(src.changeTicks()[srcRow], std::move(*from));
+    }
+
+    void copyAppend(const ComponentColumn& src, size_t srcRow, uint32_t changeTick) override {
+        const T* from = static_cast<const TypedColumn<T>&>(src).at(srcRow);
+        emplace(changeTick, *from);
+    }
+
+    void swapRemove(size_t row) override {
+        size_t last = m_size - 1;
+        at(row)->~T();
+        if (row != last) {
+            new (at(row)) T(std::move(*at(last)));
+            at(last)->~T();
+            m_changeTicks[row] = m_changeTicks[last];
+        }
+        m_changeTicks.pop_back();
+        --m_size;
+
+        // Release the tail chunk once it is completely empty
+        if (m_size + ARCHETYPE_CHUNK_SIZE <= m_chunks.size() * ARCHETYPE_CHUNK_SIZE) {
+            m_pool.release(m_chunks.back(), CHUNK_BYTES);
+            m_chunks.pop_back();
+            m_shared.pop_back();
+        }
+    }
+
+    void clear() override {
+        releaseChunks();
+        m_chunks.clear();
+        m_shared.clear();
+        m_changeTicks.clear();
+        m_size = 0;
+    }
+
+    void share(std::vector<std::shared_ptr<void>>& chunks) override {
+        for (size_t chunk = 0; chunk < m_chunks.size(); ++chunk) {
+            if (!m_shared[chunk]) {
+                m_shared[chunk] = std::make_shared<SharedChunk>(m_chunks[chunk], chunkSize(chunk), m_pool);
+            }
+            chunks.push_back(m_shared[chunk]);
+        }
+    }
+
+    void adopt(const std::vector<std::shared_ptr<void>>& chunks, size_t size, uint32_t tick) override {
+        clear();
+        for (const std::shared_ptr<void>& chunk : chunks) {
+            m_shared.push_back(std::static_pointer_cast<SharedChunk>(chunk));
+            m_chunks.push_back(m_shared.back()->data);
+        }
+        m_size = size;
+        m_changeTicks.assign(size, tick);
+        noteChangeTick(tick);
+    }
+
+private:
+    static constexpr size_t CHUNK_BYTES = sizeof(T) * ARCHETYPE_CHUNK_SIZE;
+
+    // A chunk frozen by a snapshot. The last owner destroys its rows.
+    struct SharedChunk {
+        SharedChunk(void* chunk, size_t count, ChunkPool& chunkPool)
+            : data(chunk), rows(count), pool(chunkPool) {}
+
+        ~SharedChunk() {
+            if (!data) return;
+            T* items = std::launder(static_cast<T*>(data));
+            for (size_t row = 0; row < rows; ++row) {
+                items[row].~T();
+            }
+            pool.release(data, CHUNK_BYTES);
+        }
+
+        void* data;
+        size_t rows;
+        ChunkPool& pool;
+    };
+
+    void copyShared(size_t chunk) {
+        std::shared_ptr<SharedChunk>& shared = m_shared[chunk];
+        if (shared.use_count() == 1) {
+            // Every snapshot that held it is gone; take the chunk back
+            shared->data = nullptr;
+        } else {
+            T* copy = static_cast<T*>(m_pool.allocate(CHUNK_BYTES));
+            const T* items = std::launder(static_cast<const T*>(shared->data));
+            for (size_t row = 0; row < shared->rows; ++row) {
+                new (copy + row) T(items[row]);
+            }
+            m_chunks[chunk] = copy;
+        }
+        shared.reset();
+    }
+
+    void releaseChunks() {
+        for (size_t chunk = 0; chunk < m_chunks.size(); ++chunk) {
+            if (m_shared[chunk]) continue;
+
+            T* items = std::launder(static_cast<T*>(m_chunks[chunk]));
+            for (size_t row = 0, rows = chunkSize(chunk); row < rows; ++row) {
+                items[row].~T();
+            }
+            m_pool.release(m_chunks[chunk], CHUNK_BYTES);
+        }
+    }
+
+    T* allocateSlot() {
+        if (m_size == m_chunks.size() * ARCHETYPE_CHUNK_SIZE) {
+            m_chunks.push_back(m_pool.allocate(CHUNK_BYTES));
+            m_shared.emplace_back();
+        }
+        return chunkData(m_size / ARCHETYPE_CHUNK_SIZE) + (m_size % ARCHETYPE_CHUNK_SIZE);
+    }
+
+    // Raw storage from the pool; rows [0, m_size) hold live objects
+    std::vector<void*> m_chunks;
+
+    // Set for chunks a snapshot also references; those are read-only here
+    std::vector<std::shared_ptr<SharedChunk>> m_shared;
+};
+
+// All entities sharing exactly the same set of component types. Each type is
+// stored in its own chunked column, so walking an archetype is a linear scan.
+class Archetype {
+public:
+    // Columns are ordered by ascending component type ID.
+    explicit Archetype(ComponentMask mask, std::vector<std::unique_ptr<ComponentColumn>> columns);
+
+    const ComponentMask& mask() const { return m_mask; }
+    const std::vector<EntityID>& entities() const { return m_entities; }
+    size_t size() const { return m_entities.size(); }
+
+    bool has(ComponentTypeID type) const { return m_mask[type]; }
+
+    ComponentColumn* column(ComponentTypeID type) {
+        uint8_t index = m_columnIndex[type];
+        return index == NO_COLUMN ? nullptr : m_columns[index].get();
+    }
+
+    const ComponentColumn* column(ComponentTypeID type) const {
+        uint8_t index = m_columnIndex[type];
+        return index == NO_COLUMN ? nullptr : m_columns[index].get();
+    }
+
+    template<typename T>
+    TypedColumn<T>* column() {
+        return static_cast<TypedColumn<T>*>(column(componentTypeID<T>()));
+    }
+
+    const std::vector<std::unique_ptr<ComponentColumn>>& columns() const { return m_columns; }
+
+private:
+    friend class World;
+
+    // Removes a row from every column. Returns the entity that was moved into
+    // the freed row, or INVALID_ENTITY if the row was the last one.
+    EntityID removeRow(size_t row);
+
+    static constexpr uint8_t NO_COLUMN = 0xFF;
+
+    ComponentMask m_mask;
+    std::vector<std::unique_ptr<ComponentColumn>> m_columns;
+    std::array<uint8_t, MAX_COMPONENT_TYPES> m_columnIndex;
+    std::vector<EntityID> m_entities;
+
+    // Cached archetype graph edges for add/remove of a single component type
+    std::array<Archetype*, MAX_COMPONENT_TYPES> m_addEdges{};
+    std::array<Archetype*, MAX_COMPONENT_TYPES> m_removeEdges{};
+};
+
+}
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace DabozzEngine {
+namespace ECS {
+
+// Recycles archetype column chunks. Every column of a World allocates through
+// the World's pool, so chunks freed by destroyed entities or emptied
+// archetypes are reused instead of going back to the heap. Blocks are cache
+// line aligned and bucketed by size, so component types of equal size share
+// a bucket.
+//
+// Safe to use from several threads: systems running in parallel may copy
+// chunks shared with a World snapshot.
+class ChunkPool {
+public:
+    static constexpr size_t CHUNK_ALIGNMENT = 64;
+
+    struct Stats {
+        size_t heapAllocations = 0;  // blocks requested from the heap
+        size_t heapFrees = 0;        // blocks handed back to the heap
+        size_t reuses = 0;           // allocations served from a free list
+        size_t liveBytes = 0;        // bytes in chunks currently in use
+        size_t cachedBytes = 0;      // bytes sitting in free lists
+    };
+
+    ChunkPool() = default;
+    ChunkPool(const ChunkPool&) = delete;
+    ChunkPool& operator=(const ChunkPool&) = delete;
+    ~ChunkPool();
+
+    void* allocate(size_t bytes);
+    void release(void* block, size_t bytes);
+
+    // Frees every cached block, e.g. after unloading a scene.
+    void trim();
+
+    const Stats& stats() const { return m_stats; }
+
+private:
+    std::mutex m_mutex;
+    std::unordered_map<size_t, std::vector<void*>> m_freeBlocks;
+    Stats m_stats;
+};
+
+}
+}
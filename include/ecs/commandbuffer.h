@@ -0,0 +1,158 @@
+#pragma once
+
+#include "ecs/world.h"
+#include "ecs/prefab.h"
+#include <array>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace DabozzEngine {
+namespace ECS {
+
+/**
+ * Records structural changes (create/destroy entities, add/remove
+ * components) so they can be applied in one batch at a sync point, instead
+ * of moving archetype rows while something is iterating them.
+ *
+ *   ECS::EntityID bullet = commands.createEntity();
+ *   commands.addComponent<Transform>(bullet)->position = muzzle;
+ *   ...
+ *   commands.playback();   // main thread, nothing else touching the World
+ *
+ * Each recording thread gets its own command stream, claimed lock-free the
+ * first time it records, so worker threads can record concurrently. The
+ * World must not change structurally while recording is in progress.
+ * Playback runs streams in the order threads first recorded into them, and
+ * each stream in recording order. Playback and clear() hand every stream
+ * back, so any number of threads can record over the buffer's lifetime, up
+ * to MAX_RECORDING_THREADS between two playbacks.
+ */
+class CommandBuffer {
+public:
+    static constexpr size_t MAX_RECORDING_THREADS = 64;
+
+    explicit CommandBuffer(World* world);
+    CommandBuffer(const CommandBuffer&) = delete;
+    CommandBuffer& operator=(const CommandBuffer&) = delete;
+
+    // The handle is valid right away; the entity exists after playback.
+    EntityID createEntity();
+    void destroyEntity(EntityID entity);
+
+    // Reserves one entity per template entity; the instance is filled in at
+    // playback. Returns the first root's handle (INVALID_ENTITY for an empty
+    // prefab). The buffer keeps the prefab alive until then.
+    EntityID instantiate(std::shared_ptr<const Prefab> prefab);
+
+    // Returns the pending component. It belongs to the buffer until playback
+    // moves it into the World, so it may be filled in after the call.
+    template<typename T, typename... Args>
+    T* addComponent(EntityID entity, Args&&... args) {
+        auto pending = std::make_unique<PendingComponent<T>>(std::forward<Args>(args)...);
+        T* component = &pending->value;
+
+        Command command;
+        command.type = CommandType::Add;
+        command.entity = entity;
+        command.componentType = componentTypeID<T>();
+        command.component = std::move(pending);
+        localStream().commands.push_back(std::move(command));
+        return component;
+    }
+
+    template<typename T>
+    void removeComponent(EntityID entity) {
+        Command command;
+        command.type = CommandType::Remove;
+        command.entity = entity;
+        command.componentType = componentTypeID<T>();
+        command.remove = [](World& world, EntityID target) { world.removeComponent<T>(target); };
+        localStream().commands.push_back(std::move(command));
+    }
+
+    // Component this thread has queued for the entity and not removed again,
+    // so callers can see their own pending additions before playback.
+    template<typename T>
+    T* getPending(EntityID entity) {
+        const ComponentTypeID type = componentTypeID<T>();
+        std::vector<Command>& commands = localStream().commands;
+        for (auto it = commands.rbegin(); it != commands.rend(); ++it) {
+            if (it->entity != entity) continue;
+            if (it->type == CommandType::Destroy || it->type == CommandType::Instantiate) return nullptr;
+            if (it->componentType != type) continue;
+            if (it->type == CommandType::Remove) return nullptr;
+            return &static_cast<PendingComponent<T>*>(it->component.get())->value;
+        }
+        return nullptr;
+    }
+
+    // Applies and clears every recorded command. Main thread only, with no
+    // thread still recording.
+    void playback();
+
+    // Drops every recorded command. Reserved entities are still created.
+    // Like playback, only with no thread still recording.
+    void clear();
+
+    bool empty() const;
+
+private:
+    enum class CommandType : uint8_t {
+        Destroy,
+        Add,
+        Remove,
+        Instantiate
+    };
+
+    struct PendingComponentBase {
+        virtual ~PendingComponentBase() = default;
+        virtual void apply(World& world, EntityID entity) = 0;
+    };
+
+    template<typename T>
+    struct PendingComponent : PendingComponentBase {
+        template<typename... Args>
+        explicit PendingComponent(Args&&... args) : value(std::forward<Args>(args)...) {}
+
+        void apply(World& world, EntityID entity) override {
+            world.addComponent<T>(entity, std::move(value));
+        }
+
+        T value;
+    };
+
+    struct PendingInstance : PendingComponentBase {
+        void apply(World& world, EntityID) override {
+            prefab->instantiateInto(world, entities.data());
+        }
+
+        std::shared_ptr<const Prefab> prefab;
+        std::vector<EntityID> entities;
+    };
+
+    struct Command {
+        CommandType type = CommandType::Destroy;
+        EntityID entity = INVALID_ENTITY;
+        ComponentTypeID componentType = 0;
+        std::unique_ptr<PendingComponentBase> component;
+        void (*remove)(World&, EntityID) = nullptr;
+    };
+
+    struct Stream {
+        std::atomic<std::thread::id> owner{};
+        std::vector<Command> commands;
+    };
+
+    Stream& localStream();
+    // Lets the first streamCount streams be claimed again
+    void releaseStreams(size_t streamCount);
+
+    World* m_world;
+    std::array<Stream, MAX_RECORDING_THREADS> m_streams;
+    std::atomic<size_t> m_streamCount{0};
+};
+
+}
+}
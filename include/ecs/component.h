@@ -1,12 +1,51 @@
 #pragma once
 
+#include <atomic>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <type_traits>
+
 namespace DabozzEngine {
 namespace ECS {
 
-class Component {
-public:
-    virtual ~Component() = default;
+// Tag base for component types. Deliberately has no virtual destructor:
+// archetype columns destroy components through their concrete type, so
+// components carry no vtable pointer.
+struct Component {
 };
 
+// Dense per-type component IDs, handed out the first time a type is used.
+// They index archetype columns and component masks, so there is no RTTI or
+// hashing on the hot path. IDs are not stable between runs; don't save them.
+using ComponentTypeID = uint32_t;
+
+constexpr size_t MAX_COMPONENT_TYPES = 64;
+
+using ComponentMask = std::bitset<MAX_COMPONENT_TYPES>;
+
+inline ComponentTypeID nextComponentTypeID() {
+    static std::atomic<ComponentTypeID> next{0};
+    ComponentTypeID id = next++;
+    if (id >= MAX_COMPONENT_TYPES) {
+        // Masks and column tables are fixed-size; carrying on would corrupt them
+        std::cerr << "ECS: more than " << MAX_COMPONENT_TYPES << " component types, raise MAX_COMPONENT_TYPES" << std::endl;
+        std::abort();
+    }
+    return id;
+}
+
+template<typename T>
+ComponentTypeID componentTypeID() {
+    if constexpr (std::is_const_v<T> || std::is_volatile_v<T>) {
+        return componentTypeID<std::remove_cv_t<T>>();
+    } else {
+        static const ComponentTypeID id = nextComponentTypeID();
+        return id;
+    }
+}
+
 }
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "ecs/component.h"
+#include "ecs/memoryreport.h"
 #include "renderer/animation.h"
 #include "renderer/skeleton.h"
 #include "ecs/components/animatorgraph.h"
@@ -103,5 +104,9 @@ struct Animator : public Component {
     }
 };
 
+inline void reportMemory(const Animator& animator, MemoryReport& report) {
+    report.owned("Animator::boneMatrices", animator.boneMatrices);
+}
+
 }
 }
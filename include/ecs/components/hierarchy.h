@@ -1,6 +1,7 @@
 #pragma once
 
 #include "ecs/component.h"
+#include "ecs/memoryreport.h"
 #include <vector>
 
 namespace DabozzEngine {
@@ -13,5 +14,9 @@ struct Hierarchy : public Component {
     Hierarchy() : parent(0) {}
 };
 
+inline void reportMemory(const Hierarchy& hierarchy, MemoryReport& report) {
+    report.owned("Hierarchy::children", hierarchy.children);
+}
+
 }
 }
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "ecs/component.h"
+#include "ecs/memoryreport.h"
+#include <memory>
 #include <vector>
 #include <string>
 
@@ -17,40 +19,50 @@ struct Vertex {
     float weights[MAX_BONE_INFLUENCE];
 };
 
-struct Mesh : public Component {
+// Geometry and embedded texture pixels, which can run to megabytes. Meshes
+// only hold it through a shared_ptr, so copies of an entity (duplicates,
+// prefab instances, snapshots) share one MeshData. It's immutable once
+// shared: to change the geometry of one mesh, give it a new MeshData.
+struct MeshData {
     std::vector<float> vertices;
     std::vector<float> normals;
     std::vector<float> texCoords;
     std::vector<unsigned int> indices;
-    
+
     // Bone data for skeletal animation
     std::vector<int> boneIds;
     std::vector<float> boneWeights;
-    bool hasAnimation = false;
-    
-    unsigned int vao = 0;
-    unsigned int vbo = 0;
-    unsigned int ebo = 0;
-    unsigned int boneVBO = 0;
-    unsigned int weightVBO = 0;
-    unsigned int textureID = 0;
-    bool isUploaded = false;
-    bool hasTexture = false;
-    
-    std::string modelPath;
-    std::string texturePath;
+
     std::vector<unsigned char> embeddedTextureData;
     int embeddedTextureWidth = 0;
     int embeddedTextureHeight = 0;
 
-    Mesh() {
+    MeshData() {
         // Initialize bone data with -1 (no bone)
-        for (int i = 0; i < MAX_BONE_INFLUENCE; i++) {
-            boneIds.push_back(-1);
-            boneWeights.push_back(0.0f);
-        }
+        boneIds.assign(MAX_BONE_INFLUENCE, -1);
+        boneWeights.assign(MAX_BONE_INFLUENCE, 0.0f);
     }
 };
 
+struct Mesh : public Component {
+    std::shared_ptr<const MeshData> data;
+    bool hasAnimation = false;
+    bool hasTexture = false;
+    
+    std::string modelPath;
+    std::string texturePath;
+};
+
+inline void reportMemory(const Mesh& mesh, MemoryReport& report) {
+    if (!mesh.data) return;
+    report.shared("Mesh::vertices", mesh.data->vertices);
+    report.shared("Mesh::normals", mesh.data->normals);
+    report.shared("Mesh::texCoords", mesh.data->texCoords);
+    report.shared("Mesh::indices", mesh.data->indices);
+    report.shared("Mesh::boneIds", mesh.data->boneIds);
+    report.shared("Mesh::boneWeights", mesh.data->boneWeights);
+    report.shared("Mesh::embeddedTextureData", mesh.data->embeddedTextureData);
+}
+
 }
 }
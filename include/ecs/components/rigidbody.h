@@ -12,7 +12,7 @@ struct RigidBody : public Component {
     QVector3D angularVelocity;
     float drag;
     float angularDrag;
-    int bodyId; // Butsuri body ID
+    int bodyId; // Butsuri body handle, -1 without a body
     
     RigidBody(float m = 1.0f, bool stat = false, bool grav = true)
         : mass(m), isStatic(stat), useGravity(grav), velocity(0, 0, 0), angularVelocity(0, 0, 0), drag(0.0f), angularDrag(0.05f), bodyId(-1) {}
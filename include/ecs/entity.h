@@ -5,9 +5,28 @@
 namespace DabozzEngine {
 namespace ECS {
 
+// Handle layout: low 20 bits are the slot index, high 12 bits the slot's
+// generation. Destroying an entity bumps its slot generation, so stale
+// handles are rejected by World::hasEntity instead of aliasing a new entity.
 using EntityID = uint32_t;
 
 constexpr EntityID INVALID_ENTITY = 0;
 
+constexpr uint32_t ENTITY_INDEX_BITS = 20;
+constexpr uint32_t ENTITY_INDEX_MASK = (1u << ENTITY_INDEX_BITS) - 1;
+constexpr uint32_t ENTITY_GENERATION_MASK = (1u << (32 - ENTITY_INDEX_BITS)) - 1;
+
+constexpr uint32_t entityIndex(EntityID entity) {
+    return entity & ENTITY_INDEX_MASK;
+}
+
+constexpr uint32_t entityGeneration(EntityID entity) {
+    return entity >> ENTITY_INDEX_BITS;
+}
+
+constexpr EntityID makeEntityID(uint32_t index, uint32_t generation) {
+    return ((generation & ENTITY_GENERATION_MASK) << ENTITY_INDEX_BITS) | (index & ENTITY_INDEX_MASK);
+}
+
 }
 }
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace DabozzEngine {
+namespace ECS {
+
+/**
+ * Advances the simulation in fixed steps on a thread of its own, paced by
+ * the clock rather than by GUI timers.
+ *
+ *   GameLoop loop([&](float dt) { scheduler.run(dt); });
+ *   loop.start();
+ *   ...
+ *   transforms.setInterpolation(true, loop.interpolationAlpha());
+ *
+ * Elapsed time goes into an accumulator that is spent one step at a time.
+ * If steps take longer than the time they simulate, at most
+ * maxStepsPerFrame run before the loop drops the rest of the backlog, so a
+ * slow machine runs the game slower instead of falling ever further behind.
+ *
+ * Steps run with mutex() held; anything else touching the World while the
+ * loop runs must hold it too. The loop thread takes over MainThread jobs
+ * (see JobSystem::setMainThread) until stop(), so Scheduler systems marked
+ * mainThread() run on it.
+ */
+class GameLoop {
+public:
+    using StepFunction = std::function<void(float deltaTime)>;
+
+    explicit GameLoop(StepFunction step, float stepSeconds = 1.0f / 60.0f, int maxStepsPerFrame = 5);
+    ~GameLoop();
+
+    GameLoop(const GameLoop&) = delete;
+    GameLoop& operator=(const GameLoop&) = delete;
+
+    // Time starts counting at start(); stop() lets the current step finish.
+    void start();
+    void stop();
+    bool isRunning() const { return m_thread.joinable(); }
+
+    std::mutex& mutex() { return m_mutex; }
+
+    // How far the clock has moved past the latest step, as a fraction of a
+    // step. Rendering blends the last two steps by this much.
+    float interpolationAlpha() const;
+
+    float stepSeconds() const { return m_stepSeconds; }
+    uint64_t stepCount() const { return m_stepCount.load(std::memory_order_relaxed); }
+    uint64_t droppedSteps() const { return m_droppedSteps.load(std::memory_order_relaxed); }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void run();
+
+    StepFunction m_step;
+    float m_stepSeconds;
+    Clock::duration m_stepDuration;
+    int m_maxStepsPerFrame;
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+
+    // Lets stop() cut the wait for the next step short
+    std::mutex m_stopMutex;
+    std::condition_variable m_stopSignal;
+    bool m_stopping = false;
+
+    // Clock time the latest step's state corresponds to
+    std::atomic<Clock::rep> m_simulatedUntil{0};
+    std::atomic<uint64_t> m_stepCount{0};
+    std::atomic<uint64_t> m_droppedSteps{0};
+};
+
+}
+}
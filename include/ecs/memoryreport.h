@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace DabozzEngine {
+namespace ECS {
+
+/**
+ * Collects the heap buffers components own beyond their own bytes, for
+ * World::stats(). A component type with large buffers overloads
+ *
+ *   void reportMemory(const Mesh& mesh, MemoryReport& report);
+ *
+ * in namespace ECS next to its definition; other types report nothing.
+ */
+class MemoryReport {
+public:
+    struct Buffer {
+        std::string name;       // e.g. "Mesh::vertices"
+        size_t references = 0;  // components pointing at one
+        size_t instances = 0;   // distinct buffers
+        size_t bytes = 0;       // bytes of the distinct buffers
+    };
+
+    // A buffer only this component owns.
+    void owned(const char* name, size_t bytes) {
+        add(name, bytes, true);
+    }
+
+    // A buffer components may share, e.g. through a shared_ptr. Each
+    // address is only counted once.
+    void shared(const char* name, const void* address, size_t bytes) {
+        add(name, bytes, m_seen.insert(address).second);
+    }
+
+    template<typename T>
+    void owned(const char* name, const std::vector<T>& buffer) {
+        owned(name, buffer.capacity() * sizeof(T));
+    }
+
+    template<typename T>
+    void shared(const char* name, const std::vector<T>& buffer) {
+        shared(name, &buffer, buffer.capacity() * sizeof(T));
+    }
+
+    const std::vector<Buffer>& buffers() const { return m_buffers; }
+
+    // Bytes counted so far, so callers can attribute them per component type
+    size_t totalBytes() const { return m_totalBytes; }
+
+private:
+    void add(const char* name, size_t bytes, bool distinct) {
+        auto buffer = m_buffers.begin();
+        while (buffer != m_buffers.end() && buffer->name != name) ++buffer;
+        if (buffer == m_buffers.end()) {
+            buffer = m_buffers.insert(m_buffers.end(), Buffer{ name });
+        }
+
+        ++buffer->references;
+        if (distinct) {
+            ++buffer->instances;
+            buffer->bytes += bytes;
+            m_totalBytes += bytes;
+        }
+    }
+
+    std::vector<Buffer> m_buffers;
+    std::unordered_set<const void*> m_seen;
+    size_t m_totalBytes = 0;
+};
+
+// Components without buffers of their own
+template<typename T>
+void reportMemory(const T&, MemoryReport&) {}
+
+}
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "ecs/world.h"
+#include <QString>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace DabozzEngine {
+namespace ECS {
+
+/**
+ * Looks entities up by their Name component without scanning the World.
+ *
+ *   EntityID camera = names.find("Camera");
+ *   std::vector<EntityID> matches = names.findByPrefix(searchText);
+ *
+ * Every query first catches up with the World: Names added or marked
+ * changed (markChanged<Name>) since the last query are re-indexed. So call
+ * markChanged<Name>() after renaming in place. Entities that are destroyed
+ * or lose their Name drop out right away, through an onRemove<Name>
+ * observer, so the index must not outlive its World.
+ *
+ * Queries update the index, so don't query from two threads at once.
+ */
+class NameIndex {
+public:
+    explicit NameIndex(World* world);
+    ~NameIndex();
+
+    // The observer points back at this index
+    NameIndex(const NameIndex&) = delete;
+    NameIndex& operator=(const NameIndex&) = delete;
+
+    // Some entity with exactly this name, or INVALID_ENTITY. O(1).
+    EntityID find(const QString& name);
+
+    // Every entity with exactly this name.
+    std::vector<EntityID> findAll(const QString& name);
+
+    // Entities whose name starts with prefix, ignoring case, in name order.
+    std::vector<EntityID> findByPrefix(const QString& prefix);
+
+private:
+    struct QStringHash {
+        size_t operator()(const QString& key) const { return qHash(key); }
+    };
+
+    void refresh();
+    void insert(EntityID entity, const QString& name);
+    void erase(EntityID entity);
+
+    World* m_world;
+    View<const Name> m_changedNames;
+    World::ObserverID m_nameRemoved = 0;
+
+    std::unordered_multimap<QString, EntityID, QStringHash> m_entities;
+    std::unordered_map<EntityID, QString> m_names;
+
+    // Case-folded names in order, rebuilt on the first prefix query after
+    // any change
+    std::vector<std::pair<QString, EntityID>> m_sorted;
+    bool m_sortedDirty = true;
+};
+
+}
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "ecs/world.h"
+#include <unordered_map>
+#include <vector>
+
+namespace DabozzEngine {
+namespace ECS {
+
+/**
+ * A reusable entity hierarchy, kept in a World of its own, that can be
+ * stamped into other Worlds:
+ *
+ *   Prefab crate(world, selected);           // selected plus its children
+ *   EntityID copy = crate.instantiate(world);
+ *   std::vector<EntityID> many = crate.instantiate(world, 1000);
+ *
+ * Instances copy-construct every component of the templates, so anything a
+ * component holds through a shared_ptr (Mesh geometry, animation clips,
+ * skeletons) is shared between all instances and the prefab instead of
+ * duplicated. Hierarchy links are remapped to the new entities; links to
+ * entities outside the prefab are dropped.
+ *
+ * Edit templates through world(), e.g. SceneFile::loadScene(&prefab.world(),
+ * path). Entities without a Hierarchy parent in the prefab are its roots.
+ */
+class Prefab {
+public:
+    Prefab() = default;
+    Prefab(const World& source, EntityID root);
+
+    World& world() { return m_world; }
+    const World& world() const { return m_world; }
+
+    size_t entityCount() const { return m_world.getEntities().size(); }
+
+    // Returns the first root's copy, or INVALID_ENTITY for an empty prefab.
+    EntityID instantiate(World& target) const;
+
+    // count instances at once. Returns the first root of each.
+    std::vector<EntityID> instantiate(World& target, size_t count) const;
+
+    // Fills entityCount() existing, component-less entities of target (e.g.
+    // flushed reserveEntity() handles), in template order: roots first,
+    // parents before their children.
+    void instantiateInto(World& target, const EntityID* entities) const;
+
+private:
+    // Template entities in instantiation order, and each one's index in it
+    struct Layout {
+        std::vector<EntityID> order;
+        std::unordered_map<EntityID, size_t> slots;
+    };
+
+    Layout layout() const;
+    void instantiateInto(World& target, const Layout& layout, const EntityID* entities) const;
+
+    World m_world;
+};
+
+}
+}
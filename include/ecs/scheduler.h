@@ -0,0 +1,111 @@
+#pragma once
+
+#include "ecs/component.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace DabozzEngine {
+namespace ECS {
+
+/**
+ * Runs a frame's systems, overlapping the ones whose declared component
+ * access doesn't conflict.
+ *
+ *   scheduler.addSystem("Physics", [&](float dt) { physics.update(dt); })
+ *       .writes<Transform, RigidBody>()
+ *       .reads<BoxCollider>();
+ *
+ * A system depends on every earlier-registered system it conflicts with
+ * (one writes a type the other reads or writes), so conflicting systems
+ * keep their registration order and everything else may run in parallel.
+ * Systems run as jobs on the shared JobSystem. They must not change the
+ * World structurally unless declared exclusive(); use a CommandBuffer
+ * instead.
+ */
+class Scheduler {
+public:
+    using SystemFunction = std::function<void(float deltaTime)>;
+
+    class SystemDesc {
+    public:
+        template<typename... Ts>
+        SystemDesc& reads() {
+            (m_reads.set(componentTypeID<Ts>()), ...);
+            return *this;
+        }
+
+        template<typename... Ts>
+        SystemDesc& writes() {
+            (m_writes.set(componentTypeID<Ts>()), ...);
+            return *this;
+        }
+
+        // Conflicts with every other system, e.g. scripts that can touch
+        // anything or play back structural changes.
+        SystemDesc& exclusive() {
+            m_exclusive = true;
+            return *this;
+        }
+
+        // Orders this system after an earlier-registered one it shares no
+        // components with, e.g. one that reads a cache the other fills.
+        SystemDesc& after(const std::string& name) {
+            m_after.push_back(name);
+            return *this;
+        }
+
+        // Runs on the thread that calls Scheduler::run, for code tied to it
+        // (Qt objects, a script VM).
+        SystemDesc& mainThread() {
+            m_mainThread = true;
+            return *this;
+        }
+
+    private:
+        friend class Scheduler;
+
+        bool conflictsWith(const SystemDesc& other) const;
+        bool runsAfter(const SystemDesc& other) const;
+
+        std::string m_name;
+        SystemFunction m_function;
+        ComponentMask m_reads;
+        ComponentMask m_writes;
+        bool m_exclusive = false;
+        bool m_mainThread = false;
+        std::vector<std::string> m_after;
+
+        std::vector<size_t> m_dependents;
+        size_t m_dependencyCount = 0;
+        double m_lastMs = 0.0;
+        double m_averageMs = 0.0;
+    };
+
+    struct SystemTiming {
+        std::string name;
+        double lastMs;
+        double averageMs;   // exponential moving average
+    };
+
+    // Access must be fully declared before the next run().
+    SystemDesc& addSystem(const std::string& name, SystemFunction function);
+
+    // Runs every system once and returns when all have finished. Call from
+    // the thread MainThread jobs run on (JobSystem::isMainThread()).
+    void run(float deltaTime);
+
+    std::vector<SystemTiming> timings() const;
+    double lastFrameMs() const { return m_lastFrameMs; }
+
+private:
+    void buildGraph();
+
+    std::vector<std::unique_ptr<SystemDesc>> m_systems;
+    bool m_graphDirty = true;
+    double m_lastFrameMs = 0.0;
+};
+
+}
+}
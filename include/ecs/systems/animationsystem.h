@@ -15,21 +15,18 @@ namespace Systems {
 
 class AnimationSystem {
 public:
-    AnimationSystem(ECS::World* world) : m_world(world) {}
+    AnimationSystem(ECS::World* world) : m_world(world), m_animators(world) {}
 
     void update(float deltaTime) {
         if (!m_world) return;
 
-        for (ECS::EntityID entity : m_world->getEntities()) {
-            ECS::Animator* animator = m_world->getComponent<ECS::Animator>(entity);
-            if (!animator) continue;
-
-            if (animator->graph && !animator->graph->states.empty()) {
-                updateGraph(animator, deltaTime);
+        m_animators.each([this, deltaTime](ECS::Animator& animator) {
+            if (animator.graph && !animator.graph->states.empty()) {
+                updateGraph(&animator, deltaTime);
             } else {
-                animator->update(deltaTime);
+                animator.update(deltaTime);
             }
-        }
+        });
     }
 
 private:
@@ -213,6 +210,7 @@ private:
     }
 
     ECS::World* m_world;
+    ECS::View<ECS::Animator> m_animators;
 };
 
 }
@@ -2,6 +2,7 @@
 
 #include "ecs/world.h"
 #include "ecs/components/audiosource.h"
+#include "ecs/systems/transformsystem.h"
 #include <AL/al.h>
 #include <AL/alc.h>
 #include <unordered_map>
@@ -12,9 +13,12 @@ namespace Systems {
 
 class AudioSystem {
 public:
-    AudioSystem(ECS::World* world);
+    // Spatial sources play at their entity's world position from transforms
+    AudioSystem(ECS::World* world, TransformSystem* transforms);
     ~AudioSystem();
 
+    // Loads every AudioSource, and from then on each one as it is added;
+    // removed ones release their OpenAL buffer and source.
     void initialize();
     void shutdown();
     void update(float deltaTime);
@@ -36,10 +40,18 @@ private:
         int bitsPerSample;
     };
 
+    void acquireSource(ECS::AudioSource& audio);
+    void releaseSource(const ECS::AudioSource& audio);
+
     bool loadWav(const QString& path, WavData& wav);
     ALenum getALFormat(int channels, int bitsPerSample);
 
     ECS::World* m_world;
+    TransformSystem* m_transforms;
+    ECS::View<ECS::AudioSource> m_sources;
+    ECS::View<ECS::AudioSource> m_changedSources;
+    std::vector<ECS::World::ObserverID> m_observers;
+    uint32_t m_lastMoveTick;
     ALCdevice* m_device;
     ALCcontext* m_context;
     bool m_initialized;
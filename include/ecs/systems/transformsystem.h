@@ -0,0 +1,106 @@
+#pragma once
+
+#include "ecs/world.h"
+#include <QMatrix4x4>
+#include <QVector3D>
+#include <vector>
+
+namespace DabozzEngine {
+namespace Systems {
+
+/**
+ * Caches every entity's world matrix (parent world matrix * local Transform).
+ *
+ * Entities are kept in flat arrays sorted parents before children, so
+ * update() is a single forward pass that only recomputes entities whose
+ * Transform changed (World::markChanged) and their descendants.
+ *
+ * The order follows Transforms and Hierarchies through World observers:
+ * new entities are appended, removed ones leave a hole until enough pile up
+ * to compact, and a reparented entity moves behind its new parent with its
+ * subtree. Only the slots involved are recomputed. Call
+ * markChanged<Hierarchy>() after reparenting an entity in place.
+ */
+class TransformSystem {
+public:
+    explicit TransformSystem(ECS::World* world);
+    ~TransformSystem();
+
+    // The observers point back at this system
+    TransformSystem(const TransformSystem&) = delete;
+    TransformSystem& operator=(const TransformSystem&) = delete;
+
+    void update();
+
+    // As of the last update(). Identity for entities without a Transform.
+    const QMatrix4x4& worldMatrix(ECS::EntityID entity) const;
+
+    QVector3D worldPosition(ECS::EntityID entity) const {
+        return worldMatrix(entity).column(3).toVector3D();
+    }
+
+    // World change tick the entity's world matrix was last recomputed at;
+    // compare against a tick from World::advanceChangeTick(). 0 if unknown.
+    uint32_t changeTick(ECS::EntityID entity) const;
+
+    // Fixed-step interpolation (see ECS::GameLoop). Call saveStep() at the
+    // end of every simulation step. While enabled, renderMatrix() blends the
+    // last two saved steps by alpha; otherwise it is worldMatrix().
+    void saveStep();
+    void setInterpolation(bool enabled, float alpha = 0.0f);
+    QMatrix4x4 renderMatrix(ECS::EntityID entity) const;
+
+private:
+    static constexpr uint32_t NO_SLOT = UINT32_MAX;
+
+    void rebuild();
+    void applyChanges();
+    void adoptOrphans();
+    void compact();
+    uint32_t append(ECS::EntityID entity, uint32_t parent);
+    void release(uint32_t slot);
+    void setParent(uint32_t slot, uint32_t parent);
+    uint32_t parentSlotOf(ECS::EntityID entity);
+    void addOrphan(ECS::EntityID entity);
+    uint32_t slotOf(ECS::EntityID entity) const;
+
+    ECS::World* m_world;
+    ECS::View<const ECS::Transform> m_transforms;
+    ECS::View<const ECS::Transform> m_changedTransforms;
+    ECS::View<const ECS::Hierarchy> m_changedHierarchies;
+    std::vector<ECS::World::ObserverID> m_observers;
+    bool m_built = false;
+
+    // Since the last update(): entities that gained or lost a Transform, and
+    // ones whose parent may have changed
+    std::vector<ECS::EntityID> m_added;
+    std::vector<ECS::EntityID> m_removed;
+    std::vector<ECS::EntityID> m_reparented;
+    // Entities treated as roots for now: their parent has no Transform, or
+    // they were cut out of a parent cycle
+    std::vector<ECS::EntityID> m_orphans;
+
+    // Indexed by slot; a parent's slot is always lower than its children's.
+    // Released slots hold INVALID_ENTITY until compact().
+    std::vector<ECS::EntityID> m_entities;
+    std::vector<uint32_t> m_parents;
+    std::vector<QMatrix4x4> m_worldMatrices;
+    std::vector<uint32_t> m_changeTicks;
+    std::vector<uint8_t> m_dirty;
+    bool m_anyDirty = false;
+    size_t m_releasedSlots = 0;
+
+    // World matrices as of the last two saveStep() calls, by slot. Slots
+    // added since the last saveStep() have none yet.
+    std::vector<QMatrix4x4> m_previousStep;
+    std::vector<QMatrix4x4> m_lastStep;
+    std::vector<uint8_t> m_stepSaved;
+    bool m_interpolating = false;
+    float m_alpha = 0.0f;
+
+    // Slot of each entity, indexed by entity index
+    std::vector<uint32_t> m_slots;
+};
+
+} // namespace Systems
+} // namespace DabozzEngine
@@ -0,0 +1,218 @@
+#pragma once
+
+#include "ecs/archetype.h"
+#include <algorithm>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace DabozzEngine {
+namespace ECS {
+
+class World;
+
+/**
+ * Iterates every entity that has all of Ts (and none of the excluded types),
+ * walking matching archetypes column by column.
+ *
+ *   auto bodies = world->view<Transform, RigidBody>().exclude<FloorCollider>();
+ *   bodies.each([](EntityID entity, Transform& t, RigidBody& rb) { ... });
+ *
+ * A view remembers which archetypes matched, so keeping one as a member and
+ * reusing it every frame only checks archetypes created since the last call.
+ * Declaring a type const (View<const Transform>) hands out const references.
+ *
+ * changed<T>() restricts each() to entities whose T was added or marked
+ * changed (World::markChanged) since this view's previous each() call:
+ *
+ *   auto moved = world->view<const Transform, AudioSource>().changed<Transform>();
+ *
+ * Don't add/remove components or destroy entities from inside each(); rows
+ * move when the archetype changes.
+ */
+template<typename... Ts>
+class View {
+    static_assert(sizeof...(Ts) > 0, "View needs at least one component type");
+
+public:
+    View() {
+        (m_required.set(componentTypeID<Ts>()), ...);
+    }
+
+    // Templated so world.h can include this header before World is complete
+    template<typename WorldT>
+    explicit View(WorldT* world)
+        : View()
+    {
+        m_world = world;
+        m_archetypes = world ? &world->getArchetypes() : nullptr;
+    }
+
+    template<typename... Excluded>
+    View& exclude() {
+        (m_excluded.set(componentTypeID<Excluded>()), ...);
+        m_matches.clear();
+        m_scanned = 0;
+        return *this;
+    }
+
+    // Changed types must also be present, but needn't be among Ts.
+    template<typename... Changed>
+    View& changed() {
+        (m_changed.set(componentTypeID<Changed>()), ...);
+        m_required |= m_changed;
+        m_matches.clear();
+        m_scanned = 0;
+        return *this;
+    }
+
+    // func(EntityID, Ts&...) or func(Ts&...)
+    template<typename Func>
+    void each(Func&& func) {
+        refresh();
+
+        if (m_changed.none()) {
+            for (Archetype* archetype : m_matches) {
+                if (archetype->size() == 0) continue;
+                eachInArchetype(archetype, func, std::index_sequence_for<Ts...>());
+            }
+            return;
+        }
+        if (!m_world) return;
+
+        // Everything stamped after our previous run, up to and including now
+        const uint32_t since = m_lastRunTick;
+        m_lastRunTick = advanceChangeTick(m_world);
+
+        for (Archetype* archetype : m_matches) {
+            if (archetype->size() == 0) continue;
+            eachChangedInArchetype(archetype, func, since, std::index_sequence_for<Ts...>());
+        }
+    }
+
+    // Ignores the changed<>() filter.
+    size_t count() {
+        refresh();
+        size_t total = 0;
+        for (Archetype* archetype : m_matches) {
+            total += archetype->size();
+        }
+        return total;
+    }
+
+    const std::vector<Archetype*>& archetypes() {
+        refresh();
+        return m_matches;
+    }
+
+private:
+    void refresh() {
+        if (!m_archetypes) return;
+
+        // Archetypes are append-only, so only new ones need checking
+        for (; m_scanned < m_archetypes->size(); ++m_scanned) {
+            Archetype* archetype = (*m_archetypes)[m_scanned].get();
+            if (matches(archetype)) {
+                m_matches.push_back(archetype);
+            }
+        }
+    }
+
+    // Deferred through a template so World may be incomplete here
+    template<typename WorldT>
+    static uint32_t advanceChangeTick(WorldT* world) {
+        return world->advanceChangeTick();
+    }
+
+    bool matches(const Archetype* archetype) const {
+        const ComponentMask& mask = archetype->mask();
+        return (mask & m_required) == m_required && (mask & m_excluded).none();
+    }
+
+    // Only non-const access copies chunks shared with a World snapshot
+    template<typename T>
+    static T* chunkOf(TypedColumn<std::remove_const_t<T>>* column, size_t chunk) {
+        if constexpr (std::is_const_v<T>) {
+            return std::as_const(*column).chunkData(chunk);
+        } else {
+            return column->chunkData(chunk);
+        }
+    }
+
+    template<typename T>
+    static T* rowOf(TypedColumn<std::remove_const_t<T>>* column, size_t row) {
+        if constexpr (std::is_const_v<T>) {
+            return std::as_const(*column).at(row);
+        } else {
+            return column->at(row);
+        }
+    }
+
+    template<typename Func, size_t... I>
+    void eachInArchetype(Archetype* archetype, Func& func, std::index_sequence<I...>) {
+        const size_t count = archetype->size();
+        const EntityID* entities = archetype->entities().data();
+        std::tuple<TypedColumn<std::remove_const_t<Ts>>*...> columns(
+            archetype->template column<std::remove_const_t<Ts>>()...);
+
+        for (size_t begin = 0; begin < count; begin += ARCHETYPE_CHUNK_SIZE) {
+            const size_t chunk = begin / ARCHETYPE_CHUNK_SIZE;
+            const size_t rows = std::min(ARCHETYPE_CHUNK_SIZE, count - begin);
+            std::tuple<Ts*...> data(chunkOf<Ts>(std::get<I>(columns), chunk)...);
+
+            for (size_t row = 0; row < rows; ++row) {
+                if constexpr (std::is_invocable_v<Func&, EntityID, Ts&...>) {
+                    func(entities[begin + row], std::get<I>(data)[row]...);
+                } else {
+                    func(std::get<I>(data)[row]...);
+                }
+            }
+        }
+    }
+
+    template<typename Func, size_t... I>
+    void eachChangedInArchetype(Archetype* archetype, Func& func, uint32_t since, std::index_sequence<I...>) {
+        const size_t count = archetype->size();
+        const EntityID* entities = archetype->entities().data();
+        std::tuple<TypedColumn<std::remove_const_t<Ts>>*...> columns(
+            archetype->template column<std::remove_const_t<Ts>>()...);
+
+        std::vector<const uint32_t*> ticks;
+        for (ComponentTypeID type = 0; type < MAX_COMPONENT_TYPES; ++type) {
+            if (m_changed[type]) {
+                const ComponentColumn* column = archetype->column(type);
+                // Nothing in this column changed since our last run
+                if (column->lastChangeTick() <= since) return;
+                ticks.push_back(column->changeTicks());
+            }
+        }
+
+        for (size_t row = 0; row < count; ++row) {
+            bool changed = true;
+            for (const uint32_t* columnTicks : ticks) {
+                changed = changed && columnTicks[row] > since;
+            }
+            if (!changed) continue;
+
+            if constexpr (std::is_invocable_v<Func&, EntityID, Ts&...>) {
+                func(entities[row], *rowOf<Ts>(std::get<I>(columns), row)...);
+            } else {
+                func(*rowOf<Ts>(std::get<I>(columns), row)...);
+            }
+        }
+    }
+
+    World* m_world = nullptr;
+    const std::vector<std::unique_ptr<Archetype>>* m_archetypes = nullptr;
+    ComponentMask m_required;
+    ComponentMask m_excluded;
+    ComponentMask m_changed;
+    uint32_t m_lastRunTick = 0;
+    std::vector<Archetype*> m_matches;
+    size_t m_scanned = 0;
+};
+
+}
+}
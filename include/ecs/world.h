@@ -2,6 +2,8 @@
 
 #include "ecs/entity.h"
 #include "ecs/component.h"
+#include "ecs/archetype.h"
+#include "ecs/view.h"
 #include "ecs/components/transform.h"
 #include "ecs/components/name.h"
 #include "ecs/components/hierarchy.h"
@@ -11,79 +13,438 @@
 #include "ecs/components/boxcollider.h"
 #include "ecs/components/spherecollider.h"
 #include "ecs/components/rigidbody.h"
+#include <array>
+#include <atomic>
+#include <functional>
 #include <unordered_map>
+#include <deque>
 #include <memory>
-#include <typeindex>
+#include <string>
 #include <vector>
 #include <algorithm>
 
 namespace DabozzEngine {
 namespace ECS {
 
+/**
+ * Components live in archetypes: every entity with the same set of component
+ * types shares one Archetype, which keeps each type packed in chunked columns.
+ *
+ * Pointers returned by addComponent/getComponent stay valid until that entity
+ * gains or loses a component or is destroyed. Don't hold them across
+ * structural changes to the same archetype.
+ */
 class World {
 public:
+    using ObserverID = uint32_t;
+
     World();
     ~World();
 
     EntityID createEntity();
     void destroyEntity(EntityID entity);
 
+    // Bulk versions, e.g. for loading scenes. createEntities may return
+    // fewer than count handles if the entity index space runs out.
+    std::vector<EntityID> createEntities(size_t count);
+    void destroyEntities(const EntityID* entities, size_t count);
+    void destroyEntities(const std::vector<EntityID>& entities) {
+        destroyEntities(entities.data(), entities.size());
+    }
+
+    // Destroys every entity in one pass over the archetypes. Handles stay
+    // unique: generations keep counting, so old ones don't come back.
+    void clear();
+
+    // Recreates a destroyed entity with its original handle, e.g. for undo.
+    // Returns INVALID_ENTITY if the slot is currently occupied.
+    EntityID reviveEntity(EntityID entity);
+
+    // Hands out the handle of an entity that only comes to life at the next
+    // flushReservedEntities() (or createEntity/destroyEntity/reviveEntity,
+    // which flush first). Several threads may reserve at once, as long as
+    // nothing changes the World structurally meanwhile. See CommandBuffer.
+    EntityID reserveEntity();
+    void flushReservedEntities();
+
     template<typename T, typename... Args>
     T* addComponent(EntityID entity, Args&&... args) {
         if (!hasEntity(entity)) return nullptr;
-        
-        auto component = std::make_unique<T>(std::forward<Args>(args)...);
-        T* componentPtr = component.get();
-        
-        m_components[entity][typeid(T)] = std::move(component);
-        return componentPtr;
+
+        EntityRecord& record = m_records[entityIndex(entity)];
+        const ComponentTypeID type = componentTypeID<T>();
+        if (TypedColumn<T>* column = record.archetype->column<T>()) {
+            // Replacing an existing component keeps its slot, but observers
+            // see the old one go and the new one arrive. Built first, as
+            // below, since args may alias the component being replaced.
+            T replacement(std::forward<Args>(args)...);
+            T* existing = column->at(record.row);
+            if (m_removeObserved.test(type)) {
+                notifyRemove(type, entity, *existing);
+            }
+            existing->~T();
+            column->setChangeTick(record.row, changeTick());
+            T* replaced = new (existing) T(std::move(replacement));
+            if (m_addObserved.test(type)) {
+                notifyAdd(type, entity, *replaced);
+            }
+            return replaced;
+        }
+
+        // Build the component before moving rows so args may alias other components
+        T component(std::forward<Args>(args)...);
+
+        Archetype* target = record.archetype->m_addEdges[type];
+        if (!target) {
+            target = createAddEdge(record.archetype, std::make_unique<TypedColumn<T>>(m_chunkPool));
+        }
+
+        moveEntity(entity, target);
+        T* added = target->column<T>()->emplace(changeTick(), std::move(component));
+        if (m_addObserved.test(type)) {
+            notifyAdd(type, entity, *added);
+        }
+        return added;
     }
 
     template<typename T>
     T* getComponent(EntityID entity) {
-        auto entityIt = m_components.find(entity);
-        if (entityIt == m_components.end()) return nullptr;
-        
-        auto componentIt = entityIt->second.find(typeid(T));
-        if (componentIt == entityIt->second.end()) return nullptr;
-        
-        return static_cast<T*>(componentIt->second.get());
+        if (!hasEntity(entity)) return nullptr;
+
+        const EntityRecord& record = m_records[entityIndex(entity)];
+        TypedColumn<T>* column = record.archetype->template column<T>();
+        if (!column) return nullptr;
+
+        return column->at(record.row);
+    }
+
+    // Read-only access; unlike the non-const overload it never has to copy
+    // a chunk shared with a Snapshot.
+    template<typename T>
+    const T* getComponent(EntityID entity) const {
+        if (!hasEntity(entity)) return nullptr;
+
+        const EntityRecord& record = m_records[entityIndex(entity)];
+        const TypedColumn<T>* column = record.archetype->template column<T>();
+        if (!column) return nullptr;
+
+        return column->at(record.row);
     }
 
     template<typename T>
     bool hasComponent(EntityID entity) const {
-        auto entityIt = m_components.find(entity);
-        if (entityIt == m_components.end()) return false;
-        
-        return entityIt->second.count(typeid(T)) > 0;
+        if (!hasEntity(entity)) return false;
+
+        return m_records[entityIndex(entity)].archetype->has(componentTypeID<T>());
+    }
+
+    // Flags the entity's T as changed for views filtering on changed<T>().
+    // Adding a component counts as a change; writes through pointers don't,
+    // so call this after modifying a component other systems react to.
+    template<typename T>
+    void markChanged(EntityID entity) {
+        if (!hasEntity(entity)) return;
+
+        const EntityRecord& record = m_records[entityIndex(entity)];
+        if (TypedColumn<T>* column = record.archetype->template column<T>()) {
+            column->setChangeTick(record.row, changeTick());
+        }
+    }
+
+    // Current change tick. Changes are stamped with it; a query that wants
+    // "changed since I last looked" calls advanceChangeTick(), which returns
+    // the tick its own run covers up to and moves the clock past it.
+    uint32_t changeTick() const {
+        return m_changeTick.load(std::memory_order_relaxed);
+    }
+
+    uint32_t advanceChangeTick() {
+        return m_changeTick.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Bit componentTypeID<T>() is set for every component the entity has.
+    ComponentMask getComponentMask(EntityID entity) const {
+        if (!hasEntity(entity)) return ComponentMask();
+
+        return m_records[entityIndex(entity)].archetype->mask();
     }
 
     template<typename T>
     void removeComponent(EntityID entity) {
-        auto entityIt = m_components.find(entity);
-        if (entityIt == m_components.end()) return;
-        
-        entityIt->second.erase(typeid(T));
+        if (!hasEntity(entity)) return;
+
+        const ComponentTypeID type = componentTypeID<T>();
+        Archetype* source = m_records[entityIndex(entity)].archetype;
+        if (!source->has(type)) return;
+
+        if (m_removeObserved.test(type)) {
+            const ComponentColumn* column = source->column(type);
+            notifyRemove(type, entity, *column->get(m_records[entityIndex(entity)].row));
+        }
+
+        Archetype* target = source->m_removeEdges[type];
+        if (!target) {
+            target = createRemoveEdge(source, type);
+        }
+
+        moveEntity(entity, target);
+    }
+
+    // Reacting to components coming and going, e.g. to create a physics body
+    // or an audio source once instead of polling for new components:
+    //
+    //   world->onAdd<RigidBody>([&](EntityID entity, RigidBody& body) { ... });
+    //
+    // onAdd callbacks run right after a T is added, onRemove callbacks right
+    // before one goes away, whether by removeComponent, destroyEntity,
+    // destroyEntities or clear. Replacing a component counts as removing the
+    // old one and adding the new one, and so does everything restore()
+    // swaps out and back in. Destroying the World calls neither.
+    //
+    // Callbacks may read and write components, but must not create or destroy
+    // entities, add or remove components, or add or remove observers; queue
+    // structural changes in a CommandBuffer instead. Callbacks for the same
+    // type run in the order they were added.
+    template<typename T>
+    ObserverID onAdd(std::function<void(EntityID, T&)> callback) {
+        const ComponentTypeID type = componentTypeID<T>();
+        m_addObservers[type].push_back({ m_nextObserverID, [callback = std::move(callback)](EntityID entity, Component& component) {
+            callback(entity, static_cast<T&>(component));
+        }});
+        m_addObserved.set(type);
+        return m_nextObserverID++;
     }
 
+    template<typename T>
+    ObserverID onRemove(std::function<void(EntityID, const T&)> callback) {
+        const ComponentTypeID type = componentTypeID<T>();
+        m_removeObservers[type].push_back({ m_nextObserverID, [callback = std::move(callback)](EntityID entity, const Component& component) {
+            callback(entity, static_cast<const T&>(component));
+        }});
+        m_removeObserved.set(type);
+        return m_nextObserverID++;
+    }
+
+    // Unregisters an onAdd or onRemove callback. Unknown IDs are ignored.
+    void removeObserver(ObserverID observer);
+
+    // O(1); also rejects stale handles whose slot has since been recycled.
     bool hasEntity(EntityID entity) const {
-        return std::find(m_entities.begin(), m_entities.end(), entity) != m_entities.end();
+        uint32_t index = entityIndex(entity);
+        return index < m_records.size()
+            && m_records[index].dense != INVALID_DENSE_INDEX
+            && m_records[index].generation == entityGeneration(entity);
+    }
+
+    // Bumped whenever an entity is created or destroyed or gains or loses a
+    // component, so caches built from the World's layout know to rebuild.
+    uint32_t structureVersion() const {
+        return m_structureVersion;
     }
 
+    // Dense list of live entities. Destroying an entity moves the last one
+    // into its place, so order is not preserved across destroys.
     const std::vector<EntityID>& getEntities() const {
         return m_entities;
     }
 
-    std::unordered_map<std::type_index, std::unique_ptr<Component>>* getComponents(EntityID entity) {
-        auto entityIt = m_components.find(entity);
-        if (entityIt == m_components.end()) return nullptr;
-        return &entityIt->second;
+    // Typed query over every entity that has all of Ts. See View.
+    template<typename... Ts>
+    View<Ts...> view() {
+        return View<Ts...>(this);
+    }
+
+    // Every component on the entity, ordered by component type ID.
+    std::vector<std::pair<ComponentTypeID, Component*>> getComponents(EntityID entity);
+
+    // Creates a copy of an entity of source, which may be this World, with
+    // every component copy-constructed. Data components hold through a
+    // shared_ptr (Mesh geometry, animation clips, skeletons) ends up shared,
+    // not duplicated. Entity handles inside components, such as Hierarchy's,
+    // are copied as they are. See Prefab.
+    EntityID cloneEntity(const World& source, EntityID entity);
+
+    // Same, into target, an entity of this World that has no components yet
+    // (e.g. a flushed reserveEntity() handle). Returns false if either entity
+    // doesn't exist or target already has components.
+    bool cloneInto(const World& source, EntityID entity, EntityID target);
+
+    // Component chunk allocation counters; see ChunkPool.
+    const ChunkPool::Stats& getAllocationStats() const {
+        return m_chunkPool.stats();
+    }
+
+    struct ComponentStats {
+        ComponentTypeID type = 0;
+        const char* name = "";
+        size_t instances = 0;
+        size_t bytes = 0;          // instances times the component's size
+        size_t reservedBytes = 0;  // chunks held by the type's columns
+        size_t bufferBytes = 0;    // heap buffers the components own
+    };
+
+    struct ArchetypeStats {
+        ComponentMask mask;
+        size_t entities = 0;
+        size_t chunks = 0;         // per column
+        size_t bytes = 0;
+        size_t reservedBytes = 0;
+    };
+
+    struct Stats {
+        size_t entityCount = 0;
+        size_t entitySlots = 0;      // live plus free entity records
+        size_t archetypeCount = 0;
+        size_t emptyArchetypes = 0;  // archetypes no entity is in right now
+
+        size_t componentBytes = 0;   // live components
+        size_t reservedBytes = 0;    // component chunks, live rows or not
+        size_t pooledBytes = 0;      // freed chunks kept for reuse
+        size_t bufferBytes = 0;      // heap buffers components own, shared ones once
+        size_t bookkeepingBytes = 0; // entity records, row lists, change ticks
+
+        // Share of reserved chunk memory not holding a component. Every
+        // archetype column has a partly filled last chunk, so many small
+        // archetypes push it up.
+        float fragmentation = 0.0f;
+
+        std::vector<ComponentStats> components;  // by component type ID
+        std::vector<ArchetypeStats> archetypes;
+        std::vector<MemoryReport::Buffer> buffers;
+
+        size_t totalBytes() const {
+            return reservedBytes + pooledBytes + bufferBytes + bookkeepingBytes;
+        }
+
+        // Plain-text tables, for logs and the editor.
+        std::string format() const;
+    };
+
+    // Memory use and occupancy. Visits every component to size their
+    // buffers (see MemoryReport), so it's meant for tools, not every frame.
+    Stats stats() const;
+
+    // Returns cached component chunks to the heap. Chunks freed by destroyed
+    // entities are otherwise kept for reuse, e.g. by the next scene load.
+    void releaseUnusedMemory() {
+        m_chunkPool.trim();
+    }
+
+    class Snapshot;
+
+    // Captures every entity and component without copying any components;
+    // see Snapshot.
+    Snapshot snapshot();
+
+    // Puts every entity and component back the way they were when the
+    // snapshot was taken. Handles of entities created since stay invalid.
+    // All restored components count as changed.
+    void restore(const Snapshot& snapshot);
+
+    // Archetype storage, for systems that want to walk component columns
+    // directly. Append-only: archetypes live as long as the World.
+    const std::vector<std::unique_ptr<Archetype>>& getArchetypes() const {
+        return m_archetypes;
     }
 
 private:
+    static constexpr uint32_t INVALID_DENSE_INDEX = UINT32_MAX;
+
+    // Sparse side of the entity registry, indexed by entity slot
+    struct EntityRecord {
+        uint32_t dense = INVALID_DENSE_INDEX;
+        uint32_t generation = 0;
+        uint32_t nextGeneration = 0;
+        Archetype* archetype = nullptr;
+        size_t row = 0;
+    };
+
+    template<typename Callback>
+    struct Observer {
+        ObserverID id;
+        std::function<Callback> callback;
+    };
+
+    void notifyAdd(ComponentTypeID type, EntityID entity, Component& component);
+    void notifyRemove(ComponentTypeID type, EntityID entity, const Component& component);
+
+    // Every observed component of one row, or of every entity
+    void notifyRemoveRow(const Archetype& archetype, size_t row);
+    void notifyAddAll();
+    void notifyRemoveAll();
+
+    uint32_t allocateIndex();
+    EntityID createAt(uint32_t index);
+    void attachEntity(EntityID entity);
+
+    Archetype* createAddEdge(Archetype* source, std::unique_ptr<ComponentColumn> column);
+    Archetype* createRemoveEdge(Archetype* source, ComponentTypeID type);
+    Archetype* getOrCreateArchetype(const ComponentMask& mask,
+                                    const Archetype* source,
+                                    std::unique_ptr<ComponentColumn> extraColumn);
+
+    // Moves every component the target archetype also has. Components missing
+    // from the target are destroyed; columns missing from the source are left
+    // for the caller to fill.
+    void moveEntity(EntityID entity, Archetype* target);
+
+    std::vector<EntityID> m_entities;
+    std::vector<EntityRecord> m_records;
+    std::deque<uint32_t> m_freeIndices;
+
+    // Reserved handles map onto m_freeIndices in order, then onto fresh slots
+    // past the end of m_records
+    std::atomic<uint32_t> m_reservedCount{0};
+
+    uint32_t m_structureVersion = 0;
+
+    // Starts at 1 so a query that has never run (last tick 0) sees everything
+    std::atomic<uint32_t> m_changeTick{1};
+
+    // Declared before the archetypes so it outlives their columns
+    ChunkPool m_chunkPool;
+    std::vector<std::unique_ptr<Archetype>> m_archetypes;
+    std::unordered_map<ComponentMask, Archetype*> m_archetypeIndex;
+    Archetype* m_emptyArchetype;
+
+    // Indexed by component type; the masks let untouched types skip lookups
+    std::array<std::vector<Observer<void(EntityID, Component&)>>, MAX_COMPONENT_TYPES> m_addObservers;
+    std::array<std::vector<Observer<void(EntityID, const Component&)>>, MAX_COMPONENT_TYPES> m_removeObservers;
+    ComponentMask m_addObserved;
+    ComponentMask m_removeObserved;
+    ObserverID m_nextObserverID = 1;
+};
+
+/**
+ * The state of a World at one point in time, e.g. the edited scene while the
+ * game runs in play mode:
+ *
+ *   World::Snapshot editState = world->snapshot();
+ *   ...
+ *   world->restore(editState);
+ *
+ * A snapshot shares the World's component chunks instead of copying them;
+ * the World copies a chunk the first time it writes to it afterwards, so
+ * taking one costs about as much as copying the entity list. Only restore a
+ * snapshot into the World that took it, and don't keep one past that World.
+ */
+class World::Snapshot {
+public:
+    bool isValid() const { return m_world != nullptr; }
+
+private:
+    friend class World;
+
+    struct ArchetypeState {
+        std::vector<EntityID> entities;
+        std::vector<std::vector<std::shared_ptr<void>>> columns;
+    };
+
+    const World* m_world = nullptr;
+    std::vector<ArchetypeState> m_archetypes;
     std::vector<EntityID> m_entities;
-    EntityID m_nextEntityID;
-    std::unordered_map<EntityID, std::unordered_map<std::type_index, std::unique_ptr<Component>>> m_components;
+    std::vector<EntityRecord> m_records;
+    std::deque<uint32_t> m_freeIndices;
 };
 
 }
@@ -1,6 +1,7 @@
 #pragma once
 #include <QWidget>
 #include <QTreeWidget>
+#include <QLineEdit>
 #include <QVBoxLayout>
 #include <QUndoStack>
 #include "ecs/world.h"
@@ -8,6 +9,7 @@
 namespace DabozzEngine {
 namespace ECS {
 class World;
+class NameIndex;
 }
 }
 
@@ -21,6 +23,7 @@ public:
 
     void setWorld(DabozzEngine::ECS::World* world);
     void setUndoStack(QUndoStack* undoStack);
+    void setNameIndex(DabozzEngine::ECS::NameIndex* nameIndex);
     void refreshHierarchy();
     void duplicateSelectedEntity();
 
@@ -44,7 +47,9 @@ private:
     void keyPressEvent(QKeyEvent* event) override;
 
     QVBoxLayout* m_layout;
+    QLineEdit* m_searchBox;
     QTreeWidget* m_treeWidget;
     DabozzEngine::ECS::World* m_world;
     QUndoStack* m_undoStack = nullptr;
+    DabozzEngine::ECS::NameIndex* m_nameIndex = nullptr;
 };
\ No newline at end of file
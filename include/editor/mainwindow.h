@@ -8,15 +8,18 @@
 #include <QTabWidget>
 #include <QVector3D>
 #include <QQuaternion>
-#include <map>
 #include <QUndoStack>
 #include "ecs/world.h"
+#include "ecs/scheduler.h"
+#include "ecs/gameloop.h"
+#include <mutex>
 
 namespace DabozzEngine {
 namespace Systems {
     class PhysicsSystem;
     class AnimationSystem;
     class AudioSystem;
+    class TransformSystem;
 }
 namespace Physics {
     class ButsuriEngine;
@@ -24,6 +27,13 @@ namespace Physics {
 namespace Scripting {
     class ScriptEngine;
 }
+namespace ECS {
+    class NameIndex;
+}
+namespace Input {
+    class InputRecorder;
+    class InputReplayer;
+}
 
 }
 
@@ -58,6 +68,8 @@ private slots:
     void importMesh();
     void importAnimation();
     void openScriptEditor();
+    void showMemoryStats();
+    void replayInput();
     void openEsquemaEditor();
     void onPlayClicked();
     void onPauseClicked();
@@ -82,6 +94,9 @@ private:
     void createDockWidgets();
     void createStatusBar();
     void setupLayout();
+    void createSystemSchedule();
+    void startSimulation();
+    void stopSimulation();
     void connectViews();
     void createSampleEntities();
 
@@ -95,12 +110,29 @@ private:
     GameWindow* m_gameWindow;
     QTabWidget* m_centralTabs;
     DabozzEngine::ECS::World* m_world;
+    DabozzEngine::ECS::NameIndex* m_nameIndex;
     DabozzEngine::Physics::ButsuriEngine* m_butsuri;
     DabozzEngine::Systems::PhysicsSystem* m_physicsSystem;
     DabozzEngine::Systems::AnimationSystem* m_animationSystem;
     DabozzEngine::Systems::AudioSystem* m_audioSystem;
+    DabozzEngine::Systems::TransformSystem* m_transformSystem;
     DabozzEngine::Scripting::ScriptEngine* m_scriptEngine;
     QTimer* m_gameLoopTimer;
+    DabozzEngine::ECS::Scheduler m_scheduler;
+    DabozzEngine::ECS::GameLoop* m_gameLoop;
+    int m_scheduledFrames = 0;
+
+    // Per-step input of the current play session, if recording, or the
+    // recording driving it instead of the keyboard and mouse
+    QAction* m_recordInputAction;
+    DabozzEngine::Input::InputRecorder* m_inputRecorder = nullptr;
+    DabozzEngine::Input::InputReplayer* m_inputReplayer = nullptr;
+
+    // Held by the GUI thread whenever it is handling events while the game
+    // loop runs, so editor code can touch the World as before
+    std::unique_lock<std::mutex> m_worldLock;
+    QMetaObject::Connection m_dispatcherAwake;
+    QMetaObject::Connection m_dispatcherAboutToBlock;
     
     QMenu* m_fileMenu;
     QMenu* m_editMenu;
@@ -119,21 +151,10 @@ private:
     EditorMode m_editorMode;
     DabozzEngine::ECS::EntityID m_selectedEntity = DabozzEngine::ECS::INVALID_ENTITY;
 
-    // Saved state for restoring after play mode
-    struct SavedEntityState {
-        QVector3D position;
-        QQuaternion rotation;
-        QVector3D scale;
-        QVector3D velocity;
-        QVector3D angularVelocity;
-        float animatorTime;
-        bool animatorPlaying;
-    };
-    std::map<DabozzEngine::ECS::EntityID, SavedEntityState> m_savedState;
+    // The edited scene, restored when play mode stops
+    DabozzEngine::ECS::World::Snapshot m_editSnapshot;
 
     void applyDarkTheme();
     void initProject();
-    void saveSceneState();
-    void restoreSceneState();
     void loadProjectScripts();
 };
\ No newline at end of file
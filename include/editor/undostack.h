@@ -58,12 +58,14 @@ public:
     void undo() override {
         auto* t = m_world->getComponent<DabozzEngine::ECS::Transform>(m_entity);
         if (t) { t->position = m_oldPos; t->rotation = m_oldRot; t->scale = m_oldScale; }
+        m_world->markChanged<DabozzEngine::ECS::Transform>(m_entity);
         if (m_refresh) m_refresh();
     }
 
     void redo() override {
         auto* t = m_world->getComponent<DabozzEngine::ECS::Transform>(m_entity);
         if (t) { t->position = m_newPos; t->rotation = m_newRot; t->scale = m_newScale; }
+        m_world->markChanged<DabozzEngine::ECS::Transform>(m_entity);
         if (m_refresh) m_refresh();
     }
 
@@ -96,12 +98,14 @@ public:
     void undo() override {
         auto* n = m_world->getComponent<DabozzEngine::ECS::Name>(m_entity);
         if (n) n->name = m_oldName;
+        m_world->markChanged<DabozzEngine::ECS::Name>(m_entity);
         if (m_refresh) m_refresh();
     }
 
     void redo() override {
         auto* n = m_world->getComponent<DabozzEngine::ECS::Name>(m_entity);
         if (n) n->name = m_newName;
+        m_world->markChanged<DabozzEngine::ECS::Name>(m_entity);
         if (m_refresh) m_refresh();
     }
 
@@ -115,11 +119,9 @@ private:
 /**
  * @brief Command for undoing/redoing entity creation.
  *
- * On undo, destroys the entity. On redo, recreates it with the same components.
- * Note: uses a simplified approach - stores entity ID and recreates with basic
- * components (Name, Transform, Hierarchy). Complex components like Mesh with
- * GPU data are not fully preserved on undo.
- * i will do this later i find myself to lazy right now.
+ * On undo, destroys the entity. On redo, revives it under the same ID with
+ * basic components (Name, Transform, Hierarchy). Complex components like Mesh
+ * with GPU data are not preserved.
  */
 class CreateEntityCommand : public QUndoCommand {
 public:
@@ -142,11 +144,12 @@ public:
     }
 
     void redo() override {
-        /* Entity ID reuse is not supported by the current World implementation,
-           so redo after undo won't restore the exact same entity. This is a
-           known limitation - the entity gets a new ID on redo. */
-        if (!m_world->hasEntity(m_entity)) {
-            /* Can't recreate with same ID. Accept the limitation. */
+        /* First redo runs right after the entity was created, so only revive
+           when a previous undo destroyed it. */
+        if (!m_world->hasEntity(m_entity) && m_world->reviveEntity(m_entity) != DabozzEngine::ECS::INVALID_ENTITY) {
+            m_world->addComponent<DabozzEngine::ECS::Name>(m_entity, m_name);
+            m_world->addComponent<DabozzEngine::ECS::Transform>(m_entity);
+            m_world->addComponent<DabozzEngine::ECS::Hierarchy>(m_entity);
         }
         if (m_refresh) m_refresh();
     }
@@ -197,8 +200,12 @@ public:
     }
 
     void undo() override {
-        /* Recreate entity - note: gets a new ID since World doesn't support ID reuse */
-        DabozzEngine::ECS::EntityID newEntity = m_world->createEntity();
+        /* Revive under the original ID so parent/child links and other
+           commands on the stack still point at it. */
+        DabozzEngine::ECS::EntityID newEntity = m_world->reviveEntity(m_entity);
+        if (newEntity == DabozzEngine::ECS::INVALID_ENTITY) {
+            newEntity = m_world->createEntity();
+        }
         m_world->addComponent<DabozzEngine::ECS::Name>(newEntity, m_name);
 
         if (m_hasTransform) {
@@ -208,6 +215,7 @@ public:
         if (m_hasHierarchy) {
             auto* h = m_world->addComponent<DabozzEngine::ECS::Hierarchy>(newEntity);
             h->parent = m_parent;
+            h->children = m_children;
         }
         if (m_hasRigidBody) {
             m_world->addComponent<DabozzEngine::ECS::RigidBody>(newEntity, m_rbMass, m_rbStatic, m_rbGravity);
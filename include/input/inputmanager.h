@@ -3,17 +3,54 @@
 #include <QSet>
 #include <QPoint>
 #include <Qt>
+#include <cstdint>
+#include <vector>
 
 namespace DabozzEngine {
 namespace Input {
 
+// One raw change as the window delivered it. See InputRecorder.
+struct InputEvent {
+    enum class Type : uint8_t {
+        KeyDown,
+        KeyUp,
+        MouseDown,
+        MouseUp,
+        MouseMove,
+        MouseScroll
+    };
+
+    Type type = Type::KeyDown;
+    int x = 0;  // key, button, scroll delta or cursor x
+    int y = 0;  // cursor y
+};
+
+/**
+ * Keyboard and mouse state as the simulation sees it. Windows feed it
+ * events whenever they arrive; the game loop brackets every fixed step:
+ *
+ *   input.beginStep();   // mouse delta since the last step
+ *   scheduler.run(dt);   // isKeyPressed() etc. see this step's edges
+ *   input.endStep();     // clears pressed/released and scroll
+ *
+ * So a key tapped between two steps shows up as pressed in exactly one.
+ */
 class InputManager {
 public:
     static InputManager& getInstance();
 
-    void update();
+    void beginStep();
+    void endStep();
     void reset();
 
+    // Events since the last endStep(), in arrival order.
+    const std::vector<InputEvent>& stepEvents() const { return m_stepEvents; }
+
+    // Replays an event as if the window had sent it. Works while live
+    // input is disabled, e.g. to drive a scene from an InputReplayer.
+    void applyEvent(const InputEvent& event);
+    void setLiveInputEnabled(bool enabled) { m_liveInputEnabled = enabled; }
+
     void keyPressed(int key);
     void keyReleased(int key);
     
@@ -52,6 +89,9 @@ private:
     QPoint m_lastMousePosition;
     QPoint m_mouseDelta;
     int m_mouseScrollDelta = 0;
+
+    std::vector<InputEvent> m_stepEvents;
+    bool m_liveInputEnabled = true;
 };
 
 }
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "input/inputmanager.h"
+#include <QByteArray>
+#include <QString>
+#include <cstdint>
+
+namespace DabozzEngine {
+namespace Input {
+
+/**
+ * Captures the input of every fixed step, so a play session can be replayed
+ * identically, e.g. for benchmarking with DabozzRuntime --replay:
+ *
+ *   input.beginStep();
+ *   recorder.recordStep(input);   // events since the previous step
+ *   scheduler.run(dt);
+ *   input.endStep();
+ *
+ * The stream is a small header (magic, version, step length) followed by
+ * one entry per step: a varint that is either a run of steps without input
+ * or an event count, then the events. Cursor moves are stored relative to
+ * the previous one, and only a step's last move is kept since nothing reads
+ * the cursor in between. An idle minute at 60 Hz takes a couple of bytes.
+ */
+class InputRecorder {
+public:
+    explicit InputRecorder(float stepSeconds);
+
+    void recordStep(const InputManager& input);
+
+    uint64_t stepCount() const { return m_stepCount; }
+
+    // The stream so far; empty steps still pending are written out first.
+    QByteArray data() const;
+    bool save(const QString& path) const;
+
+private:
+    void writeEvent(const InputEvent& event);
+
+    QByteArray m_data;
+    uint64_t m_idleSteps = 0;
+    uint64_t m_stepCount = 0;
+    int m_lastX = 0;
+    int m_lastY = 0;
+};
+
+/**
+ * Plays an InputRecorder stream back into an InputManager, one step at a
+ * time, in place of the live events:
+ *
+ *   input.setLiveInputEnabled(false);
+ *   replayer.replayStep(input);
+ *   input.beginStep();
+ *   ...
+ *
+ * The scene has to start in the same state and step at stepSeconds() for
+ * the run to come out the same.
+ */
+class InputReplayer {
+public:
+    // False if the data isn't a complete recording.
+    bool load(const QString& path);
+    bool setData(const QByteArray& data);
+
+    float stepSeconds() const { return m_stepSeconds; }
+    uint64_t stepCount() const { return m_stepCount; }
+    uint64_t currentStep() const { return m_currentStep; }
+    bool atEnd() const { return m_currentStep >= m_stepCount; }
+
+    // Applies the next step's events. Returns false past the end.
+    bool replayStep(InputManager& input);
+
+    // Back to the first step.
+    void rewind();
+
+private:
+    // Reads one step into events, returns false at the end or on bad data
+    bool readStep(std::vector<InputEvent>& events);
+
+    QByteArray m_data;
+    float m_stepSeconds = 0.0f;
+    uint64_t m_stepCount = 0;
+    uint64_t m_currentStep = 0;
+
+    int m_offset = 0;
+    uint64_t m_idleSteps = 0;
+    int m_lastX = 0;
+    int m_lastY = 0;
+    std::vector<InputEvent> m_events;
+};
+
+}
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace DabozzEngine {
+namespace Jobs {
+
+using JobFunction = std::function<void()>;
+
+enum class JobAffinity : uint8_t {
+    Any,
+    MainThread   // GL, Qt and script VM work
+};
+
+// Counts jobs still outstanding. Each submit() against a counter adds one,
+// and finishing the job takes it away again.
+class JobCounter {
+public:
+    JobCounter() = default;
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    bool done() const { return m_value.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+
+    std::atomic<int> m_value{0};
+
+    // Guards the transition to zero and the jobs queued behind it
+    std::mutex m_mutex;
+    std::vector<JobFunction> m_continuations;
+};
+
+/**
+ * Fixed pool of worker threads that run short jobs.
+ *
+ *   Jobs::JobCounter counter;
+ *   jobs.submit([&] { buildMesh(a); }, &counter);
+ *   jobs.submit([&] { buildMesh(b); }, &counter);
+ *   jobs.wait(counter);
+ *
+ *   jobs.parallelFor(entities.size(), 256, [&](size_t begin, size_t end) { ... });
+ *
+ * Every worker owns a deque: it pushes and pops its own jobs at the back and,
+ * when that runs dry, steals from the front of the others. Threads that
+ * aren't workers submit into a shared queue. wait() runs jobs while it
+ * waits, so waiting inside a job doesn't tie up its worker.
+ *
+ * Jobs with MainThread affinity only run on the thread that created the
+ * JobSystem (or was handed the role with setMainThread), from wait() or
+ * runMainThreadJobs().
+ */
+class JobSystem {
+public:
+    // Shared instance with a worker per core besides the calling one. Reach
+    // it from the main thread first, which then owns MainThread jobs.
+    static JobSystem& instance();
+
+    // workerCount may be 0, in which case jobs run inside wait().
+    explicit JobSystem(size_t workerCount);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    size_t workerCount() const { return m_workers.size(); }
+    bool isMainThread() const { return std::this_thread::get_id() == m_mainThread.load(); }
+
+    // Makes thread the one MainThread jobs run on, e.g. a game loop thread
+    // that owns the script VM while it runs. Returns the previous one.
+    std::thread::id setMainThread(std::thread::id thread) { return m_mainThread.exchange(thread); }
+
+    void submit(JobFunction function, JobCounter* counter = nullptr,
+                JobAffinity affinity = JobAffinity::Any);
+
+    // Queues the job once dependency reaches zero. Don't submit more work
+    // against dependency while jobs wait on it.
+    void submitAfter(JobCounter& dependency, JobFunction function,
+                     JobCounter* counter = nullptr, JobAffinity affinity = JobAffinity::Any);
+
+    // Returns once the counter reaches zero, running queued jobs meanwhile.
+    void wait(JobCounter& counter);
+
+    // Runs MainThread jobs queued so far. Main thread only.
+    void runMainThreadJobs();
+
+    // Calls function(begin, end) over [0, count) in slices of grainSize,
+    // spread across the workers and the calling thread, and waits for them.
+    template<typename F>
+    void parallelFor(size_t count, size_t grainSize, F&& function) {
+        if (count == 0) return;
+        grainSize = std::max<size_t>(grainSize, 1);
+        if (count <= grainSize || m_workers.empty()) {
+            function(size_t(0), count);
+            return;
+        }
+
+        JobCounter counter;
+        for (size_t begin = grainSize; begin < count; begin += grainSize) {
+            const size_t end = std::min(begin + grainSize, count);
+            submit([&function, begin, end] { function(begin, end); }, &counter);
+        }
+        function(size_t(0), grainSize);
+        wait(counter);
+    }
+
+private:
+    struct Job {
+        JobFunction function;
+        JobCounter* counter = nullptr;
+    };
+
+    struct JobQueue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    void enqueue(Job job, JobAffinity affinity);
+    bool tryRunJob();
+    bool popJob(size_t queue, Job& job);
+    bool stealJob(size_t thief, Job& job);
+    bool popMainThreadJob(Job& job);
+    void execute(Job& job);
+    void finish(JobCounter& counter);
+    void workerLoop(size_t index);
+
+    // This thread's own queue; threads that aren't workers share the last one
+    size_t localQueue() const;
+
+    std::atomic<std::thread::id> m_mainThread;
+    std::vector<std::unique_ptr<JobQueue>> m_queues;
+    JobQueue m_mainThreadQueue;
+    std::vector<std::thread> m_workers;
+
+    std::atomic<size_t> m_queuedJobs{0};
+    std::atomic<size_t> m_sleepingWorkers{0};
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wake;
+    bool m_stopping = false;
+};
+
+}
+}
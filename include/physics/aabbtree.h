@@ -0,0 +1,151 @@
+#pragma once
+#include <QVector3D>
+#include <vector>
+
+namespace DabozzEngine::Physics {
+
+struct AABB {
+    QVector3D min;
+    QVector3D max;
+};
+
+/**
+ * Bounding volume hierarchy over moving boxes, for the broad phase and
+ * raycasts. Each proxy stores a "fat" box: the body's bounds grown by
+ * FAT_MARGIN and stretched along its last displacement, so a body that
+ * moves a little stays inside its leaf and the tree is left alone. Only
+ * bodies that leave their fat box are reinserted. Inserts pick the sibling
+ * that grows the tree's surface area least, and rotations keep it balanced.
+ *
+ *   int proxy = tree.createProxy(body.bounds, bodyId);
+ *   tree.moveProxy(proxy, body.bounds, body.position - oldPosition);
+ *   tree.query(box, [&](int bodyId) { ...; return true; });
+ *
+ * Callbacks return false to stop the search.
+ */
+class DynamicAABBTree {
+public:
+    static constexpr float FAT_MARGIN = 0.1f;
+
+    // Returns the proxy ID, stable until destroyProxy.
+    int createProxy(const AABB& bounds, int userData);
+    void destroyProxy(int proxy);
+
+    // Returns true if the proxy had to be reinserted.
+    bool moveProxy(int proxy, const AABB& bounds, const QVector3D& displacement);
+
+    int userData(int proxy) const { return m_nodes[proxy].userData; }
+    void setUserData(int proxy, int userData) { m_nodes[proxy].userData = userData; }
+    const AABB& fatBounds(int proxy) const { return m_nodes[proxy].bounds; }
+
+    void clear();
+
+    int height() const { return m_root < 0 ? 0 : m_nodes[m_root].height; }
+
+    // Calls callback(userData) for every proxy whose fat box overlaps bounds.
+    template<typename Callback>
+    void query(const AABB& bounds, Callback&& callback) const;
+
+    // Calls callback(userData, maxDistance) for every proxy whose fat box
+    // the ray enters within maxDistance, roughly nearest first. The callback
+    // returns the distance to keep searching up to: a hit's distance to clip
+    // the ray, maxDistance to go on, or a negative value to stop. direction
+    // must be normalized.
+    template<typename Callback>
+    void raycast(const QVector3D& origin, const QVector3D& direction, float maxDistance, Callback&& callback) const;
+
+private:
+    struct Node {
+        AABB bounds;
+        int parent = -1;    // next free node while on the free list
+        int child1 = -1;
+        int child2 = -1;
+        int height = -1;    // 0 for leaves, -1 while free
+        int userData = -1;
+
+        bool isLeaf() const { return child1 < 0; }
+    };
+
+    int allocateNode();
+    void freeNode(int node);
+    void insertLeaf(int leaf);
+    void removeLeaf(int leaf);
+    int balance(int node);
+
+    static bool overlaps(const AABB& a, const AABB& b);
+    static bool contains(const AABB& outer, const AABB& inner);
+    static AABB combine(const AABB& a, const AABB& b);
+    static float area(const AABB& bounds);
+    static bool rayEnters(const QVector3D& origin, const QVector3D& inverseDirection, const AABB& bounds, float maxDistance, float& distance);
+
+    std::vector<Node> m_nodes;
+    int m_root = -1;
+    int m_freeList = -1;
+
+    // Traversal stack, reused between queries
+    mutable std::vector<int> m_stack;
+};
+
+template<typename Callback>
+void DynamicAABBTree::query(const AABB& bounds, Callback&& callback) const
+{
+    if (m_root < 0) return;
+
+    m_stack.clear();
+    m_stack.push_back(m_root);
+    while (!m_stack.empty()) {
+        const Node& node = m_nodes[m_stack.back()];
+        m_stack.pop_back();
+        if (!overlaps(node.bounds, bounds)) continue;
+
+        if (node.isLeaf()) {
+            if (!callback(node.userData)) return;
+        } else {
+            m_stack.push_back(node.child1);
+            m_stack.push_back(node.child2);
+        }
+    }
+}
+
+template<typename Callback>
+void DynamicAABBTree::raycast(const QVector3D& origin, const QVector3D& direction, float maxDistance, Callback&& callback) const
+{
+    if (m_root < 0) return;
+
+    // Axis-parallel rays divide by zero here; the infinities sort themselves
+    // out in the slab test
+    const QVector3D inverseDirection(1.0f / direction.x(), 1.0f / direction.y(), 1.0f / direction.z());
+
+    m_stack.clear();
+    m_stack.push_back(m_root);
+    while (!m_stack.empty()) {
+        const Node& node = m_nodes[m_stack.back()];
+        m_stack.pop_back();
+
+        float distance;
+        if (!rayEnters(origin, inverseDirection, node.bounds, maxDistance, distance)) continue;
+
+        if (node.isLeaf()) {
+            const float clipped = callback(node.userData, maxDistance);
+            if (clipped < 0.0f) return;
+            maxDistance = clipped;
+        } else {
+            // Nearer child on top, so hits clip the far side sooner
+            float distance1, distance2;
+            const bool hit1 = rayEnters(origin, inverseDirection, m_nodes[node.child1].bounds, maxDistance, distance1);
+            const bool hit2 = rayEnters(origin, inverseDirection, m_nodes[node.child2].bounds, maxDistance, distance2);
+            const int child1 = node.child1;
+            const int child2 = node.child2;
+            if (hit1 && hit2) {
+                m_stack.push_back(distance1 <= distance2 ? child2 : child1);
+                m_stack.push_back(distance1 <= distance2 ? child1 : child2);
+            } else if (hit1) {
+                m_stack.push_back(child1);
+            } else if (hit2) {
+                m_stack.push_back(child2);
+            }
+        }
+    }
+}
+
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <QVector3D>
+#include "physics/aabbtree.h"
+#include <cstdint>
+#include <vector>
+
+namespace DabozzEngine::Physics {
+
+/**
+ * The per-body data the physics step streams through, one array per
+ * component, so the kernels below can work on four (SSE) or eight (AVX)
+ * bodies at a time. ButsuriEngine indexes it like its dense body list.
+ *
+ *   integrateGravity(arrays, gravity * deltaTime);
+ *   integratePositions(arrays, deltaTime, floorY);
+ *   refreshBounds(arrays);
+ *
+ * AVX is used when the build enables it (-mavx), SSE2 otherwise on x86-64,
+ * and plain loops everywhere else or with BUTSURI_NO_SIMD defined.
+ * setSimdPath() can force a narrower one at run time.
+ */
+struct BodyArrays {
+    std::vector<float> positionX, positionY, positionZ;
+    std::vector<float> velocityX, velocityY, velocityZ;
+    std::vector<float> extentX, extentY, extentZ;       // half size, or the radius three times
+    std::vector<float> minX, minY, minZ;
+    std::vector<float> maxX, maxY, maxZ;
+    std::vector<float> inverseMass;
+    std::vector<float> moving;                          // 1 for awake dynamic bodies, else 0
+    std::vector<float> sphere;                          // 1 for spheres, 0 for boxes
+
+    size_t size() const { return positionX.size(); }
+
+    void add(const QVector3D& position, const QVector3D& extent, float bodyInverseMass, bool isSphere, bool isMoving);
+    // Moves the last body into index
+    void swapRemove(size_t index);
+    void reserve(size_t count);
+    void clear();
+
+    QVector3D position(size_t i) const { return QVector3D(positionX[i], positionY[i], positionZ[i]); }
+    QVector3D velocity(size_t i) const { return QVector3D(velocityX[i], velocityY[i], velocityZ[i]); }
+    QVector3D extent(size_t i) const { return QVector3D(extentX[i], extentY[i], extentZ[i]); }
+    AABB bounds(size_t i) const { return AABB{ QVector3D(minX[i], minY[i], minZ[i]), QVector3D(maxX[i], maxY[i], maxZ[i]) }; }
+
+    void setPosition(size_t i, const QVector3D& position);
+    void setVelocity(size_t i, const QVector3D& velocity);
+    // Bounds around the current position
+    void fitBounds(size_t i);
+};
+
+enum class SimdPath {
+    Scalar,
+    SSE2,
+    AVX
+};
+
+// Widest path this build has: AVX with -mavx, SSE2 on x86-64, else scalar
+SimdPath widestSimdPath();
+
+// The path the kernels run on, widestSimdPath() unless forced narrower
+SimdPath simdPath();
+
+// Forces a path, e.g. to compare them in a benchmark. False, and nothing
+// changes, if this build doesn't have it. Not while a step is running.
+bool setSimdPath(SimdPath path);
+
+const char* simdPathName(SimdPath path);
+
+// velocity += gravityStep for moving bodies
+void integrateGravity(BodyArrays& bodies, const QVector3D& gravityStep);
+
+// position += velocity * deltaTime for moving bodies. Those ending up with
+// their bottom below floorY are put back on it, and stop falling.
+void integratePositions(BodyArrays& bodies, float deltaTime, float floorY);
+
+// Bounds of every body around its position
+void refreshBounds(BodyArrays& bodies);
+
+// touching[k] = 1 if the shape of body touches that of others[k], else 0.
+// Boxes are tested as boxes, spheres as spheres, and mixed pairs sphere
+// against box.
+void findTouching(const BodyArrays& bodies, size_t body, const int* others, size_t count, uint8_t* touching);
+
+}
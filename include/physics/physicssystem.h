@@ -1,10 +1,9 @@
 #pragma once
 #include "ecs/world.h"
+#include "physics/simplephysics.h"
+#include <vector>
 
 namespace DabozzEngine {
-namespace Physics {
-    class ButsuriEngine;
-}
 namespace Systems {
 
 class PhysicsSystem {
@@ -12,16 +11,34 @@ public:
     PhysicsSystem(ECS::World* world);
     ~PhysicsSystem();
     
+    // Creates a body for every entity with a Transform, RigidBody and
+    // BoxCollider, and from then on whenever one gets all three. shutdown()
+    // removes them again.
     void initialize();
     void shutdown();
     void update(float deltaTime);
     
 private:
-    void createPhysicsBodies();
+    void createBody(ECS::EntityID entity);
+    void releaseBody(ECS::EntityID entity);
+    bool ownsBody(ECS::EntityID entity, Physics::BodyID body) const;
+    void setOwner(Physics::BodyID body, ECS::EntityID entity);
     void syncTransforms();
     
     ECS::World* m_world;
     Physics::ButsuriEngine* m_butsuri;
+
+    std::vector<ECS::World::ObserverID> m_observers;
+
+    struct BodyOwner {
+        Physics::BodyID body = Physics::INVALID_BODY;
+        ECS::EntityID entity = ECS::INVALID_ENTITY;
+    };
+    // Our Butsuri bodies and their entities, indexed by body slot
+    std::vector<BodyOwner> m_bodyOwners;
+
+    // Transforms moved by something other than physics since the last step
+    ECS::View<const ECS::Transform, const ECS::RigidBody> m_movedBodies;
 };
 
 }
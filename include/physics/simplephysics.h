@@ -1,25 +1,51 @@
 #pragma once
 #include <QVector3D>
 #include <QQuaternion>
+#include "physics/aabbtree.h"
+#include "physics/bodyarrays.h"
+#include "physics/sweepandprune.h"
+#include <cstdint>
+#include <deque>
+#include <utility>
 #include <vector>
 
 namespace DabozzEngine::Physics {
 
+// Body handle layout: low 20 bits are the slot index, the 11 bits above them
+// the slot's generation, which keeps handles non-negative. Removing a body
+// bumps its slot generation, so stale handles stop resolving instead of
+// aliasing whichever body took the slot over.
+using BodyID = int;
+
+constexpr BodyID INVALID_BODY = -1;
+
+constexpr uint32_t BODY_INDEX_BITS = 20;
+constexpr uint32_t BODY_INDEX_MASK = (1u << BODY_INDEX_BITS) - 1;
+constexpr uint32_t BODY_GENERATION_MASK = (1u << (31 - BODY_INDEX_BITS)) - 1;
+
+constexpr uint32_t bodyIndex(BodyID body) {
+    return static_cast<uint32_t>(body) & BODY_INDEX_MASK;
+}
+
+constexpr uint32_t bodyGeneration(BodyID body) {
+    return static_cast<uint32_t>(body) >> BODY_INDEX_BITS;
+}
+
+constexpr BodyID makeBodyID(uint32_t index, uint32_t generation) {
+    return static_cast<BodyID>(((generation & BODY_GENERATION_MASK) << BODY_INDEX_BITS) | (index & BODY_INDEX_MASK));
+}
+
 enum class ColliderType {
     Box,
     Sphere
 };
 
-struct AABB {
-    QVector3D min;
-    QVector3D max;
-};
-
 struct Sphere {
     QVector3D center;
     float radius;
 };
 
+// A copy of one body, from ButsuriEngine::getBody
 struct RigidBodyState {
     QVector3D position;
     QQuaternion rotation;
@@ -28,12 +54,27 @@ struct RigidBodyState {
     float mass;
     float inverseMass;
     bool isStatic;
-    bool isSleeping;
+    bool isSleeping;        // skipped by the step until something wakes it
     ColliderType colliderType;
     AABB bounds;
     Sphere sphere;
 };
 
+// One body for createBodies
+struct BodyDesc {
+    ColliderType colliderType = ColliderType::Box;
+    QVector3D position;
+    QVector3D size = QVector3D(1, 1, 1);    // boxes
+    float radius = 0.5f;                    // spheres
+    float mass = 1.0f;
+    bool isStatic = false;
+};
+
+enum class BroadPhase {
+    Tree,           // DynamicAABBTree, the default
+    SweepAndPrune   // for levels of mostly static boxes
+};
+
 class ButsuriEngine {
 public:
     ButsuriEngine();
@@ -43,45 +84,164 @@ public:
     void shutdown();
     void update(float deltaTime);
     
-    int createBody(const QVector3D& position, const QVector3D& size, float mass, bool isStatic);
-    int createSphereBody(const QVector3D& position, float radius, float mass, bool isStatic);
-    void removeBody(int bodyId);
+    // Handles stay valid until their body is removed; other removals don't
+    // touch them. Removal swaps the last body into the hole, so it's O(1).
+    BodyID createBody(const QVector3D& position, const QVector3D& size, float mass, bool isStatic);
+    BodyID createSphereBody(const QVector3D& position, float radius, float mass, bool isStatic);
+    void removeBody(BodyID bodyId);
+    
+    // Many bodies at once, for spawners. Cheaper than one at a time: storage
+    // grows once, and contact pairs are dropped once.
+    std::vector<BodyID> createBodies(const BodyDesc* descs, size_t count);
+    std::vector<BodyID> createBodies(const std::vector<BodyDesc>& descs) {
+        return createBodies(descs.data(), descs.size());
+    }
+    void removeBodies(const BodyID* bodies, size_t count);
+    void removeBodies(const std::vector<BodyID>& bodies) {
+        removeBodies(bodies.data(), bodies.size());
+    }
     
-    RigidBodyState* getBody(int bodyId);
+    // Copies the body into state. False for removed bodies and stale
+    // handles.
+    bool getBody(BodyID bodyId, RigidBodyState& state) const;
+    bool hasBody(BodyID bodyId) const { return findBody(bodyId) >= 0; }
+    size_t getBodyCount() const { return m_bodies.size(); }
+    
+    // Just the position, for copying results out every step
+    bool getBodyPosition(BodyID bodyId, QVector3D& position) const;
+    
+    // The bodies the last update() moved: everything awake at its end, and
+    // whatever fell asleep in it. Handles go stale if their body is removed.
+    const std::vector<BodyID>& getAwakeBodies() const { return m_awakeBodies; }
+    
+    // These wake the body, and everything it fell asleep touching.
+    void wakeBody(BodyID bodyId);
+    void applyImpulse(BodyID bodyId, const QVector3D& impulse);
+    void setBodyVelocity(BodyID bodyId, const QVector3D& velocity);
+    void setBodyPosition(BodyID bodyId, const QVector3D& position);
+    
+    // A body moving slower than velocity for seconds in a row goes to sleep, once
+    // every body it touches (directly or through others) is ready too.
+    // seconds <= 0 turns sleeping off.
+    void setSleepThresholds(float velocity, float seconds);
     
     struct RaycastHit {
         bool hit;
         QVector3D point;
         QVector3D normal;
         float distance;
-        int bodyId;
+        BodyID bodyId;
     };
     
     RaycastHit raycast(const QVector3D& origin, const QVector3D& direction, float maxDistance = 1000.0f);
     
-    void setGravity(const QVector3D& gravity) { m_gravity = gravity; }
+    // Where the pairs for collision resolution come from. Raycasts always
+    // use the tree.
+    void setBroadPhase(BroadPhase broadPhase);
+    BroadPhase getBroadPhase() const { return m_broadPhase; }
+    
+    // What the last update() did, for profiling
+    struct StepStats {
+        size_t pairCount = 0;       // pairs the broad phase reported
+        double broadPhaseMs = 0.0;  // proxy updates and the pair search
+    };
+    const StepStats& getStepStats() const { return m_stepStats; }
+    
+    // Wakes everything, resting bodies may no longer be at rest
+    void setGravity(const QVector3D& gravity);
     QVector3D getGravity() const { return m_gravity; }
     
     static ButsuriEngine* getInstance();
     
 private:
     void integrateVelocities(float deltaTime);
+    void updateBroadPhase(float deltaTime);
     void detectCollisions();
     void resolveCollisions();
     void integratePositions(float deltaTime);
+    void updateSleep(float deltaTime);
+    
+    // Dense index of a live handle, or -1
+    int findBody(BodyID bodyId) const;
+    BodyID addBody(const RigidBodyState& body, const QVector3D& extent);
+    void eraseBody(size_t index);
+    void clearBodies();
+    void wakeIndex(size_t index);
     
-    bool checkAABBCollision(const AABB& a, const AABB& b);
-    bool checkSphereCollision(const Sphere& a, const Sphere& b);
-    bool checkAABBSphereCollision(const AABB& aabb, const Sphere& sphere);
-    void resolveAABBCollision(RigidBodyState& a, RigidBodyState& b);
-    void resolveSphereCollision(RigidBodyState& a, RigidBodyState& b);
-    void resolveAABBSphereCollision(RigidBodyState& box, RigidBodyState& sphere);
+    // Sleeping bodies only wake island by island, through wakeIsland
+    void setAwake(size_t index);
+    void setAsleep(size_t index, int island);
+    int createIsland();
+    void wakeIsland(int island);
+    void wakeTouching(const AABB& bounds);
+    int findIsland(int index);
+    
+    // Dense indices
+    void resolveAABBCollision(size_t a, size_t b);
+    void resolveSphereCollision(size_t a, size_t b);
+    void resolveAABBSphereCollision(size_t box, size_t sphere);
     
     bool rayAABBIntersect(const QVector3D& origin, const QVector3D& direction, const AABB& aabb, float& t);
     bool raySphereIntersect(const QVector3D& origin, const QVector3D& direction, const Sphere& sphere, float& t);
     
-    std::vector<RigidBodyState> m_bodies;
+    // Per-body data the step doesn't stream through; the rest is in
+    // m_arrays
+    struct BodyRecord {
+        QQuaternion rotation;
+        QVector3D angularVelocity;
+        float mass;
+        bool isStatic;
+        bool isSleeping;
+        ColliderType colliderType;
+        int proxy = -1;         // broad phase tree leaf
+        int sweepProxy = -1;    // sweep-and-prune entry, while that's in use
+        float sleepTime = 0.0f; // seconds spent moving slower than the sleep velocity
+        int island = -1;        // the island it fell asleep with, while sleeping
+        int islandPrev = -1;    // neighbours in that island's member chain
+        int islandNext = -1;
+    };
+    
+    // Live bodies, packed; everything inside the engine works on these
+    // indices. m_bodyIds holds the handle of each.
+    std::vector<BodyRecord> m_bodies;
+    BodyArrays m_arrays;
+    std::vector<BodyID> m_bodyIds;
+    std::vector<BodyID> m_awakeBodies;
+    
+    // Sparse side, indexed by handle slot
+    struct BodySlot {
+        int dense = -1;
+        uint32_t generation = 0;
+    };
+    std::vector<BodySlot> m_slots;
+    // FIFO reuse spreads generation bumps over all free slots
+    std::deque<uint32_t> m_freeSlots;
+    
     QVector3D m_gravity;
+
+    DynamicAABBTree m_tree;
+    SweepAndPrune m_sweep;
+    BroadPhase m_broadPhase = BroadPhase::Tree;
+    // Body index pairs whose fat boxes overlap, lower index first
+    std::vector<std::pair<int, int>> m_pairs;
+    StepStats m_stepStats;
+    // One body's pairs at a time, for findTouching
+    std::vector<int> m_candidates;
+    std::vector<uint8_t> m_touching;
+    
+    float m_sleepVelocity = 0.05f;
+    float m_timeToSleep = 0.5f;
+    // Positions before this step, to tell how far bodies moved
+    std::vector<QVector3D> m_stepStarts;
+    // Dynamic bodies that touched this step, for the islands
+    std::vector<std::pair<int, int>> m_contacts;
+    // Union-find parents, and per island root its slowest body's sleepTime
+    std::vector<int> m_islandParents;
+    std::vector<float> m_islandSleepTimes;
+    std::vector<int> m_islandIds;
+    // First member of each sleeping island, -1 for free island ids
+    std::vector<int> m_islandHeads;
+    std::vector<int> m_freeIslands;
 };
 
 }
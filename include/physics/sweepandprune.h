@@ -0,0 +1,91 @@
+#pragma once
+#include "physics/aabbtree.h"
+#include <utility>
+#include <vector>
+
+namespace DabozzEngine {
+namespace Jobs {
+    class JobSystem;
+}
+}
+
+namespace DabozzEngine::Physics {
+
+/**
+ * Sweep-and-prune broad phase, for levels with many static boxes and
+ * comparatively few movers. Boxes are sorted by their lower bound on one
+ * axis, and two boxes can only overlap if one starts inside the other
+ * there:
+ *
+ *   sweep.createProxy(body.bounds, bodyId, body.isStatic);
+ *   sweep.moveProxy(proxy, body.bounds);
+ *   sweep.findPairs(pairs, Jobs::JobSystem::instance());
+ *
+ * Static and dynamic boxes live in separate lists, so static-static pairs
+ * are never looked at. The static list stays sorted as it's edited; the
+ * dynamic one is re-sorted every step with an insertion sort, which costs
+ * about one pass while bodies move a little per step. The scan itself is
+ * split across the job system.
+ *
+ * Boxes are grown by DynamicAABBTree::FAT_MARGIN, so both broad phases
+ * report the same close pairs.
+ */
+class SweepAndPrune {
+public:
+    // Returns the proxy ID, stable until destroyProxy.
+    int createProxy(const AABB& bounds, int userData, bool isStatic);
+    void destroyProxy(int proxy);
+    void moveProxy(int proxy, const AABB& bounds);
+
+    // Sleeping bodies are treated as static until they wake.
+    void setProxyStatic(int proxy, bool isStatic);
+
+    void setUserData(int proxy, int userData);
+
+    void clear();
+
+    // The sweep axis, 0 to 2. Picked from the spread of the boxes.
+    int axis() const { return m_axis; }
+
+    // Replaces pairs with every (lower, higher) user data pair whose boxes
+    // overlap and that aren't both static, sorted.
+    void findPairs(std::vector<std::pair<int, int>>& pairs, Jobs::JobSystem& jobs);
+
+private:
+    struct Entry {
+        AABB bounds;
+        int proxy;
+    };
+
+    struct Proxy {
+        AABB bounds;
+        int userData = -1;
+        bool isStatic = false;
+        int nextFree = -1;
+    };
+
+    static AABB fatten(const AABB& bounds);
+    bool entryBefore(const Entry& a, const Entry& b) const;
+    std::vector<Entry>::iterator findEntry(std::vector<Entry>& list, int proxy);
+    void insertStatic(const Entry& entry);
+
+    // Picks the axis with the widest spread and re-sorts if it changed
+    void chooseAxis();
+    void sortDynamic();
+
+    std::vector<Proxy> m_proxies;
+    int m_freeList = -1;
+    size_t m_proxyCount = 0;
+
+    std::vector<Entry> m_statics;
+    std::vector<Entry> m_dynamics;
+
+    int m_axis = 0;
+    // Proxy count the axis was last picked at
+    size_t m_axisProxyCount = 0;
+
+    // One pair list per scan slice
+    std::vector<std::vector<std::pair<int, int>>> m_slicePairs;
+};
+
+}
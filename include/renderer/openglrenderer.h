@@ -7,6 +7,11 @@
 #include <QTimer>
 #include <QVector3D>
 #include "ecs/world.h"
+#include "ecs/components/mesh.h"
+#include "ecs/systems/transformsystem.h"
+#include <memory>
+#include <string>
+#include <unordered_map>
 
 class OpenGLRenderer : public QOpenGLWidget, protected QOpenGLFunctions_3_3_Core
 {
@@ -19,6 +24,9 @@ public:
     void setWorld(DabozzEngine::ECS::World* world);
     DabozzEngine::ECS::World* getWorld() const { return m_world; }
 
+    // World matrices for drawing and gizmos; updated at the start of each paint
+    void setTransformSystem(DabozzEngine::Systems::TransformSystem* transforms) { m_transforms = transforms; }
+
     void initializeGL() override;
     void resizeGL(int w, int h) override;
     void paintGL() override;
@@ -63,6 +71,23 @@ private:
     
     QMatrix4x4 getWorldTransform(DabozzEngine::ECS::EntityID entity) const;
 
+    // GPU copy of a MeshData, shared by every mesh using it (duplicates,
+    // prefab instances). Each renderer has its own GL context, so its own.
+    struct GpuMesh {
+        std::weak_ptr<const DabozzEngine::ECS::MeshData> data;
+        GLuint vao = 0;
+        GLuint vbo = 0;
+        GLuint ebo = 0;
+        GLuint boneVBO = 0;
+        GLuint weightVBO = 0;
+        GLuint textureID = 0;
+        GLsizei indexCount = 0;
+    };
+
+    const GpuMesh* gpuMesh(const DabozzEngine::ECS::Mesh& mesh);
+    GLuint textureFor(const DabozzEngine::ECS::Mesh& mesh);
+    void releaseGpuMesh(GpuMesh& gpu);
+
     struct Ray {
         QVector3D origin;
         QVector3D direction;
@@ -111,6 +136,11 @@ private:
 
     float m_clearColor[4];
     DabozzEngine::ECS::World* m_world;
+    DabozzEngine::Systems::TransformSystem* m_transforms = nullptr;
+    DabozzEngine::ECS::View<const DabozzEngine::ECS::Transform, const DabozzEngine::ECS::Mesh> m_renderables;
+    std::unordered_map<const DabozzEngine::ECS::MeshData*, GpuMesh> m_gpuMeshes;
+    std::unordered_map<std::string, GLuint> m_fileTextures;
+    size_t m_gpuMeshSweepSize = 64;
     DabozzEngine::ECS::EntityID m_selectedEntity;
     bool m_draggingGizmo;
     bool m_rightMouseDown;
@@ -118,6 +148,7 @@ private:
     GizmoAxis m_hoverAxis;
     float m_dragStartAxisValue;
     QVector3D m_dragStartPosition;
+    QVector3D m_dragOrigin;
     QVector3D m_dragStartScale;
     QQuaternion m_dragStartRotation;
     QVector3D m_dragPlaneNormal;
@@ -21,6 +21,8 @@ namespace DabozzEngine {
 
 namespace ECS {
     class World;
+    class CommandBuffer;
+    class NameIndex;
 }
 
 namespace Scripting {
@@ -29,6 +31,8 @@ class ScriptAPI {
 public:
     static void SetDeltaTime(float dt) { s_deltaTime = dt; }
     static void SetLogCallback(std::function<void(const std::string&)> callback) { s_logCallback = callback; }
+    static void SetCommandBuffer(ECS::CommandBuffer* commands) { s_commands = commands; }
+    static void SetNameIndex(ECS::NameIndex* names) { s_names = names; }
     
     static std::function<void(const std::string&)> s_logCallback;
     
@@ -106,7 +110,14 @@ private:
     static float AS_Distance(float x1, float y1, float z1, float x2, float y2, float z2);
     static float AS_Lerp(float a, float b, float t);
 
+    // Looks in the World first, then at components queued in s_commands
+    // by the running script
+    template<typename T> static T* GetComponent(ECS::EntityID entity);
+    template<typename T> static bool HasComponent(ECS::EntityID entity);
+
     static ECS::World* s_world;
+    static ECS::CommandBuffer* s_commands;
+    static ECS::NameIndex* s_names;
     static float s_deltaTime;
 };
 
@@ -47,6 +47,7 @@ namespace DabozzEngine {
 
 namespace ECS {
     class World;
+    class CommandBuffer;
 }
 
 namespace Scripting {
@@ -78,6 +79,11 @@ public:
     asIScriptEngine* getAngelScriptEngine() { return m_asEngine; }
 
 private:
+    // Sync point for structural changes scripts made through the command
+    // buffer; runs after every call into script code
+    void flushCommands();
+
+    std::unique_ptr<ECS::CommandBuffer> m_commands;
     lua_State* m_luaState;
     asIScriptEngine* m_asEngine;
     asIScriptContext* m_asContext;
@@ -38,6 +38,7 @@ Usage:
     python pbj.py build [--target debug|release] [-j N] [--verbose]
     python pbj.py clean
     python pbj.py rebuild [--target debug|release] [-j N] [--verbose]
+    python pbj.py build --file pbjruntime.py    (headless DabozzRuntime)
 """
 
 import argparse
@@ -67,6 +68,7 @@ class Environment:
         self.linker = "g++"
         self.output = "a.exe"
         self.obj_dir = "obj"
+        self.cache_file = ".pbj_cache.json"
         self.bin_dir = "bin"
 
         self._sources = []
@@ -88,17 +90,21 @@ class Environment:
         self._deploy_files = []
         self._deploy_dirs = []
 
-    def add_sources(self, directory, extensions=None):
+    def add_sources(self, directory, extensions=None, exclude=None):
         """
         @brief Recursively scan a directory for source files.
         @param directory Source directory path relative to project root.
         @param extensions List of file extensions to include (e.g. [".cpp", ".c"]).
+        @param exclude List of subdirectories to skip (e.g. ["src/runtime"]).
         """
         if extensions:
             self._extensions = extensions
         root = Path(directory)
+        skipped = [Path(d) for d in (exclude or [])]
         for ext in self._extensions:
             for f in root.rglob(f"*{ext}"):
+                if any(d == f.parent or d in f.parents for d in skipped):
+                    continue
                 self._sources.append(str(f))
 
     def add_source_files(self, files):
@@ -368,7 +374,7 @@ class Builder:
         self._target = target
         self._jobs = jobs
         self._verbose = verbose
-        self._cache = DependencyCache(".pbj_cache.json")
+        self._cache = DependencyCache(env.cache_file)
 
     def _run_moc(self):
         """
@@ -565,9 +571,9 @@ class Builder:
             os.remove(output_path)
             print(f"  Removed {output_path}")
 
-        if os.path.exists(".pbj_cache.json"):
-            os.remove(".pbj_cache.json")
-            print("  Removed .pbj_cache.json")
+        if os.path.exists(self._env.cache_file):
+            os.remove(self._env.cache_file)
+            print(f"  Removed {self._env.cache_file}")
 
         print("Clean complete.")
 
@@ -678,14 +684,15 @@ class Builder:
                 print(f"  [DEPLOY] {src}/ -> {dest_path}/")
 
 
-def _load_pbjfile():
+def _load_pbjfile(filename="pbjfile.py"):
     """
-    @brief Load and execute pbjfile.py to get the build Environment.
-    @return The Environment object configured by pbjfile.py.
+    @brief Load and execute a pbjfile to get the build Environment.
+    @param filename Build file in the current directory (default pbjfile.py).
+    @return The Environment object configured by the build file.
     """
-    pbjfile = os.path.join(os.getcwd(), "pbjfile.py")
+    pbjfile = os.path.join(os.getcwd(), filename)
     if not os.path.exists(pbjfile):
-        print("Error: pbjfile.py not found in current directory.")
+        print(f"Error: {filename} not found in current directory.")
         sys.exit(1)
 
     env = Environment()
@@ -920,6 +927,8 @@ def main():
                         help=f"Number of parallel jobs (default: {cpu_count()})")
     parser.add_argument("--verbose", "-v", action="store_true",
                         help="Verbose output")
+    parser.add_argument("--file", "-f", default="pbjfile.py",
+                        help="Build file to use, e.g. pbjruntime.py (default: pbjfile.py)")
 
     args = parser.parse_args()
 
@@ -929,7 +938,7 @@ def main():
             sys.exit(1)
         return
 
-    env = _load_pbjfile()
+    env = _load_pbjfile(args.file)
     builder = Builder(env, target=args.target, jobs=args.jobs, verbose=args.verbose)
 
     if args.command == "clean":
@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+#############################################################################
+# pbjbench.py                                                               #
+#############################################################################
+#                         This file is part of:                             #
+#                           DABOZZ ENGINE                                   #
+#############################################################################
+# Copyright (c) 2026-present DabozzEngine contributors.                     #
+#                                                                           #
+# PB&J build configuration for DabozzBench, the engine micro-benchmarks.    #
+# Build with: python pbj.py build --file pbjbench.py                        #
+#############################################################################
+
+import os
+from pbj import Environment
+
+# DABOZZ_BENCH_AVX=1 builds DabozzBench_avx.exe with -mavx, which can run the
+# physics kernels on AVX as well as SSE2 and scalar
+AVX = os.environ.get("DABOZZ_BENCH_AVX") == "1"
+SUFFIX = "_avx" if AVX else ""
+
+env = Environment()
+
+env.project_name = "DabozzBench"
+env.compiler = "C:/Qt/Tools/mingw1310_64/bin/g++.exe"
+env.linker = "C:/Qt/Tools/mingw1310_64/bin/g++.exe"
+env.output = f"DabozzBench{SUFFIX}.exe"
+env.obj_dir = f"obj_bench{SUFFIX}"
+env.bin_dir = "bin"
+env.cache_file = f".pbj_bench{SUFFIX}_cache.json"
+
+## Sources ##################################################################
+
+# Only the systems under test, driven by synthetic workloads
+env.add_sources("src/bench", extensions=[".cpp"])
+env.add_sources("src/jobs", extensions=[".cpp"])
+
+env.add_source_files([
+    "src/ecs/world.cpp",
+    "src/ecs/chunkpool.cpp",
+    "src/physics/butsuri.cpp",
+    "src/physics/aabbtree.cpp",
+    "src/physics/sweepandprune.cpp",
+    "src/physics/bodyarrays.cpp",
+])
+
+## Includes #################################################################
+
+env.add_includes([
+    "include",
+    "C:/Qt/6.10.2/mingw_64/include",
+    "C:/Qt/6.10.2/mingw_64/include/QtGui",
+    "C:/Qt/6.10.2/mingw_64/include/QtCore",
+])
+
+## Compiler Flags ###########################################################
+
+env.add_cflags([
+    "-std=gnu++1z",
+    "-Wall",
+    "-Wextra",
+    "-fexceptions",
+    "-mthreads",
+])
+
+if AVX:
+    env.add_cflags(["-mavx"])
+
+env.add_defines([
+    "UNICODE",
+    "_UNICODE",
+    "WIN32",
+    "MINGW_HAS_SECURE_API=1",
+    "QT_NO_DEBUG",
+    "QT_GUI_LIB",
+    "QT_CORE_LIB",
+])
+
+## Linker ###################################################################
+
+env.add_ldflags([
+    "-Wl,-s",
+    "-Wl,-subsystem,console",
+    "-mthreads",
+])
+
+env.add_lib_dirs([
+    "C:/Qt/6.10.2/mingw_64/lib",
+])
+
+# QtGui only for its math types (QVector3D, QQuaternion, QMatrix4x4)
+env.add_ldflags([
+    "C:/Qt/6.10.2/mingw_64/lib/libQt6Gui.a",
+    "C:/Qt/6.10.2/mingw_64/lib/libQt6Core.a",
+])
+
+env.add_libs([
+    "mingw32",
+    "shell32",
+])
+
+## Deploy ###################################################################
+
+QT_BIN = "C:/Qt/6.10.2/mingw_64/bin"
+MINGW_BIN = "C:/Qt/Tools/mingw1310_64/bin"
+
+for dll in ["Qt6Core", "Qt6Gui"]:
+    env.deploy(f"{QT_BIN}/{dll}.dll")
+
+for dll in ["libgcc_s_seh-1", "libstdc++-6", "libwinpthread-1"]:
+    env.deploy(f"{MINGW_BIN}/{dll}.dll")
@@ -30,7 +30,9 @@ env.add_qrc("shaders.qrc")
 
 ## Sources ##################################################################
 
-env.add_sources("src", extensions=[".cpp", ".c"])
+# src/runtime and src/bench have their own main(); see pbjruntime.py and
+# pbjbench.py
+env.add_sources("src", extensions=[".cpp", ".c"], exclude=["src/runtime", "src/bench"])
 
 ## Includes #################################################################
 
@@ -0,0 +1,124 @@
+#!/usr/bin/env python3
+#############################################################################
+# pbjruntime.py                                                             #
+#############################################################################
+#                         This file is part of:                             #
+#                           DABOZZ ENGINE                                   #
+#############################################################################
+# Copyright (c) 2026-present DabozzEngine contributors.                     #
+#                                                                           #
+# PB&J build configuration for DabozzRuntime, the headless scene player.    #
+# Build with: python pbj.py build --file pbjruntime.py                      #
+#############################################################################
+
+from pbj import Environment
+
+env = Environment()
+
+env.project_name = "DabozzRuntime"
+env.compiler = "C:/Qt/Tools/mingw1310_64/bin/g++.exe"
+env.linker = "C:/Qt/Tools/mingw1310_64/bin/g++.exe"
+env.output = "DabozzRuntime.exe"
+env.obj_dir = "obj_runtime"
+env.bin_dir = "bin"
+env.cache_file = ".pbj_runtime_cache.json"
+
+## Sources ##################################################################
+
+# Simulation only: no editor widgets, renderer or OpenGL
+env.add_sources("src/runtime", extensions=[".cpp"])
+env.add_sources("src/ecs", extensions=[".cpp"])
+env.add_sources("src/jobs", extensions=[".cpp"])
+env.add_sources("src/physics", extensions=[".cpp"])
+env.add_sources("src/scripting", extensions=[".cpp"])
+env.add_sources("src/input", extensions=[".cpp"])
+
+env.add_source_files([
+    "src/editor/scenefile.cpp",
+    "src/renderer/animation.cpp",
+    "src/renderer/skeleton.cpp",
+])
+
+## Includes #################################################################
+
+env.add_includes([
+    "include",
+    "assimp_source/include",
+    "assimp_source/build/include",
+    "glm",
+    "openal-soft/include",
+    "lua",
+    "angelscript/sdk/angelscript/include",
+    "C:/Qt/6.10.2/mingw_64/include",
+    "C:/Qt/6.10.2/mingw_64/include/QtGui",
+    "C:/Qt/6.10.2/mingw_64/include/QtCore",
+])
+
+## Compiler Flags ###########################################################
+
+env.add_cflags([
+    "-std=gnu++1z",
+    "-Wall",
+    "-Wextra",
+    "-fexceptions",
+    "-mthreads",
+])
+
+env.add_defines([
+    "UNICODE",
+    "_UNICODE",
+    "WIN32",
+    "MINGW_HAS_SECURE_API=1",
+    "QT_NO_DEBUG",
+    "QT_GUI_LIB",
+    "QT_CORE_LIB",
+])
+
+## Linker ###################################################################
+
+env.add_ldflags([
+    "-Wl,-s",
+    "-Wl,-subsystem,console",
+    "-mthreads",
+])
+
+env.add_lib_dirs([
+    "C:/Qt/6.10.2/mingw_64/lib",
+    "assimp_source/build/lib",
+    "openal-soft/build",
+    ".",
+    "angelscript/sdk/angelscript/lib",
+])
+
+# QtGui only for its math types (QVector3D, QQuaternion, QMatrix4x4)
+env.add_ldflags([
+    "C:/Qt/6.10.2/mingw_64/lib/libQt6Gui.a",
+    "C:/Qt/6.10.2/mingw_64/lib/libQt6Core.a",
+])
+
+env.add_libs([
+    "mingw32",
+    "shell32",
+    "assimp",
+    "lua",
+    "angelscript",
+    "OpenAL32",
+])
+
+env.add_ldflags([
+    "assimp_source/build/bin/libassimp-6.dll",
+])
+
+## Deploy ###################################################################
+
+QT_BIN = "C:/Qt/6.10.2/mingw_64/bin"
+MINGW_BIN = "C:/Qt/Tools/mingw1310_64/bin"
+
+for dll in ["Qt6Core", "Qt6Gui"]:
+    env.deploy(f"{QT_BIN}/{dll}.dll")
+
+for dll in ["libgcc_s_seh-1", "libstdc++-6", "libwinpthread-1"]:
+    env.deploy(f"{MINGW_BIN}/{dll}.dll")
+
+env.deploy("assimp_source/build/bin/libassimp-6.dll")
+env.deploy("openal-soft/build/OpenAL32.dll")
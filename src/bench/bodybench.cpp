@@ -0,0 +1,132 @@
+#include "bench/bench.h"
+#include "physics/simplephysics.h"
+#include <cctype>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace DabozzEngine {
+namespace Bench {
+
+namespace {
+
+constexpr int CANDIDATES_PER_BODY = 32;
+
+bool sameName(const char* a, const char* b)
+{
+    for (; *a && *b; ++a, ++b) {
+        if (std::tolower(static_cast<unsigned char>(*a)) != std::tolower(static_cast<unsigned char>(*b))) return false;
+    }
+    return *a == *b;
+}
+
+Physics::BodyArrays makeBodies(size_t count)
+{
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> area(-200.0f, 200.0f);
+    Physics::BodyArrays bodies;
+    bodies.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        // Unit boxes and spheres of radius 0.5 alternate
+        bodies.add(QVector3D(area(rng), 100.0f + area(rng) * 0.1f, area(rng)), QVector3D(0.5f, 0.5f, 0.5f), 1.0f,
+                   i % 2 == 0, true);
+    }
+    return bodies;
+}
+
+// Gravity, positions and bounds over every body, as in a step
+double integrateBodiesPerMs(size_t count, int repeats)
+{
+    Physics::BodyArrays bodies = makeBodies(count);
+    constexpr int STEPS = 20;
+    const double ms = bestMs(repeats, [&] {
+        for (int step = 0; step < STEPS; ++step) {
+            Physics::integrateGravity(bodies, QVector3D(0.0f, -9.81f / 60.0f, 0.0f));
+            Physics::integratePositions(bodies, 1.0f / 60.0f, -4.75f);
+            Physics::refreshBounds(bodies);
+        }
+    });
+    return count * STEPS / ms;
+}
+
+// The narrow phase kernel: each body against a run of nearby candidates
+double touchingPairsPerMs(size_t count, int repeats)
+{
+    Physics::BodyArrays bodies = makeBodies(count);
+    std::mt19937 rng(2);
+    std::vector<int> candidates(count * CANDIDATES_PER_BODY);
+    for (int& candidate : candidates) candidate = static_cast<int>(rng() % count);
+    std::vector<uint8_t> touching(CANDIDATES_PER_BODY);
+
+    const double ms = bestMs(repeats, [&] {
+        size_t hits = 0;
+        for (size_t body = 0; body < count; ++body) {
+            Physics::findTouching(bodies, body, candidates.data() + body * CANDIDATES_PER_BODY, CANDIDATES_PER_BODY,
+                                  touching.data());
+            for (uint8_t hit : touching) hits += hit;
+        }
+        consume(static_cast<double>(hits));
+    });
+    return count * CANDIDATES_PER_BODY / ms;
+}
+
+// Whole ButsuriEngine steps: boxes and spheres settling onto a floor
+double stepBodiesPerMs(size_t count)
+{
+    Physics::ButsuriEngine engine;
+    engine.initialize();
+    engine.setSleepThresholds(0.0f, 0.0f);
+    engine.createBody(QVector3D(0, -5.25f, 0), QVector3D(400, 1, 400), 0, true);
+
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<float> area(-60.0f, 60.0f);
+    for (size_t i = 0; i < count; ++i) {
+        const QVector3D position(area(rng), 5.0f + (area(rng) + 60.0f) / 4.0f, area(rng));
+        if (i % 2 == 0) {
+            engine.createSphereBody(position, 0.5f, 1.0f, false);
+        } else {
+            engine.createBody(position, QVector3D(1, 1, 1), 1.0f, false);
+        }
+    }
+
+    constexpr int STEPS = 60;
+    const float deltaTime = 1.0f / 60.0f;
+    for (int step = 0; step < STEPS; ++step) engine.update(deltaTime);
+    const Clock::time_point start = Clock::now();
+    for (int step = 0; step < STEPS; ++step) engine.update(deltaTime);
+    const double ms = elapsedMs(start);
+    engine.shutdown();
+    return count * STEPS / ms;
+}
+
+}
+
+void runBodyBenchmarks(const Options& options)
+{
+    using Physics::SimdPath;
+    std::printf("Butsuri body kernels, bodies per ms (this build goes up to %s)\n",
+                Physics::simdPathName(Physics::widestSimdPath()));
+    std::printf("  %-8s %16s %16s %18s %16s\n", "path", "integrate 10k", "integrate 100k", "touching pairs/ms",
+                "full step 20k");
+
+    const SimdPath widest = Physics::widestSimdPath();
+    for (SimdPath path : { SimdPath::Scalar, SimdPath::SSE2, SimdPath::AVX }) {
+        const char* name = Physics::simdPathName(path);
+        if (options.simd && !sameName(options.simd, name)) continue;
+        if (!Physics::setSimdPath(path)) {
+            std::printf("  %-8s not in this build%s\n", name,
+                        path == SimdPath::AVX ? "; build with DABOZZ_BENCH_AVX=1 set (adds -mavx)" : "");
+            continue;
+        }
+        std::printf("  %-8s %16.0f %16.0f %18.0f %16.0f\n", name,
+                    integrateBodiesPerMs(10000, options.repeats),
+                    integrateBodiesPerMs(100000, options.repeats),
+                    touchingPairsPerMs(20000, options.repeats),
+                    stepBodiesPerMs(20000));
+    }
+    Physics::setSimdPath(widest);
+    std::printf("\n");
+}
+
+}
+}
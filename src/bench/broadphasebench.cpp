@@ -0,0 +1,108 @@
+#include "bench/bench.h"
+#include "physics/simplephysics.h"
+#include <algorithm>
+#include <cstdio>
+#include <random>
+
+namespace DabozzEngine {
+namespace Bench {
+
+namespace {
+
+constexpr int WARMUP_STEPS = 30;
+constexpr int MEASURED_STEPS = 200;
+
+enum class Layout {
+    TiledFloor,  // a grid of floor tiles, some raised
+    Props        // one floor slab with props strewn over it
+};
+
+void buildScene(Physics::ButsuriEngine& engine, Layout layout, int statics, int dynamics)
+{
+    std::mt19937 rng(9);
+    std::uniform_real_distribution<float> jitter(-0.05f, 0.05f);
+    int side = 1;
+    while (side * side < statics) ++side;
+
+    if (layout == Layout::Props) {
+        std::uniform_real_distribution<float> area(-side * 0.5f, side * 0.5f);
+        std::uniform_real_distribution<float> extent(0.3f, 3.0f);
+        engine.createBody(QVector3D(0, -5.25f, 0), QVector3D(side * 1.2f, 0.5f, side * 1.2f), 0, true);
+        for (int i = 1; i < statics; ++i) {
+            const QVector3D size(extent(rng), extent(rng), extent(rng));
+            engine.createBody(QVector3D(area(rng), -5.0f + size.y() * 0.5f, area(rng)), size, 0, true);
+        }
+    } else {
+        for (int i = 0; i < statics; ++i) {
+            const float x = (i % side) - side * 0.5f;
+            const float z = (i / side) - side * 0.5f;
+            const float height = (i % 13 == 0) ? 2.0f : 0.5f;
+            engine.createBody(QVector3D(x, -5.0f + height * 0.5f, z), QVector3D(1, height, 1), 0, true);
+        }
+    }
+
+    // Movers in layers of boxes spread over the floor
+    int dynamicSide = 1;
+    while (dynamicSide * dynamicSide * 4 < dynamics) ++dynamicSide;
+    const float spacing = std::max(1.5f, side / static_cast<float>(dynamicSide));
+    const float offset = dynamicSide * spacing * 0.5f;
+    for (int i = 0; i < dynamics; ++i) {
+        const int layer = i / (dynamicSide * dynamicSide);
+        const int cell = i % (dynamicSide * dynamicSide);
+        const QVector3D position((cell % dynamicSide) * spacing - offset + jitter(rng),
+                                 layer * 1.5f + jitter(rng),
+                                 (cell / dynamicSide) * spacing - offset + jitter(rng));
+        engine.createBody(position, QVector3D(1, 1, 1), 1, false);
+    }
+}
+
+void measure(const char* scene, Layout layout, int statics, int dynamics)
+{
+    double results[2][2] = {};
+    const Physics::BroadPhase broadPhases[] = { Physics::BroadPhase::Tree, Physics::BroadPhase::SweepAndPrune };
+    for (int i = 0; i < 2; ++i) {
+        Physics::ButsuriEngine engine;
+        engine.initialize();
+        engine.setBroadPhase(broadPhases[i]);
+        // Every body stays awake, so both sides see the whole scene
+        engine.setSleepThresholds(0.0f, 0.0f);
+        buildScene(engine, layout, statics, dynamics);
+
+        const float deltaTime = 1.0f / 60.0f;
+        for (int step = 0; step < WARMUP_STEPS; ++step) engine.update(deltaTime);
+
+        double broadPhaseMs = 0.0;
+        double pairs = 0.0;
+        for (int step = 0; step < MEASURED_STEPS; ++step) {
+            engine.update(deltaTime);
+            broadPhaseMs += engine.getStepStats().broadPhaseMs;
+            pairs += engine.getStepStats().pairCount;
+        }
+        results[i][0] = broadPhaseMs / MEASURED_STEPS;
+        results[i][1] = pairs / broadPhaseMs / 1000.0;
+        engine.shutdown();
+    }
+
+    char label[64];
+    std::snprintf(label, sizeof(label), "%s, %d/%d", scene, statics, dynamics);
+    std::printf("  %-28s %8.3f ms %6.2f Mp/s %8.3f ms %6.2f Mp/s\n", label,
+                results[0][0], results[0][1], results[1][0], results[1][1]);
+}
+
+}
+
+void runBroadPhaseBenchmarks(const Options&)
+{
+    std::printf("Broad phase per step, AABB tree against sweep and prune (static/dynamic bodies,\n"
+                "Mp/s = millions of pairs found per second)\n");
+    std::printf("  %-28s %23s %23s\n", "scene", "tree", "sap");
+    measure("tiled floor", Layout::TiledFloor, 5000, 300);
+    measure("tiled floor", Layout::TiledFloor, 20000, 500);
+    measure("floor + props", Layout::Props, 5000, 300);
+    measure("floor + props", Layout::Props, 20000, 500);
+    measure("dynamic-heavy", Layout::TiledFloor, 100, 3000);
+    std::printf("\n");
+}
+
+}
+}
@@ -0,0 +1,74 @@
+#include "bench/bench.h"
+#include "ecs/world.h"
+#include "ecs/components/transform.h"
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace DabozzEngine {
+namespace Bench {
+
+namespace {
+
+constexpr size_t ENTITY_COUNT = 1000000;
+
+void printRow(const char* name, double ms, size_t operations)
+{
+    std::printf("  %-44s %9.2f ms %8.1f ns/op\n", name, ms, ms * 1.0e6 / operations);
+}
+
+}
+
+void runEntityBenchmarks(const Options& options)
+{
+    using namespace ECS;
+    std::printf("Entity registry, %zu entities\n", ENTITY_COUNT);
+
+    std::vector<EntityID> entities(ENTITY_COUNT);
+
+    // One at a time, into a fresh World and into one whose slots are all free
+    printRow("createEntity, fresh World", bestMs(options.repeats, [&] {
+        World world;
+        for (size_t i = 0; i < ENTITY_COUNT; ++i) entities[i] = world.createEntity();
+    }), ENTITY_COUNT);
+
+    World world;
+    printRow("createEntity + destroyEntity, recycled slots", bestMs(options.repeats, [&] {
+        for (size_t i = 0; i < ENTITY_COUNT; ++i) entities[i] = world.createEntity();
+        for (size_t i = 0; i < ENTITY_COUNT; ++i) world.destroyEntity(entities[i]);
+    }), ENTITY_COUNT * 2);
+
+    printRow("createEntities + destroyEntities", bestMs(options.repeats, [&] {
+        entities = world.createEntities(ENTITY_COUNT);
+        world.destroyEntities(entities);
+    }), ENTITY_COUNT * 2);
+
+    // Churn: half of a full World dies and is replaced, in random order
+    std::mt19937 rng(1);
+    entities = world.createEntities(ENTITY_COUNT);
+    printRow("churn: destroy + create half, random order", bestMs(options.repeats, [&] {
+        std::shuffle(entities.begin(), entities.end(), rng);
+        for (size_t i = 0; i < ENTITY_COUNT / 2; ++i) world.destroyEntity(entities[i]);
+        for (size_t i = 0; i < ENTITY_COUNT / 2; ++i) entities[i] = world.createEntity();
+    }), ENTITY_COUNT);
+
+    printRow("churn with a Transform on each entity", bestMs(options.repeats, [&] {
+        std::shuffle(entities.begin(), entities.end(), rng);
+        for (size_t i = 0; i < ENTITY_COUNT / 2; ++i) world.destroyEntity(entities[i]);
+        for (size_t i = 0; i < ENTITY_COUNT / 2; ++i) {
+            entities[i] = world.createEntity();
+            world.addComponent<Transform>(entities[i]);
+        }
+    }), ENTITY_COUNT);
+
+    printRow("hasEntity over live and stale handles", bestMs(options.repeats, [&] {
+        size_t live = 0;
+        for (EntityID entity : entities) live += world.hasEntity(entity);
+        consume(static_cast<double>(live));
+    }), ENTITY_COUNT);
+    std::printf("\n");
+}
+
+}
+}
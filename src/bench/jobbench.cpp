@@ -0,0 +1,81 @@
+#include "bench/bench.h"
+#include "jobs/jobsystem.h"
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace DabozzEngine {
+namespace Bench {
+
+namespace {
+
+constexpr size_t EMPTY_JOBS = 200000;
+constexpr size_t SQRT_COUNT = 4000000;
+constexpr size_t SQRT_GRAIN = 16384;
+
+// Submit and wait on empty jobs: what the scheduler costs per job
+double submitNs(Jobs::JobSystem& jobs, int repeats)
+{
+    const double ms = bestMs(repeats, [&] {
+        Jobs::JobCounter counter;
+        for (size_t i = 0; i < EMPTY_JOBS; ++i) {
+            jobs.submit([] {}, &counter);
+        }
+        jobs.wait(counter);
+    });
+    return ms * 1.0e6 / EMPTY_JOBS;
+}
+
+// Chain of jobs that each only start once the previous one finished
+double chainNs(Jobs::JobSystem& jobs, int repeats)
+{
+    constexpr size_t LENGTH = 10000;
+    const double ms = bestMs(repeats, [&] {
+        std::vector<Jobs::JobCounter> links(LENGTH);
+        jobs.submit([] {}, &links[0]);
+        for (size_t i = 1; i < LENGTH; ++i) {
+            jobs.submitAfter(links[i - 1], [] {}, &links[i]);
+        }
+        jobs.wait(links.back());
+    });
+    return ms * 1.0e6 / LENGTH;
+}
+
+double parallelSqrtMs(Jobs::JobSystem& jobs, int repeats)
+{
+    std::vector<double> sums((SQRT_COUNT + SQRT_GRAIN - 1) / SQRT_GRAIN);
+    return bestMs(repeats, [&] {
+        jobs.parallelFor(SQRT_COUNT, SQRT_GRAIN, [&](size_t begin, size_t end) {
+            double sum = 0.0;
+            for (size_t i = begin; i < end; ++i) {
+                sum += std::sqrt(static_cast<double>(i));
+            }
+            sums[begin / SQRT_GRAIN] = sum;
+        });
+        double total = 0.0;
+        for (double sum : sums) total += sum;
+        consume(total);
+    });
+}
+
+}
+
+void runJobBenchmarks(const Options& options)
+{
+    std::printf("Job system, forcing the worker count (threads = workers + caller)\n");
+    std::printf("  %-8s %14s %14s %18s %9s\n", "threads", "submit ns/job", "chain ns/job", "parallelFor ms", "speedup");
+
+    double singleMs = 0.0;
+    for (size_t threads = 1; threads <= options.maxThreads; ++threads) {
+        Jobs::JobSystem jobs(threads - 1);
+        const double submit = submitNs(jobs, options.repeats);
+        const double chain = chainNs(jobs, options.repeats);
+        const double sqrtMs = parallelSqrtMs(jobs, options.repeats);
+        if (threads == 1) singleMs = sqrtMs;
+        std::printf("  %-8zu %14.0f %14.0f %18.2f %8.2fx\n", threads, submit, chain, sqrtMs, singleMs / sqrtMs);
+    }
+    std::printf("  parallelFor: sqrt over %zu indices in slices of %zu\n\n", SQRT_COUNT, SQRT_GRAIN);
+}
+
+}
+}
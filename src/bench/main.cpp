@@ -0,0 +1,109 @@
+/**************************************************************************/
+/*  main.cpp (DabozzBench)                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                           DABOZZ ENGINE                                */
+/**************************************************************************/
+/* Copyright (c) 2026-present DabozzEngine contributors.                  */
+/**************************************************************************/
+
+/*
+ * Micro-benchmarks for the engine's core systems on synthetic workloads, so
+ * the numbers quoted when they changed can be measured again:
+ *
+ *   DabozzBench                    every suite
+ *   DabozzBench jobs               just the named suites
+ *   DabozzBench jobs --threads 8   scale up to 8 threads
+ *   DabozzBench bodies --simd sse2 one SIMD path of the physics kernels
+ *   DabozzBench --list
+ */
+
+#include "bench/bench.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace DabozzEngine;
+
+namespace {
+
+struct Suite {
+    const char* name;
+    const char* description;
+    void (*run)(const Bench::Options& options);
+};
+
+const Suite SUITES[] = {
+    { "jobs", "Job submit/wait overhead and parallelFor scaling", Bench::runJobBenchmarks },
+    { "entities", "1M entity create/destroy and churn", Bench::runEntityBenchmarks },
+    { "views", "World views against per-entity getComponent loops", Bench::runViewBenchmarks },
+    { "broadphase", "AABB tree against sweep and prune on synthetic levels", Bench::runBroadPhaseBenchmarks },
+    { "bodies", "Butsuri body kernels per SIMD path, in bodies per ms", Bench::runBodyBenchmarks },
+};
+
+volatile double g_sink = 0.0;
+
+void printUsage()
+{
+    std::printf("Usage: DabozzBench [suite...] [--threads N] [--repeats N] [--simd PATH] [--list]\n\n");
+    std::printf("  --threads N   run scaling benchmarks from 1 up to N threads (default: one per core)\n");
+    std::printf("  --repeats N   report the best of N runs of each timing (default 5)\n");
+    std::printf("  --simd PATH   run the physics kernels on only scalar, sse2 or avx (default: each one built)\n");
+    std::printf("  --list        list the suites\n");
+}
+
+}
+
+void Bench::consume(double value)
+{
+    g_sink = g_sink + value;
+}
+
+int main(int argc, char* argv[])
+{
+    Bench::Options options;
+    options.maxThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<const Suite*> selected;
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (std::strcmp(arg, "--threads") == 0 && i + 1 < argc) {
+            options.maxThreads = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(arg, "--repeats") == 0 && i + 1 < argc) {
+            options.repeats = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(arg, "--simd") == 0 && i + 1 < argc) {
+            options.simd = argv[++i];
+        } else if (std::strcmp(arg, "--list") == 0) {
+            for (const Suite& suite : SUITES) {
+                std::printf("  %-12s %s\n", suite.name, suite.description);
+            }
+            return 0;
+        } else if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0) {
+            printUsage();
+            return 0;
+        } else {
+            const Suite* found = nullptr;
+            for (const Suite& suite : SUITES) {
+                if (std::strcmp(arg, suite.name) == 0) found = &suite;
+            }
+            if (!found) {
+                std::fprintf(stderr, "Unknown suite or option %s\n\n", arg);
+                printUsage();
+                return 1;
+            }
+            selected.push_back(found);
+        }
+    }
+    if (selected.empty()) {
+        for (const Suite& suite : SUITES) selected.push_back(&suite);
+    }
+
+    for (const Suite* suite : selected) {
+        suite->run(options);
+    }
+    return 0;
+}
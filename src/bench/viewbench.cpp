@@ -0,0 +1,79 @@
+#include "bench/bench.h"
+#include "ecs/world.h"
+#include "ecs/components/transform.h"
+#include "ecs/components/mesh.h"
+#include <cstdio>
+
+namespace DabozzEngine {
+namespace Bench {
+
+namespace {
+
+constexpr size_t ENTITY_COUNT = 100000;
+
+// The per-mesh work of a render pass, boiled down to reading both components
+inline double visit(const ECS::Transform& transform, const ECS::Mesh& mesh)
+{
+    return transform.position.x() + transform.scale.y() + (mesh.hasTexture ? 1.0 : 0.0);
+}
+
+void compare(const char* scene, ECS::World& world, int repeats)
+{
+    using namespace ECS;
+    const size_t entityCount = world.getEntities().size();
+
+    const double lookupMs = bestMs(repeats, [&] {
+        double sum = 0.0;
+        for (EntityID entity : world.getEntities()) {
+            const Transform* transform = world.getComponent<Transform>(entity);
+            const Mesh* mesh = world.getComponent<Mesh>(entity);
+            if (transform && mesh) sum += visit(*transform, *mesh);
+        }
+        consume(sum);
+    });
+
+    auto meshes = world.view<const Transform, const Mesh>();
+    const double viewMs = bestMs(repeats, [&] {
+        double sum = 0.0;
+        meshes.each([&](EntityID, const Transform& transform, const Mesh& mesh) {
+            sum += visit(transform, mesh);
+        });
+        consume(sum);
+    });
+
+    std::printf("  %-34s %10.3f ms %10.3f ms %8.1fx   (%.1f / %.1f ns per entity)\n", scene, lookupMs, viewMs,
+                lookupMs / viewMs, lookupMs * 1.0e6 / entityCount, viewMs * 1.0e6 / entityCount);
+}
+
+}
+
+void runViewBenchmarks(const Options& options)
+{
+    using namespace ECS;
+    std::printf("Views against a getComponent loop over every entity\n");
+    std::printf("  %-34s %13s %13s %9s\n", "scene", "getComponent", "view", "speedup");
+
+    {
+        World world;
+        for (EntityID entity : world.createEntities(ENTITY_COUNT)) {
+            world.addComponent<Transform>(entity);
+            world.addComponent<Mesh>(entity);
+        }
+        compare("100k Transform+Mesh", world, options.repeats);
+    }
+    {
+        // Only every fourth entity has a mesh, as in a level full of empties,
+        // lights and colliders
+        World world;
+        size_t index = 0;
+        for (EntityID entity : world.createEntities(ENTITY_COUNT)) {
+            world.addComponent<Transform>(entity);
+            if (index++ % 4 == 0) world.addComponent<Mesh>(entity);
+        }
+        compare("100k Transform, 25k with Mesh", world, options.repeats);
+    }
+    std::printf("\n");
+}
+
+}
+}
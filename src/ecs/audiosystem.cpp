@@ -6,8 +6,9 @@
 namespace DabozzEngine {
 namespace Systems {
 
-AudioSystem::AudioSystem(ECS::World* world)
-    : m_world(world), m_device(nullptr), m_context(nullptr), m_initialized(false)
+AudioSystem::AudioSystem(ECS::World* world, TransformSystem* transforms)
+    : m_world(world), m_transforms(transforms), m_sources(world), m_lastMoveTick(0)
+    , m_device(nullptr), m_context(nullptr), m_initialized(false)
 {
 }
 
@@ -40,7 +41,21 @@ void AudioSystem::initialize()
     float orientation[] = { 0.0f, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f };
     alListenerfv(AL_ORIENTATION, orientation);
 
+    // Fresh change filters, so the first update configures every source
+    m_changedSources = ECS::View<ECS::AudioSource>(m_world).changed<ECS::AudioSource>();
+    m_lastMoveTick = 0;
+
     m_initialized = true;
+
+    m_sources.each([this](ECS::AudioSource& audio) {
+        acquireSource(audio);
+    });
+    m_observers.push_back(m_world->onAdd<ECS::AudioSource>([this](ECS::EntityID, ECS::AudioSource& audio) {
+        acquireSource(audio);
+    }));
+    m_observers.push_back(m_world->onRemove<ECS::AudioSource>([this](ECS::EntityID, const ECS::AudioSource& audio) {
+        releaseSource(audio);
+    }));
     qDebug() << "AudioSystem: Initialized successfully";
 }
 
@@ -48,22 +63,18 @@ void AudioSystem::shutdown()
 {
     if (!m_initialized) return;
 
-    for (ECS::EntityID entity : m_world->getEntities()) {
-        ECS::AudioSource* audio = m_world->getComponent<ECS::AudioSource>(entity);
-        if (!audio) continue;
-
-        if (audio->sourceId) {
-            alSourceStop(audio->sourceId);
-            alDeleteSources(1, &audio->sourceId);
-            audio->sourceId = 0;
-        }
-        if (audio->bufferId) {
-            alDeleteBuffers(1, &audio->bufferId);
-            audio->bufferId = 0;
-        }
-        audio->isPlaying = false;
-        audio->isLoaded = false;
+    for (ECS::World::ObserverID observer : m_observers) {
+        m_world->removeObserver(observer);
     }
+    m_observers.clear();
+
+    m_sources.each([this](ECS::AudioSource& audio) {
+        releaseSource(audio);
+        audio.sourceId = 0;
+        audio.bufferId = 0;
+        audio.isPlaying = false;
+        audio.isLoaded = false;
+    });
 
     alcMakeContextCurrent(nullptr);
     if (m_context) {
@@ -82,15 +93,16 @@ void AudioSystem::update(float deltaTime)
 {
     if (!m_initialized) return;
 
-    for (ECS::EntityID entity : m_world->getEntities()) {
-        ECS::AudioSource* audio = m_world->getComponent<ECS::AudioSource>(entity);
-        if (!audio) continue;
+    // Properties are only pushed to OpenAL when the AudioSource changed.
+    // Sources load when added; this catches a file set afterwards.
+    m_changedSources.each([this](ECS::EntityID entity, ECS::AudioSource& source) {
+        ECS::AudioSource* audio = &source;
 
         if (!audio->isLoaded && !audio->filePath.isEmpty()) {
             loadAudioFile(audio);
         }
 
-        if (!audio->isLoaded) continue;
+        if (!audio->isLoaded) return;
 
         alSourcef(audio->sourceId, AL_GAIN, audio->volume);
         alSourcef(audio->sourceId, AL_PITCH, audio->pitch);
@@ -98,12 +110,12 @@ void AudioSystem::update(float deltaTime)
         
         // Update 3D spatial audio if enabled
         if (audio->spatial) {
-            ECS::Transform* transform = m_world->getComponent<ECS::Transform>(entity);
-            if (transform) {
+            if (m_world->hasComponent<ECS::Transform>(entity)) {
+                const QVector3D position = m_transforms->worldPosition(entity);
                 alSource3f(audio->sourceId, AL_POSITION, 
-                    transform->position.x(), 
-                    transform->position.y(), 
-                    transform->position.z());
+                    position.x(), 
+                    position.y(), 
+                    position.z());
                 alSourcei(audio->sourceId, AL_SOURCE_RELATIVE, AL_FALSE);
             }
         } else {
@@ -111,6 +123,26 @@ void AudioSystem::update(float deltaTime)
             alSourcei(audio->sourceId, AL_SOURCE_RELATIVE, AL_TRUE);
             alSource3f(audio->sourceId, AL_POSITION, 0.0f, 0.0f, 0.0f);
         }
+    });
+
+    // Spatial sources follow their world position only when it moved, which
+    // includes a parent moving them
+    const uint32_t movedSince = m_lastMoveTick;
+    m_lastMoveTick = m_world->advanceChangeTick();
+    m_sources.each([this, movedSince](ECS::EntityID entity, ECS::AudioSource& audio) {
+        if (!audio.isLoaded || !audio.spatial) return;
+        if (m_transforms->changeTick(entity) <= movedSince) return;
+
+        const QVector3D position = m_transforms->worldPosition(entity);
+        alSource3f(audio.sourceId, AL_POSITION,
+            position.x(),
+            position.y(),
+            position.z());
+    });
+
+    m_sources.each([](ECS::AudioSource& source) {
+        ECS::AudioSource* audio = &source;
+        if (!audio->isLoaded) return;
 
         if (audio->isPlaying) {
             ALint state;
@@ -125,7 +157,7 @@ void AudioSystem::update(float deltaTime)
             audio->isPlaying = true;
             audio->playOnStart = false;
         }
-    }
+    });
 }
 
 void AudioSystem::playSound(ECS::EntityID entity)
@@ -161,6 +193,31 @@ void AudioSystem::pauseSound(ECS::EntityID entity)
     audio->isPlaying = false;
 }
 
+void AudioSystem::acquireSource(ECS::AudioSource& audio)
+{
+    // Handles in a new component were copied from another one, e.g. a
+    // snapshot, and belong to it
+    audio.sourceId = 0;
+    audio.bufferId = 0;
+    audio.isLoaded = false;
+    audio.isPlaying = false;
+
+    if (!audio.filePath.isEmpty()) {
+        loadAudioFile(&audio);
+    }
+}
+
+void AudioSystem::releaseSource(const ECS::AudioSource& audio)
+{
+    if (audio.sourceId) {
+        alSourceStop(audio.sourceId);
+        alDeleteSources(1, &audio.sourceId);
+    }
+    if (audio.bufferId) {
+        alDeleteBuffers(1, &audio.bufferId);
+    }
+}
+
 bool AudioSystem::loadAudioFile(ECS::AudioSource* source)
 {
     if (!m_initialized || !source) return false;
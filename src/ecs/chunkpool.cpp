@@ -0,0 +1,52 @@
+#include "ecs/chunkpool.h"
+#include <new>
+
+namespace DabozzEngine {
+namespace ECS {
+
+ChunkPool::~ChunkPool()
+{
+    trim();
+}
+
+void* ChunkPool::allocate(size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.liveBytes += bytes;
+
+    auto it = m_freeBlocks.find(bytes);
+    if (it != m_freeBlocks.end() && !it->second.empty()) {
+        void* block = it->second.back();
+        it->second.pop_back();
+        m_stats.cachedBytes -= bytes;
+        ++m_stats.reuses;
+        return block;
+    }
+
+    ++m_stats.heapAllocations;
+    return ::operator new(bytes, std::align_val_t(CHUNK_ALIGNMENT));
+}
+
+void ChunkPool::release(void* block, size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.liveBytes -= bytes;
+    m_stats.cachedBytes += bytes;
+    m_freeBlocks[bytes].push_back(block);
+}
+
+void ChunkPool::trim()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& [bytes, blocks] : m_freeBlocks) {
+        for (void* block : blocks) {
+            ::operator delete(block, std::align_val_t(CHUNK_ALIGNMENT));
+            ++m_stats.heapFrees;
+        }
+        m_stats.cachedBytes -= bytes * blocks.size();
+    }
+    m_freeBlocks.clear();
+}
+
+}
+}
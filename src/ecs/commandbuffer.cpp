@@ -0,0 +1,127 @@
+#include "ecs/commandbuffer.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+namespace DabozzEngine {
+namespace ECS {
+
+CommandBuffer::CommandBuffer(World* world)
+    : m_world(world)
+{
+}
+
+EntityID CommandBuffer::createEntity()
+{
+    return m_world->reserveEntity();
+}
+
+void CommandBuffer::destroyEntity(EntityID entity)
+{
+    Command command;
+    command.type = CommandType::Destroy;
+    command.entity = entity;
+    localStream().commands.push_back(std::move(command));
+}
+
+EntityID CommandBuffer::instantiate(std::shared_ptr<const Prefab> prefab)
+{
+    const size_t count = prefab ? prefab->entityCount() : 0;
+    if (count == 0) return INVALID_ENTITY;
+
+    auto pending = std::make_unique<PendingInstance>();
+    pending->entities.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        pending->entities.push_back(m_world->reserveEntity());
+    }
+    pending->prefab = std::move(prefab);
+    const EntityID root = pending->entities.front();
+
+    Command command;
+    command.type = CommandType::Instantiate;
+    command.entity = root;
+    command.component = std::move(pending);
+    localStream().commands.push_back(std::move(command));
+    return root;
+}
+
+void CommandBuffer::playback()
+{
+    m_world->flushReservedEntities();
+
+    const size_t streamCount = std::min(m_streamCount.load(std::memory_order_acquire), MAX_RECORDING_THREADS);
+    for (size_t i = 0; i < streamCount; ++i) {
+        for (Command& command : m_streams[i].commands) {
+            switch (command.type) {
+            case CommandType::Destroy:
+                m_world->destroyEntity(command.entity);
+                break;
+            case CommandType::Add:
+            case CommandType::Instantiate:
+                command.component->apply(*m_world, command.entity);
+                break;
+            case CommandType::Remove:
+                command.remove(*m_world, command.entity);
+                break;
+            }
+        }
+        m_streams[i].commands.clear();
+    }
+    releaseStreams(streamCount);
+}
+
+void CommandBuffer::clear()
+{
+    m_world->flushReservedEntities();
+
+    const size_t streamCount = std::min(m_streamCount.load(std::memory_order_acquire), MAX_RECORDING_THREADS);
+    for (size_t i = 0; i < streamCount; ++i) {
+        m_streams[i].commands.clear();
+    }
+    releaseStreams(streamCount);
+}
+
+void CommandBuffer::releaseStreams(size_t streamCount)
+{
+    // Nothing is recording, so the next threads to record claim streams
+    // afresh. Threads that come and go, like a game loop started on every
+    // Play, would otherwise use them all up. The command vectors keep
+    // their capacity.
+    for (size_t i = 0; i < streamCount; ++i) {
+        m_streams[i].owner.store(std::thread::id(), std::memory_order_relaxed);
+    }
+    m_streamCount.store(0, std::memory_order_release);
+}
+
+bool CommandBuffer::empty() const
+{
+    const size_t streamCount = std::min(m_streamCount.load(std::memory_order_acquire), MAX_RECORDING_THREADS);
+    for (size_t i = 0; i < streamCount; ++i) {
+        if (!m_streams[i].commands.empty()) return false;
+    }
+    return true;
+}
+
+CommandBuffer::Stream& CommandBuffer::localStream()
+{
+    const std::thread::id self = std::this_thread::get_id();
+
+    const size_t streamCount = std::min(m_streamCount.load(std::memory_order_acquire), MAX_RECORDING_THREADS);
+    for (size_t i = 0; i < streamCount; ++i) {
+        if (m_streams[i].owner.load(std::memory_order_acquire) == self) {
+            return m_streams[i];
+        }
+    }
+
+    // First command from this thread: claim the next free stream
+    size_t slot = m_streamCount.fetch_add(1, std::memory_order_acq_rel);
+    if (slot >= MAX_RECORDING_THREADS) {
+        std::cerr << "ECS: more than " << MAX_RECORDING_THREADS << " threads recording into one CommandBuffer" << std::endl;
+        std::abort();
+    }
+    m_streams[slot].owner.store(self, std::memory_order_release);
+    return m_streams[slot];
+}
+
+}
+}
@@ -0,0 +1,93 @@
+#include "ecs/gameloop.h"
+#include "jobs/jobsystem.h"
+#include <algorithm>
+
+namespace DabozzEngine {
+namespace ECS {
+
+GameLoop::GameLoop(StepFunction step, float stepSeconds, int maxStepsPerFrame)
+    : m_step(std::move(step))
+    , m_stepSeconds(stepSeconds)
+    , m_stepDuration(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(stepSeconds)))
+    , m_maxStepsPerFrame(std::max(maxStepsPerFrame, 1))
+{
+}
+
+GameLoop::~GameLoop()
+{
+    stop();
+}
+
+void GameLoop::start()
+{
+    if (isRunning()) return;
+
+    m_stopping = false;
+    m_simulatedUntil.store(Clock::now().time_since_epoch().count());
+    m_thread = std::thread(&GameLoop::run, this);
+}
+
+void GameLoop::stop()
+{
+    if (!isRunning()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_stopMutex);
+        m_stopping = true;
+    }
+    m_stopSignal.notify_one();
+    m_thread.join();
+}
+
+float GameLoop::interpolationAlpha() const
+{
+    const Clock::time_point simulatedUntil{Clock::duration(m_simulatedUntil.load())};
+    const float alpha = std::chrono::duration<float>(Clock::now() - simulatedUntil).count() / m_stepSeconds;
+    return std::clamp(alpha, 0.0f, 1.0f);
+}
+
+void GameLoop::run()
+{
+    Jobs::JobSystem& jobs = Jobs::JobSystem::instance();
+    const std::thread::id previousMainThread = jobs.setMainThread(std::this_thread::get_id());
+
+    Clock::time_point simulatedUntil{Clock::duration(m_simulatedUntil.load())};
+
+    std::unique_lock<std::mutex> stopLock(m_stopMutex);
+    while (!m_stopping) {
+        stopLock.unlock();
+
+        const Clock::time_point now = Clock::now();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            int steps = 0;
+            while (now - simulatedUntil >= m_stepDuration && steps < m_maxStepsPerFrame) {
+                m_step(m_stepSeconds);
+                simulatedUntil += m_stepDuration;
+                ++steps;
+            }
+
+            // Spiral of death guard: whatever is still owed can't be caught
+            // up on, so let it go
+            if (now - simulatedUntil >= m_stepDuration) {
+                const auto behind = (now - simulatedUntil) / m_stepDuration;
+                simulatedUntil += behind * m_stepDuration;
+                m_droppedSteps.fetch_add(static_cast<uint64_t>(behind), std::memory_order_relaxed);
+            }
+
+            m_stepCount.fetch_add(static_cast<uint64_t>(steps), std::memory_order_relaxed);
+            m_simulatedUntil.store(simulatedUntil.time_since_epoch().count());
+        }
+
+        // Sleep until the next step is due
+        stopLock.lock();
+        m_stopSignal.wait_until(stopLock, simulatedUntil + m_stepDuration, [this] { return m_stopping; });
+    }
+    stopLock.unlock();
+
+    jobs.setMainThread(previousMainThread);
+}
+
+}
+}
@@ -0,0 +1,106 @@
+#include "ecs/nameindex.h"
+#include <algorithm>
+
+namespace DabozzEngine {
+namespace ECS {
+
+NameIndex::NameIndex(World* world)
+    : m_world(world)
+    , m_changedNames(View<const Name>(world).changed<Name>())
+{
+    if (m_world) {
+        m_nameRemoved = m_world->onRemove<Name>([this](EntityID entity, const Name&) { erase(entity); });
+    }
+}
+
+NameIndex::~NameIndex()
+{
+    if (m_world) {
+        m_world->removeObserver(m_nameRemoved);
+    }
+}
+
+EntityID NameIndex::find(const QString& name)
+{
+    refresh();
+
+    auto it = m_entities.find(name);
+    return it != m_entities.end() ? it->second : INVALID_ENTITY;
+}
+
+std::vector<EntityID> NameIndex::findAll(const QString& name)
+{
+    refresh();
+
+    std::vector<EntityID> result;
+    auto range = m_entities.equal_range(name);
+    for (auto it = range.first; it != range.second; ++it) {
+        result.push_back(it->second);
+    }
+    return result;
+}
+
+std::vector<EntityID> NameIndex::findByPrefix(const QString& prefix)
+{
+    refresh();
+
+    if (m_sortedDirty) {
+        m_sorted.clear();
+        m_sorted.reserve(m_names.size());
+        for (const auto& entry : m_names) {
+            m_sorted.emplace_back(entry.second.toCaseFolded(), entry.first);
+        }
+        std::sort(m_sorted.begin(), m_sorted.end());
+        m_sortedDirty = false;
+    }
+
+    // Names sharing the prefix sort right after it
+    const QString folded = prefix.toCaseFolded();
+    std::vector<EntityID> result;
+    auto it = std::lower_bound(m_sorted.begin(), m_sorted.end(), std::make_pair(folded, INVALID_ENTITY));
+    for (; it != m_sorted.end() && it->first.startsWith(folded); ++it) {
+        result.push_back(it->second);
+    }
+    return result;
+}
+
+void NameIndex::refresh()
+{
+    if (!m_world) return;
+
+    m_changedNames.each([this](EntityID entity, const Name& name) {
+        auto it = m_names.find(entity);
+        if (it != m_names.end()) {
+            if (it->second == name.name) return;
+            erase(entity);
+        }
+        insert(entity, name.name);
+    });
+}
+
+void NameIndex::insert(EntityID entity, const QString& name)
+{
+    m_entities.emplace(name, entity);
+    m_names.emplace(entity, name);
+    m_sortedDirty = true;
+}
+
+void NameIndex::erase(EntityID entity)
+{
+    auto it = m_names.find(entity);
+    if (it == m_names.end()) return;
+
+    auto range = m_entities.equal_range(it->second);
+    for (auto entry = range.first; entry != range.second; ++entry) {
+        if (entry->second == entity) {
+            m_entities.erase(entry);
+            break;
+        }
+    }
+
+    m_names.erase(it);
+    m_sortedDirty = true;
+}
+
+}
+}
@@ -0,0 +1,145 @@
+#include "ecs/prefab.h"
+#include <algorithm>
+
+namespace DabozzEngine {
+namespace ECS {
+
+Prefab::Prefab(const World& source, EntityID root)
+{
+    if (!source.hasEntity(root)) return;
+
+    // root and everything below it
+    std::vector<EntityID> sources{ root };
+    for (size_t i = 0; i < sources.size(); ++i) {
+        if (const Hierarchy* hierarchy = source.getComponent<Hierarchy>(sources[i])) {
+            for (EntityID child : hierarchy->children) {
+                if (source.hasEntity(child) && std::find(sources.begin(), sources.end(), child) == sources.end()) {
+                    sources.push_back(child);
+                }
+            }
+        }
+    }
+
+    std::unordered_map<EntityID, EntityID> templates;
+    for (EntityID entity : sources) {
+        templates[entity] = m_world.cloneEntity(source, entity);
+    }
+
+    auto remap = [&](EntityID entity) {
+        auto it = templates.find(entity);
+        return it != templates.end() ? it->second : EntityID(0);
+    };
+
+    for (const auto& [entity, copy] : templates) {
+        if (Hierarchy* hierarchy = m_world.getComponent<Hierarchy>(copy)) {
+            hierarchy->parent = entity == root ? 0 : remap(hierarchy->parent);
+            std::vector<EntityID> children;
+            for (EntityID child : hierarchy->children) {
+                if (EntityID mapped = remap(child)) children.push_back(mapped);
+            }
+            hierarchy->children = std::move(children);
+        }
+    }
+}
+
+EntityID Prefab::instantiate(World& target) const
+{
+    const Layout templates = layout();
+    if (templates.order.empty()) return INVALID_ENTITY;
+
+    std::vector<EntityID> entities = target.createEntities(templates.order.size());
+    if (entities.size() < templates.order.size()) {
+        target.destroyEntities(entities);
+        return INVALID_ENTITY;
+    }
+
+    instantiateInto(target, templates, entities.data());
+    return entities.front();
+}
+
+std::vector<EntityID> Prefab::instantiate(World& target, size_t count) const
+{
+    std::vector<EntityID> roots;
+    const Layout templates = layout();
+    const size_t size = templates.order.size();
+    if (size == 0 || count == 0) return roots;
+
+    std::vector<EntityID> entities = target.createEntities(size * count);
+
+    // Only whole instances if the index space ran out
+    const size_t instances = entities.size() / size;
+    if (instances * size < entities.size()) {
+        target.destroyEntities(entities.data() + instances * size, entities.size() - instances * size);
+    }
+
+    roots.reserve(instances);
+    for (size_t i = 0; i < instances; ++i) {
+        instantiateInto(target, templates, entities.data() + i * size);
+        roots.push_back(entities[i * size]);
+    }
+    return roots;
+}
+
+void Prefab::instantiateInto(World& target, const EntityID* entities) const
+{
+    instantiateInto(target, layout(), entities);
+}
+
+Prefab::Layout Prefab::layout() const
+{
+    Layout result;
+    const std::vector<EntityID>& entities = m_world.getEntities();
+    result.order.reserve(entities.size());
+
+    auto place = [&](EntityID entity) {
+        if (result.slots.emplace(entity, result.order.size()).second) {
+            result.order.push_back(entity);
+        }
+    };
+
+    for (EntityID entity : entities) {
+        const Hierarchy* hierarchy = m_world.getComponent<Hierarchy>(entity);
+        if (!hierarchy || !m_world.hasEntity(hierarchy->parent)) {
+            place(entity);
+        }
+    }
+
+    // Breadth first, so parents always come before their children
+    for (size_t i = 0; i < result.order.size(); ++i) {
+        if (const Hierarchy* hierarchy = m_world.getComponent<Hierarchy>(result.order[i])) {
+            for (EntityID child : hierarchy->children) {
+                if (m_world.hasEntity(child)) place(child);
+            }
+        }
+    }
+
+    // Anything only reachable through a parent cycle
+    for (EntityID entity : entities) {
+        place(entity);
+    }
+    return result;
+}
+
+void Prefab::instantiateInto(World& target, const Layout& layout, const EntityID* entities) const
+{
+    auto remap = [&](EntityID entity) {
+        auto it = layout.slots.find(entity);
+        return it != layout.slots.end() ? entities[it->second] : EntityID(0);
+    };
+
+    for (size_t i = 0; i < layout.order.size(); ++i) {
+        target.cloneInto(m_world, layout.order[i], entities[i]);
+
+        if (Hierarchy* hierarchy = target.getComponent<Hierarchy>(entities[i])) {
+            hierarchy->parent = remap(hierarchy->parent);
+            for (EntityID& child : hierarchy->children) {
+                child = remap(child);
+            }
+            hierarchy->children.erase(std::remove(hierarchy->children.begin(), hierarchy->children.end(), EntityID(0)),
+                                      hierarchy->children.end());
+        }
+    }
+}
+
+}
+}
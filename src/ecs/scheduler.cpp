@@ -0,0 +1,114 @@
+#include "ecs/scheduler.h"
+#include "jobs/jobsystem.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+namespace DabozzEngine {
+namespace ECS {
+
+bool Scheduler::SystemDesc::conflictsWith(const SystemDesc& other) const
+{
+    if (m_exclusive || other.m_exclusive) return true;
+
+    return (m_writes & (other.m_reads | other.m_writes)).any()
+        || (other.m_writes & m_reads).any();
+}
+
+bool Scheduler::SystemDesc::runsAfter(const SystemDesc& other) const
+{
+    return std::find(m_after.begin(), m_after.end(), other.m_name) != m_after.end();
+}
+
+Scheduler::SystemDesc& Scheduler::addSystem(const std::string& name, SystemFunction function)
+{
+    auto system = std::make_unique<SystemDesc>();
+    system->m_name = name;
+    system->m_function = std::move(function);
+    m_systems.push_back(std::move(system));
+    m_graphDirty = true;
+    return *m_systems.back();
+}
+
+void Scheduler::buildGraph()
+{
+    for (auto& system : m_systems) {
+        system->m_dependents.clear();
+        system->m_dependencyCount = 0;
+    }
+
+    // Earlier registration wins, which keeps the graph acyclic
+    for (size_t later = 0; later < m_systems.size(); ++later) {
+        for (size_t earlier = 0; earlier < later; ++earlier) {
+            if (m_systems[later]->conflictsWith(*m_systems[earlier])
+                || m_systems[later]->runsAfter(*m_systems[earlier])) {
+                m_systems[earlier]->m_dependents.push_back(later);
+                ++m_systems[later]->m_dependencyCount;
+            }
+        }
+    }
+
+    m_graphDirty = false;
+}
+
+void Scheduler::run(float deltaTime)
+{
+    using Clock = std::chrono::steady_clock;
+
+    if (m_graphDirty) buildGraph();
+    if (m_systems.empty()) return;
+
+    const Clock::time_point frameStart = Clock::now();
+
+    Jobs::JobSystem& jobs = Jobs::JobSystem::instance();
+    Jobs::JobCounter frame;
+    std::unique_ptr<std::atomic<size_t>[]> pending(new std::atomic<size_t>[m_systems.size()]);
+
+    // Each finished system releases its dependents; the last dependency to
+    // finish queues the dependent
+    std::function<void(size_t)> launch = [&](size_t index) {
+        const Jobs::JobAffinity affinity = m_systems[index]->m_mainThread
+            ? Jobs::JobAffinity::MainThread
+            : Jobs::JobAffinity::Any;
+
+        jobs.submit([&, index, deltaTime] {
+            SystemDesc& system = *m_systems[index];
+            const Clock::time_point start = Clock::now();
+            system.m_function(deltaTime);
+            system.m_lastMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            system.m_averageMs = system.m_averageMs == 0.0
+                ? system.m_lastMs
+                : system.m_averageMs * 0.9 + system.m_lastMs * 0.1;
+
+            for (size_t dependent : system.m_dependents) {
+                if (pending[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    launch(dependent);
+                }
+            }
+        }, &frame, affinity);
+    };
+
+    for (size_t i = 0; i < m_systems.size(); ++i) {
+        pending[i].store(m_systems[i]->m_dependencyCount, std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < m_systems.size(); ++i) {
+        if (m_systems[i]->m_dependencyCount == 0) launch(i);
+    }
+
+    jobs.wait(frame);
+
+    m_lastFrameMs = std::chrono::duration<double, std::milli>(Clock::now() - frameStart).count();
+}
+
+std::vector<Scheduler::SystemTiming> Scheduler::timings() const
+{
+    std::vector<SystemTiming> result;
+    result.reserve(m_systems.size());
+    for (const auto& system : m_systems) {
+        result.push_back({ system->m_name, system->m_lastMs, system->m_averageMs });
+    }
+    return result;
+}
+
+}
+}
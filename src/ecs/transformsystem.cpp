@@ -0,0 +1,461 @@
+#include "ecs/systems/transformsystem.h"
+#include <algorithm>
+#include <utility>
+
+namespace DabozzEngine {
+namespace Systems {
+
+TransformSystem::TransformSystem(ECS::World* world)
+    : m_world(world)
+    , m_transforms(world)
+    , m_changedTransforms(ECS::View<const ECS::Transform>(world).changed<ECS::Transform>())
+    , m_changedHierarchies(ECS::View<const ECS::Hierarchy>(world).changed<ECS::Hierarchy>())
+{
+    if (!m_world) return;
+
+    // Added Hierarchies show up in m_changedHierarchies
+    m_observers.push_back(m_world->onAdd<ECS::Transform>([this](ECS::EntityID entity, ECS::Transform&) { m_added.push_back(entity); }));
+    m_observers.push_back(m_world->onRemove<ECS::Transform>([this](ECS::EntityID entity, const ECS::Transform&) { m_removed.push_back(entity); }));
+    m_observers.push_back(m_world->onRemove<ECS::Hierarchy>([this](ECS::EntityID entity, const ECS::Hierarchy&) { m_reparented.push_back(entity); }));
+}
+
+TransformSystem::~TransformSystem()
+{
+    for (ECS::World::ObserverID observer : m_observers) {
+        m_world->removeObserver(observer);
+    }
+}
+
+void TransformSystem::update()
+{
+    if (!m_world) return;
+
+    // Both filters have to run every update to move their change ticks on
+    m_changedHierarchies.each([this](ECS::EntityID entity, const ECS::Hierarchy&) {
+        m_reparented.push_back(entity);
+    });
+
+    // Sorting from scratch is cheaper once most of the World came or went,
+    // e.g. after World::restore()
+    if (!m_built || m_added.size() + m_removed.size() > m_entities.size()) {
+        rebuild();
+    } else {
+        applyChanges();
+    }
+
+    m_changedTransforms.each([this](ECS::EntityID entity, const ECS::Transform&) {
+        uint32_t slot = slotOf(entity);
+        if (slot != NO_SLOT) {
+            m_dirty[slot] = 1;
+            m_anyDirty = true;
+        }
+    });
+
+    if (!m_anyDirty) return;
+
+    // Parents come first, so a dirty parent has already been recomputed and
+    // passes its flag on to its children
+    const uint32_t tick = m_world->changeTick();
+    for (size_t slot = 0; slot < m_entities.size(); ++slot) {
+        if (m_entities[slot] == ECS::INVALID_ENTITY) continue;
+
+        uint32_t parent = m_parents[slot];
+        if (parent != NO_SLOT && m_entities[parent] == ECS::INVALID_ENTITY) {
+            // The parent lost its Transform, so this is a root until it
+            // gets one back
+            m_parents[slot] = parent = NO_SLOT;
+            m_dirty[slot] = 1;
+            addOrphan(m_entities[slot]);
+        }
+        if (!m_dirty[slot] && (parent == NO_SLOT || !m_dirty[parent])) continue;
+
+        m_dirty[slot] = 1;
+        const ECS::Transform* transform = std::as_const(*m_world).getComponent<ECS::Transform>(m_entities[slot]);
+        const QMatrix4x4 local = transform->getModelMatrix();
+        m_worldMatrices[slot] = parent == NO_SLOT ? local : m_worldMatrices[parent] * local;
+        m_changeTicks[slot] = tick;
+    }
+
+    std::fill(m_dirty.begin(), m_dirty.end(), 0);
+    m_anyDirty = false;
+
+    if (m_releasedSlots > m_entities.size() / 2) {
+        compact();
+    }
+}
+
+const QMatrix4x4& TransformSystem::worldMatrix(ECS::EntityID entity) const
+{
+    static const QMatrix4x4 identity;
+
+    uint32_t slot = slotOf(entity);
+    return slot != NO_SLOT ? m_worldMatrices[slot] : identity;
+}
+
+uint32_t TransformSystem::changeTick(ECS::EntityID entity) const
+{
+    uint32_t slot = slotOf(entity);
+    return slot != NO_SLOT ? m_changeTicks[slot] : 0;
+}
+
+void TransformSystem::saveStep()
+{
+    update();
+
+    // Slots without steps yet start out standing still
+    m_previousStep.swap(m_lastStep);
+    m_lastStep = m_worldMatrices;
+    for (size_t slot = 0; slot < m_stepSaved.size(); ++slot) {
+        if (!m_stepSaved[slot]) {
+            m_previousStep[slot] = m_lastStep[slot];
+        }
+    }
+    std::fill(m_stepSaved.begin(), m_stepSaved.end(), 1);
+}
+
+void TransformSystem::setInterpolation(bool enabled, float alpha)
+{
+    m_interpolating = enabled;
+    m_alpha = alpha;
+}
+
+QMatrix4x4 TransformSystem::renderMatrix(ECS::EntityID entity) const
+{
+    uint32_t slot = slotOf(entity);
+    if (slot == NO_SLOT) return QMatrix4x4();
+    if (!m_interpolating || !m_stepSaved[slot]) return m_worldMatrices[slot];
+
+    // Blended element-wise; a step is short enough that rotations don't
+    // visibly shrink halfway
+    return m_previousStep[slot] * (1.0f - m_alpha) + m_lastStep[slot] * m_alpha;
+}
+
+void TransformSystem::rebuild()
+{
+    m_built = true;
+    m_added.clear();
+    m_removed.clear();
+    m_reparented.clear();
+    m_orphans.clear();
+    m_releasedSlots = 0;
+
+    // Saved steps follow their entities to the new slots
+    const std::vector<ECS::EntityID> oldEntities = std::move(m_entities);
+    const std::vector<uint32_t> oldSlots = std::move(m_slots);
+    const std::vector<QMatrix4x4> oldPrevious = std::move(m_previousStep);
+    const std::vector<QMatrix4x4> oldLast = std::move(m_lastStep);
+    const std::vector<uint8_t> oldSaved = std::move(m_stepSaved);
+    auto oldSlotOf = [&](ECS::EntityID entity) {
+        uint32_t index = ECS::entityIndex(entity);
+        if (index >= oldSlots.size()) return NO_SLOT;
+        uint32_t slot = oldSlots[index];
+        return slot < oldEntities.size() && oldEntities[slot] == entity ? slot : NO_SLOT;
+    };
+
+    // Gather every entity with a Transform, in archetype order for now
+    std::vector<ECS::EntityID> entities;
+    m_slots.clear();
+    m_transforms.each([&](ECS::EntityID entity, const ECS::Transform&) {
+        uint32_t index = ECS::entityIndex(entity);
+        if (index >= m_slots.size()) {
+            m_slots.resize(index + 1, NO_SLOT);
+        }
+        m_slots[index] = static_cast<uint32_t>(entities.size());
+        entities.push_back(entity);
+    });
+
+    auto gatheredSlot = [&](ECS::EntityID entity) {
+        uint32_t index = ECS::entityIndex(entity);
+        if (index >= m_slots.size()) return NO_SLOT;
+        uint32_t slot = m_slots[index];
+        return slot != NO_SLOT && entities[slot] == entity ? slot : NO_SLOT;
+    };
+
+    // A parent without a Transform contributes nothing, like a root
+    std::vector<uint32_t> parents(entities.size(), NO_SLOT);
+    std::vector<uint32_t> childCounts(entities.size() + 1, 0);
+    for (size_t i = 0; i < entities.size(); ++i) {
+        const ECS::Hierarchy* hierarchy = std::as_const(*m_world).getComponent<ECS::Hierarchy>(entities[i]);
+        if (!hierarchy || hierarchy->parent == ECS::INVALID_ENTITY) continue;
+
+        uint32_t parent = gatheredSlot(hierarchy->parent);
+        if (parent != NO_SLOT && parent != i) {
+            parents[i] = parent;
+            ++childCounts[parent + 1];
+        } else if (parent == NO_SLOT && m_world->hasEntity(hierarchy->parent)) {
+            m_orphans.push_back(entities[i]);
+        }
+    }
+
+    // Children of each entity, flattened
+    for (size_t i = 1; i < childCounts.size(); ++i) {
+        childCounts[i] += childCounts[i - 1];
+    }
+    std::vector<uint32_t> children(entities.size());
+    std::vector<uint32_t> cursor(childCounts.begin(), childCounts.end() - 1);
+    for (size_t i = 0; i < entities.size(); ++i) {
+        if (parents[i] != NO_SLOT) {
+            children[cursor[parents[i]]++] = static_cast<uint32_t>(i);
+        }
+    }
+
+    // Breadth-first from the roots; anything left over sits on a parent
+    // cycle and is treated as a root
+    std::vector<uint32_t> order;
+    std::vector<uint8_t> placed(entities.size(), 0);
+    order.reserve(entities.size());
+    for (size_t i = 0; i < entities.size(); ++i) {
+        if (parents[i] == NO_SLOT) {
+            order.push_back(static_cast<uint32_t>(i));
+            placed[i] = 1;
+        }
+    }
+    for (size_t next = 0; order.size() < entities.size(); ++next) {
+        if (next == order.size()) {
+            for (size_t i = 0; i < entities.size(); ++i) {
+                if (!placed[i]) {
+                    parents[i] = NO_SLOT;
+                    m_orphans.push_back(entities[i]);
+                    order.push_back(static_cast<uint32_t>(i));
+                    placed[i] = 1;
+                    break;
+                }
+            }
+        }
+
+        const uint32_t current = order[next];
+        for (uint32_t c = childCounts[current]; c < childCounts[current + 1]; ++c) {
+            if (!placed[children[c]]) {
+                order.push_back(children[c]);
+                placed[children[c]] = 1;
+            }
+        }
+    }
+
+    const size_t count = entities.size();
+    m_entities.resize(count);
+    m_parents.resize(count);
+    m_worldMatrices.resize(count);
+    m_changeTicks.assign(count, 0);
+    m_dirty.assign(count, 1);
+    m_anyDirty = count > 0;
+    m_previousStep.resize(count);
+    m_lastStep.resize(count);
+    m_stepSaved.assign(count, 0);
+
+    for (size_t slot = 0; slot < count; ++slot) {
+        m_entities[slot] = entities[order[slot]];
+        m_slots[ECS::entityIndex(m_entities[slot])] = static_cast<uint32_t>(slot);
+
+        const uint32_t old = oldSlotOf(m_entities[slot]);
+        if (old != NO_SLOT && oldSaved[old]) {
+            m_previousStep[slot] = oldPrevious[old];
+            m_lastStep[slot] = oldLast[old];
+            m_stepSaved[slot] = 1;
+        }
+    }
+    for (size_t slot = 0; slot < count; ++slot) {
+        const uint32_t parent = parents[order[slot]];
+        m_parents[slot] = parent == NO_SLOT ? NO_SLOT : m_slots[ECS::entityIndex(entities[parent])];
+    }
+}
+
+void TransformSystem::applyChanges()
+{
+    // Removals first, so a replaced Transform keeps its slot
+    for (ECS::EntityID entity : m_removed) {
+        uint32_t slot = slotOf(entity);
+        if (slot != NO_SLOT && !m_world->hasComponent<ECS::Transform>(entity)) {
+            release(slot);
+        }
+    }
+    for (ECS::EntityID entity : m_added) {
+        if (slotOf(entity) == NO_SLOT && m_world->hasComponent<ECS::Transform>(entity)) {
+            append(entity, parentSlotOf(entity));
+        }
+    }
+    for (ECS::EntityID entity : m_reparented) {
+        uint32_t slot = slotOf(entity);
+        if (slot == NO_SLOT) continue;
+
+        uint32_t parent = parentSlotOf(entity);
+        if (parent != m_parents[slot]) {
+            setParent(slot, parent);
+        }
+    }
+
+    // Children that got their Transform before their parent did, or whose
+    // parent cycle may have been broken
+    if ((!m_added.empty() || !m_reparented.empty()) && !m_orphans.empty()) {
+        adoptOrphans();
+    }
+
+    m_added.clear();
+    m_removed.clear();
+    m_reparented.clear();
+}
+
+void TransformSystem::adoptOrphans()
+{
+    // setParent() may orphan them again
+    std::vector<ECS::EntityID> orphans;
+    orphans.swap(m_orphans);
+    for (ECS::EntityID entity : orphans) {
+        const uint32_t slot = slotOf(entity);
+        const ECS::Hierarchy* hierarchy = std::as_const(*m_world).getComponent<ECS::Hierarchy>(entity);
+        if (slot == NO_SLOT || !hierarchy || hierarchy->parent == entity || !m_world->hasEntity(hierarchy->parent)) continue;
+
+        const uint32_t parent = slotOf(hierarchy->parent);
+        if (parent == NO_SLOT) {
+            addOrphan(entity);
+        } else if (parent != m_parents[slot]) {
+            setParent(slot, parent);
+        }
+    }
+}
+
+uint32_t TransformSystem::append(ECS::EntityID entity, uint32_t parent)
+{
+    const uint32_t slot = static_cast<uint32_t>(m_entities.size());
+    m_entities.push_back(entity);
+    m_parents.push_back(parent);
+    m_worldMatrices.emplace_back();
+    m_changeTicks.push_back(0);
+    m_dirty.push_back(1);
+    m_previousStep.emplace_back();
+    m_lastStep.emplace_back();
+    m_stepSaved.push_back(0);
+    m_anyDirty = true;
+
+    uint32_t index = ECS::entityIndex(entity);
+    if (index >= m_slots.size()) {
+        m_slots.resize(index + 1, NO_SLOT);
+    }
+    m_slots[index] = slot;
+    return slot;
+}
+
+void TransformSystem::release(uint32_t slot)
+{
+    // Its children notice in update() and become roots
+    m_slots[ECS::entityIndex(m_entities[slot])] = NO_SLOT;
+    m_entities[slot] = ECS::INVALID_ENTITY;
+    ++m_releasedSlots;
+    m_anyDirty = true;
+}
+
+void TransformSystem::setParent(uint32_t slot, uint32_t parent)
+{
+    m_dirty[slot] = 1;
+    m_anyDirty = true;
+    if (parent == NO_SLOT || parent < slot) {
+        m_parents[slot] = parent;
+        return;
+    }
+
+    // The new parent comes later. Descendants all sit after the slot, so
+    // one pass over the rest finds the subtree, in parent-first order.
+    const size_t end = m_entities.size();
+    std::vector<uint32_t> moved(end - slot, NO_SLOT);
+    std::vector<uint32_t> subtree{ slot };
+    moved[0] = 0;
+    for (size_t i = slot + 1; i < end; ++i) {
+        const uint32_t above = m_parents[i];
+        if (m_entities[i] != ECS::INVALID_ENTITY && above != NO_SLOT && above >= slot && moved[above - slot] != NO_SLOT) {
+            moved[i - slot] = 0;
+            subtree.push_back(static_cast<uint32_t>(i));
+        }
+    }
+
+    // Parented to its own descendant; like rebuild(), the cycle is cut here
+    // until it's broken
+    if (moved[parent - slot] != NO_SLOT) {
+        m_parents[slot] = NO_SLOT;
+        addOrphan(m_entities[slot]);
+        return;
+    }
+
+    // Move the subtree to the end, after the parent, keeping its matrices
+    // and saved steps
+    for (uint32_t old : subtree) {
+        const uint32_t above = old == slot ? parent : moved[m_parents[old] - slot];
+        const uint32_t to = append(m_entities[old], above);
+        m_worldMatrices[to] = m_worldMatrices[old];
+        m_changeTicks[to] = m_changeTicks[old];
+        m_previousStep[to] = m_previousStep[old];
+        m_lastStep[to] = m_lastStep[old];
+        m_stepSaved[to] = m_stepSaved[old];
+        m_dirty[to] = m_dirty[old];
+        moved[old - slot] = to;
+
+        m_entities[old] = ECS::INVALID_ENTITY;
+        ++m_releasedSlots;
+    }
+}
+
+uint32_t TransformSystem::parentSlotOf(ECS::EntityID entity)
+{
+    const ECS::Hierarchy* hierarchy = std::as_const(*m_world).getComponent<ECS::Hierarchy>(entity);
+    if (!hierarchy || hierarchy->parent == ECS::INVALID_ENTITY || hierarchy->parent == entity) return NO_SLOT;
+
+    // A parent without a Transform contributes nothing, like a root
+    const uint32_t parent = slotOf(hierarchy->parent);
+    if (parent == NO_SLOT && m_world->hasEntity(hierarchy->parent)) {
+        addOrphan(entity);
+    }
+    return parent;
+}
+
+void TransformSystem::addOrphan(ECS::EntityID entity)
+{
+    if (std::find(m_orphans.begin(), m_orphans.end(), entity) == m_orphans.end()) {
+        m_orphans.push_back(entity);
+    }
+}
+
+void TransformSystem::compact()
+{
+    // Parents come first, so theirs are renumbered by the time children
+    // look them up
+    std::vector<uint32_t> remap(m_entities.size(), NO_SLOT);
+    uint32_t count = 0;
+    for (size_t slot = 0; slot < m_entities.size(); ++slot) {
+        if (m_entities[slot] == ECS::INVALID_ENTITY) continue;
+
+        const uint32_t parent = m_parents[slot];
+        remap[slot] = count;
+        m_entities[count] = m_entities[slot];
+        m_parents[count] = parent == NO_SLOT ? NO_SLOT : remap[parent];
+        m_worldMatrices[count] = m_worldMatrices[slot];
+        m_changeTicks[count] = m_changeTicks[slot];
+        m_dirty[count] = m_dirty[slot];
+        m_previousStep[count] = m_previousStep[slot];
+        m_lastStep[count] = m_lastStep[slot];
+        m_stepSaved[count] = m_stepSaved[slot];
+        m_slots[ECS::entityIndex(m_entities[count])] = count;
+        ++count;
+    }
+
+    m_entities.resize(count);
+    m_parents.resize(count);
+    m_worldMatrices.resize(count);
+    m_changeTicks.resize(count);
+    m_dirty.resize(count);
+    m_previousStep.resize(count);
+    m_lastStep.resize(count);
+    m_stepSaved.resize(count);
+    m_releasedSlots = 0;
+}
+
+uint32_t TransformSystem::slotOf(ECS::EntityID entity) const
+{
+    uint32_t index = ECS::entityIndex(entity);
+    if (index >= m_slots.size()) return NO_SLOT;
+
+    uint32_t slot = m_slots[index];
+    if (slot == NO_SLOT || slot >= m_entities.size() || m_entities[slot] != entity) return NO_SLOT;
+    return slot;
+}
+
+} // namespace Systems
+} // namespace DabozzEngine
@@ -1,34 +1,622 @@
 #include "ecs/world.h"
+#include <cstdio>
+#include <utility>
 
 namespace DabozzEngine {
 namespace ECS {
 
+Archetype::Archetype(ComponentMask mask, std::vector<std::unique_ptr<ComponentColumn>> columns)
+    : m_mask(mask)
+    , m_columns(std::move(columns))
+{
+    m_columnIndex.fill(NO_COLUMN);
+    for (size_t i = 0; i < m_columns.size(); ++i) {
+        m_columnIndex[m_columns[i]->type()] = static_cast<uint8_t>(i);
+    }
+}
+
+EntityID Archetype::removeRow(size_t row)
+{
+    for (auto& column : m_columns) {
+        column->swapRemove(row);
+    }
+
+    size_t last = m_entities.size() - 1;
+    EntityID moved = INVALID_ENTITY;
+    if (row != last) {
+        moved = m_entities[last];
+        m_entities[row] = moved;
+    }
+    m_entities.pop_back();
+    return moved;
+}
+
 World::World()
-    : m_nextEntityID(1)
 {
+    // Slot 0 is never handed out so INVALID_ENTITY can't alias a live entity
+    m_records.resize(1);
+
+    auto empty = std::make_unique<Archetype>(ComponentMask(), std::vector<std::unique_ptr<ComponentColumn>>());
+    m_emptyArchetype = empty.get();
+    m_archetypeIndex.emplace(ComponentMask(), m_emptyArchetype);
+    m_archetypes.push_back(std::move(empty));
 }
 
 World::~World()
 {
-    for (EntityID entity : m_entities) {
-        destroyEntity(entity);
-    }
+    // Archetype columns destroy their components
 }
 
 EntityID World::createEntity()
 {
-    EntityID entity = m_nextEntityID++;
-    m_entities.push_back(entity);
+    flushReservedEntities();
+
+    uint32_t index = allocateIndex();
+    if (index == 0) return INVALID_ENTITY;
+
+    return createAt(index);
+}
+
+EntityID World::reviveEntity(EntityID entity)
+{
+    uint32_t index = entityIndex(entity);
+    if (index == 0) return INVALID_ENTITY;
+
+    flushReservedEntities();
+
+    if (index >= m_records.size()) {
+        // Slots skipped over become free; the revived one is taken directly
+        while (index > m_records.size()) {
+            m_freeIndices.push_back(static_cast<uint32_t>(m_records.size()));
+            m_records.emplace_back();
+        }
+        m_records.emplace_back();
+    } else {
+        if (m_records[index].dense != INVALID_DENSE_INDEX) return INVALID_ENTITY;
+
+        // Keep the free list free of live slots so reservations can index it
+        auto it = std::find(m_freeIndices.begin(), m_freeIndices.end(), index);
+        if (it != m_freeIndices.end()) {
+            m_freeIndices.erase(it);
+        }
+    }
+
+    EntityRecord& record = m_records[index];
+    record.generation = entityGeneration(entity);
+    if (record.nextGeneration == record.generation) {
+        record.nextGeneration = (record.generation + 1) & ENTITY_GENERATION_MASK;
+    }
+
+    attachEntity(entity);
     return entity;
 }
 
 void World::destroyEntity(EntityID entity)
 {
-    auto it = std::find(m_entities.begin(), m_entities.end(), entity);
-    if (it != m_entities.end()) {
-        m_entities.erase(it);
-        m_components.erase(entity);
+    flushReservedEntities();
+    if (!hasEntity(entity)) return;
+
+    uint32_t index = entityIndex(entity);
+    EntityRecord& record = m_records[index];
+
+    if ((record.archetype->mask() & m_removeObserved).any()) {
+        notifyRemoveRow(*record.archetype, record.row);
+    }
+
+    EntityID moved = record.archetype->removeRow(record.row);
+    if (moved != INVALID_ENTITY) {
+        m_records[entityIndex(moved)].row = record.row;
+    }
+
+    // Swap-remove from the dense array
+    EntityID last = m_entities.back();
+    m_entities[record.dense] = last;
+    m_records[entityIndex(last)].dense = record.dense;
+    m_entities.pop_back();
+
+    record.dense = INVALID_DENSE_INDEX;
+    record.archetype = nullptr;
+    record.row = 0;
+    m_freeIndices.push_back(index);
+    ++m_structureVersion;
+}
+
+std::vector<EntityID> World::createEntities(size_t count)
+{
+    flushReservedEntities();
+
+    std::vector<EntityID> created;
+    created.reserve(count);
+    m_entities.reserve(m_entities.size() + count);
+    m_emptyArchetype->m_entities.reserve(m_emptyArchetype->m_entities.size() + count);
+    if (count > m_freeIndices.size()) {
+        m_records.reserve(m_records.size() + count - m_freeIndices.size());
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t index = allocateIndex();
+        if (index == 0) break;
+        created.push_back(createAt(index));
+    }
+    return created;
+}
+
+void World::destroyEntities(const EntityID* entities, size_t count)
+{
+    // Each removal swaps the last row into the hole, which moves fewer
+    // components than compacting would. Emptying the World is clear()'s job.
+    for (size_t i = 0; i < count; ++i) {
+        destroyEntity(entities[i]);
+    }
+}
+
+void World::clear()
+{
+    flushReservedEntities();
+    if (m_entities.empty()) return;
+
+    if (m_removeObserved.any()) {
+        notifyRemoveAll();
+    }
+
+    for (auto& archetype : m_archetypes) {
+        for (auto& column : archetype->m_columns) {
+            column->clear();
+        }
+        archetype->m_entities.clear();
+    }
+
+    // Slots are freed in index order, like a fresh World hands them out
+    for (size_t index = 1; index < m_records.size(); ++index) {
+        EntityRecord& record = m_records[index];
+        if (record.dense == INVALID_DENSE_INDEX) continue;
+
+        record.dense = INVALID_DENSE_INDEX;
+        record.archetype = nullptr;
+        record.row = 0;
+        m_freeIndices.push_back(static_cast<uint32_t>(index));
+    }
+    m_entities.clear();
+    ++m_structureVersion;
+}
+
+EntityID World::reserveEntity()
+{
+    uint32_t n = m_reservedCount.fetch_add(1, std::memory_order_relaxed);
+    if (n < m_freeIndices.size()) {
+        uint32_t index = m_freeIndices[n];
+        return makeEntityID(index, m_records[index].nextGeneration);
+    }
+
+    size_t index = m_records.size() + (n - m_freeIndices.size());
+    if (index > ENTITY_INDEX_MASK) return INVALID_ENTITY;
+
+    return makeEntityID(static_cast<uint32_t>(index), 0);
+}
+
+void World::flushReservedEntities()
+{
+    uint32_t reserved = m_reservedCount.exchange(0, std::memory_order_relaxed);
+
+    // Same order reserveEntity handed the handles out in
+    for (uint32_t i = 0; i < reserved; ++i) {
+        uint32_t index = allocateIndex();
+        if (index == 0) break;
+        createAt(index);
+    }
+}
+
+uint32_t World::allocateIndex()
+{
+    // FIFO reuse spreads generation bumps over all free slots
+    if (!m_freeIndices.empty()) {
+        uint32_t index = m_freeIndices.front();
+        m_freeIndices.pop_front();
+        return index;
+    }
+
+    if (m_records.size() > ENTITY_INDEX_MASK) return 0;
+
+    m_records.emplace_back();
+    return static_cast<uint32_t>(m_records.size() - 1);
+}
+
+EntityID World::createAt(uint32_t index)
+{
+    EntityRecord& record = m_records[index];
+    record.generation = record.nextGeneration;
+    record.nextGeneration = (record.nextGeneration + 1) & ENTITY_GENERATION_MASK;
+
+    EntityID entity = makeEntityID(index, record.generation);
+    attachEntity(entity);
+    return entity;
+}
+
+void World::attachEntity(EntityID entity)
+{
+    EntityRecord& record = m_records[entityIndex(entity)];
+    record.dense = static_cast<uint32_t>(m_entities.size());
+    m_entities.push_back(entity);
+
+    m_emptyArchetype->m_entities.push_back(entity);
+    record.archetype = m_emptyArchetype;
+    record.row = m_emptyArchetype->m_entities.size() - 1;
+    ++m_structureVersion;
+}
+
+std::vector<std::pair<ComponentTypeID, Component*>> World::getComponents(EntityID entity)
+{
+    std::vector<std::pair<ComponentTypeID, Component*>> components;
+    if (!hasEntity(entity)) return components;
+
+    const EntityRecord& record = m_records[entityIndex(entity)];
+    components.reserve(record.archetype->m_columns.size());
+    for (auto& column : record.archetype->m_columns) {
+        components.emplace_back(column->type(), column->get(record.row));
+    }
+    return components;
+}
+
+EntityID World::cloneEntity(const World& source, EntityID entity)
+{
+    if (!source.hasEntity(entity)) return INVALID_ENTITY;
+
+    EntityID copy = createEntity();
+    if (copy != INVALID_ENTITY) {
+        cloneInto(source, entity, copy);
+    }
+    return copy;
+}
+
+bool World::cloneInto(const World& source, EntityID entity, EntityID target)
+{
+    if (!source.hasEntity(entity) || !hasEntity(target)) return false;
+    if (m_records[entityIndex(target)].archetype != m_emptyArchetype) return false;
+
+    const Archetype& sourceArchetype = *source.m_records[entityIndex(entity)].archetype;
+    const size_t sourceRow = source.m_records[entityIndex(entity)].row;
+    if (sourceArchetype.m_columns.empty()) return true;
+
+    // Same mask, so the same columns in the same order
+    Archetype* archetype = getOrCreateArchetype(sourceArchetype.m_mask, &sourceArchetype, nullptr);
+    moveEntity(target, archetype);
+
+    const uint32_t tick = changeTick();
+    for (size_t i = 0; i < archetype->m_columns.size(); ++i) {
+        archetype->m_columns[i]->copyAppend(*sourceArchetype.m_columns[i], sourceRow, tick);
+    }
+
+    if ((archetype->m_mask & m_addObserved).any()) {
+        const size_t row = m_records[entityIndex(target)].row;
+        for (auto& column : archetype->m_columns) {
+            if (m_addObserved.test(column->type())) {
+                notifyAdd(column->type(), target, *column->get(row));
+            }
+        }
+    }
+    return true;
+}
+
+World::Stats World::stats() const
+{
+    Stats result;
+    result.entityCount = m_entities.size();
+    result.entitySlots = m_records.size();
+    result.archetypeCount = m_archetypes.size();
+    result.pooledBytes = m_chunkPool.stats().cachedBytes;
+    result.bookkeepingBytes = m_entities.capacity() * sizeof(EntityID)
+        + m_records.capacity() * sizeof(EntityRecord)
+        + m_freeIndices.size() * sizeof(uint32_t);
+
+    std::array<ComponentStats, MAX_COMPONENT_TYPES> components;
+    ComponentMask present;
+    MemoryReport buffers;
+
+    for (const auto& archetype : m_archetypes) {
+        ArchetypeStats& stats = result.archetypes.emplace_back();
+        stats.mask = archetype->m_mask;
+        stats.entities = archetype->size();
+        stats.chunks = archetype->m_columns.empty() ? 0 : (stats.entities + ARCHETYPE_CHUNK_SIZE - 1) / ARCHETYPE_CHUNK_SIZE;
+        if (stats.entities == 0) ++result.emptyArchetypes;
+        result.bookkeepingBytes += sizeof(Archetype) + archetype->m_entities.capacity() * sizeof(EntityID);
+
+        for (const auto& column : archetype->m_columns) {
+            ComponentStats& type = components[column->type()];
+            present.set(column->type());
+            type.type = column->type();
+            type.name = column->typeName();
+            type.instances += column->size();
+            type.bytes += column->size() * column->componentSize();
+            type.reservedBytes += column->reservedBytes();
+
+            const size_t counted = buffers.totalBytes();
+            column->reportBuffers(buffers);
+            type.bufferBytes += buffers.totalBytes() - counted;
+
+            stats.bytes += column->size() * column->componentSize();
+            stats.reservedBytes += column->reservedBytes();
+            result.bookkeepingBytes += column->size() * sizeof(uint32_t);
+        }
+
+        result.componentBytes += stats.bytes;
+        result.reservedBytes += stats.reservedBytes;
+    }
+
+    for (ComponentTypeID type = 0; type < MAX_COMPONENT_TYPES; ++type) {
+        if (present.test(type)) result.components.push_back(components[type]);
+    }
+
+    result.bufferBytes = buffers.totalBytes();
+    result.buffers = buffers.buffers();
+    if (result.reservedBytes > 0) {
+        result.fragmentation = 1.0f - static_cast<float>(result.componentBytes) / result.reservedBytes;
+    }
+    return result;
+}
+
+static std::string formatBytes(size_t bytes)
+{
+    char text[32];
+    if (bytes >= 1024 * 1024) {
+        std::snprintf(text, sizeof(text), "%.1f MB", bytes / (1024.0 * 1024.0));
+    } else if (bytes >= 1024) {
+        std::snprintf(text, sizeof(text), "%.1f KB", bytes / 1024.0);
+    } else {
+        std::snprintf(text, sizeof(text), "%zu B", bytes);
+    }
+    return text;
+}
+
+std::string World::Stats::format() const
+{
+    std::string text;
+    char line[256];
+
+    std::snprintf(line, sizeof(line), "%zu entities (%zu slots), %zu archetypes (%zu empty)\n",
+                  entityCount, entitySlots, archetypeCount, emptyArchetypes);
+    text += line;
+    std::snprintf(line, sizeof(line), "%s total: %s in chunks (%s used, %.0f%% unused), %s pooled, %s in buffers, %s bookkeeping\n",
+                  formatBytes(totalBytes()).c_str(), formatBytes(reservedBytes).c_str(), formatBytes(componentBytes).c_str(),
+                  fragmentation * 100.0f, formatBytes(pooledBytes).c_str(), formatBytes(bufferBytes).c_str(),
+                  formatBytes(bookkeepingBytes).c_str());
+    text += line;
+
+    std::snprintf(line, sizeof(line), "\n%-24s %10s %12s %12s %12s\n", "Component", "Count", "Bytes", "Reserved", "Buffers");
+    text += line;
+    for (const ComponentStats& component : components) {
+        std::snprintf(line, sizeof(line), "%-24s %10zu %12s %12s %12s\n", component.name, component.instances,
+                      formatBytes(component.bytes).c_str(), formatBytes(component.reservedBytes).c_str(),
+                      formatBytes(component.bufferBytes).c_str());
+        text += line;
+    }
+
+    if (!buffers.empty()) {
+        std::snprintf(line, sizeof(line), "\n%-28s %10s %10s %12s\n", "Buffer", "Refs", "Distinct", "Bytes");
+        text += line;
+        for (const MemoryReport::Buffer& buffer : buffers) {
+            std::snprintf(line, sizeof(line), "%-28s %10zu %10zu %12s\n", buffer.name.c_str(), buffer.references,
+                          buffer.instances, formatBytes(buffer.bytes).c_str());
+            text += line;
+        }
+    }
+    return text;
+}
+
+World::Snapshot World::snapshot()
+{
+    flushReservedEntities();
+
+    Snapshot snapshot;
+    snapshot.m_world = this;
+    snapshot.m_archetypes.resize(m_archetypes.size());
+    for (size_t i = 0; i < m_archetypes.size(); ++i) {
+        Archetype& archetype = *m_archetypes[i];
+        Snapshot::ArchetypeState& state = snapshot.m_archetypes[i];
+        state.entities = archetype.m_entities;
+        state.columns.resize(archetype.m_columns.size());
+        for (size_t column = 0; column < archetype.m_columns.size(); ++column) {
+            archetype.m_columns[column]->share(state.columns[column]);
+        }
+    }
+
+    snapshot.m_entities = m_entities;
+    snapshot.m_records = m_records;
+    snapshot.m_freeIndices = m_freeIndices;
+    return snapshot;
+}
+
+void World::restore(const Snapshot& snapshot)
+{
+    if (snapshot.m_world != this) return;
+
+    m_reservedCount.store(0, std::memory_order_relaxed);
+
+    if (m_removeObserved.any()) {
+        notifyRemoveAll();
+    }
+
+    // Archetypes only ever get added, so the snapshot's are a prefix of ours;
+    // the ones created since are emptied
+    const uint32_t tick = changeTick();
+    for (size_t i = 0; i < m_archetypes.size(); ++i) {
+        Archetype& archetype = *m_archetypes[i];
+        if (i < snapshot.m_archetypes.size()) {
+            const Snapshot::ArchetypeState& state = snapshot.m_archetypes[i];
+            archetype.m_entities = state.entities;
+            for (size_t column = 0; column < archetype.m_columns.size(); ++column) {
+                archetype.m_columns[column]->adopt(state.columns[column], state.entities.size(), tick);
+            }
+        } else {
+            archetype.m_entities.clear();
+            for (auto& column : archetype.m_columns) {
+                column->clear();
+            }
+        }
+    }
+
+    // Generations keep counting from where they are now, so handles handed
+    // out since the snapshot can't come back to life. Slots created since
+    // become free.
+    std::vector<EntityRecord> records = snapshot.m_records;
+    std::deque<uint32_t> freeIndices = snapshot.m_freeIndices;
+    for (size_t index = 1; index < m_records.size(); ++index) {
+        if (index >= records.size()) {
+            records.emplace_back();
+            freeIndices.push_back(static_cast<uint32_t>(index));
+        }
+        records[index].nextGeneration = m_records[index].nextGeneration;
+    }
+
+    m_entities = snapshot.m_entities;
+    m_records = std::move(records);
+    m_freeIndices = std::move(freeIndices);
+    ++m_structureVersion;
+
+    if (m_addObserved.any()) {
+        notifyAddAll();
+    }
+}
+
+void World::removeObserver(ObserverID observer)
+{
+    auto matches = [observer](const auto& entry) { return entry.id == observer; };
+
+    for (ComponentTypeID type = 0; type < MAX_COMPONENT_TYPES; ++type) {
+        auto& added = m_addObservers[type];
+        added.erase(std::remove_if(added.begin(), added.end(), matches), added.end());
+        m_addObserved.set(type, !added.empty());
+
+        auto& removed = m_removeObservers[type];
+        removed.erase(std::remove_if(removed.begin(), removed.end(), matches), removed.end());
+        m_removeObserved.set(type, !removed.empty());
+    }
+}
+
+void World::notifyAdd(ComponentTypeID type, EntityID entity, Component& component)
+{
+    for (const auto& observer : m_addObservers[type]) {
+        observer.callback(entity, component);
+    }
+}
+
+void World::notifyRemove(ComponentTypeID type, EntityID entity, const Component& component)
+{
+    for (const auto& observer : m_removeObservers[type]) {
+        observer.callback(entity, component);
+    }
+}
+
+void World::notifyRemoveRow(const Archetype& archetype, size_t row)
+{
+    const EntityID entity = archetype.m_entities[row];
+    for (const auto& column : archetype.m_columns) {
+        if (m_removeObserved.test(column->type())) {
+            notifyRemove(column->type(), entity, *std::as_const(*column).get(row));
+        }
+    }
+}
+
+void World::notifyAddAll()
+{
+    for (auto& archetype : m_archetypes) {
+        if ((archetype->m_mask & m_addObserved).none()) continue;
+
+        for (auto& column : archetype->m_columns) {
+            if (!m_addObserved.test(column->type())) continue;
+
+            for (size_t row = 0; row < archetype->m_entities.size(); ++row) {
+                notifyAdd(column->type(), archetype->m_entities[row], *column->get(row));
+            }
+        }
+    }
+}
+
+void World::notifyRemoveAll()
+{
+    for (const auto& archetype : m_archetypes) {
+        if ((archetype->m_mask & m_removeObserved).none()) continue;
+
+        for (const auto& column : archetype->m_columns) {
+            if (!m_removeObserved.test(column->type())) continue;
+
+            for (size_t row = 0; row < archetype->m_entities.size(); ++row) {
+                notifyRemove(column->type(), archetype->m_entities[row], *std::as_const(*column).get(row));
+            }
+        }
+    }
+}
+
+Archetype* World::createAddEdge(Archetype* source, std::unique_ptr<ComponentColumn> column)
+{
+    ComponentTypeID type = column->type();
+
+    ComponentMask mask = source->m_mask;
+    mask.set(type);
+
+    Archetype* target = getOrCreateArchetype(mask, source, std::move(column));
+    source->m_addEdges[type] = target;
+    target->m_removeEdges[type] = source;
+    return target;
+}
+
+Archetype* World::createRemoveEdge(Archetype* source, ComponentTypeID type)
+{
+    ComponentMask mask = source->m_mask;
+    mask.reset(type);
+
+    Archetype* target = getOrCreateArchetype(mask, source, nullptr);
+    source->m_removeEdges[type] = target;
+    target->m_addEdges[type] = source;
+    return target;
+}
+
+Archetype* World::getOrCreateArchetype(const ComponentMask& mask,
+                                       const Archetype* source,
+                                       std::unique_ptr<ComponentColumn> extraColumn)
+{
+    auto it = m_archetypeIndex.find(mask);
+    if (it != m_archetypeIndex.end()) return it->second;
+
+    // Columns follow type ID order, cloned from the neighbouring archetype
+    std::vector<std::unique_ptr<ComponentColumn>> columns;
+    columns.reserve(mask.count());
+    for (ComponentTypeID type = 0; type < MAX_COMPONENT_TYPES; ++type) {
+        if (!mask.test(type)) continue;
+        if (extraColumn && extraColumn->type() == type) {
+            columns.push_back(std::move(extraColumn));
+            continue;
+        }
+        columns.push_back(source->m_columns[source->m_columnIndex[type]]->createEmpty(m_chunkPool));
+    }
+
+    auto archetype = std::make_unique<Archetype>(mask, std::move(columns));
+    Archetype* result = archetype.get();
+    m_archetypeIndex.emplace(mask, result);
+    m_archetypes.push_back(std::move(archetype));
+    return result;
+}
+
+void World::moveEntity(EntityID entity, Archetype* target)
+{
+    EntityRecord& record = m_records[entityIndex(entity)];
+    Archetype* source = record.archetype;
+    size_t row = record.row;
+
+    for (auto& column : source->m_columns) {
+        if (ComponentColumn* destination = target->column(column->type())) {
+            destination->moveAppend(*column, row);
+        }
+    }
+    target->m_entities.push_back(entity);
+
+    record.archetype = target;
+    record.row = target->m_entities.size() - 1;
+
+    EntityID moved = source->removeRow(row);
+    if (moved != INVALID_ENTITY) {
+        m_records[entityIndex(moved)].row = row;
     }
+    ++m_structureVersion;
 }
 
 }
@@ -205,6 +205,7 @@ void ComponentInspector::onTransformChanged()
         transform->position = newPos;
         transform->rotation = newRot;
         transform->scale = newScale;
+        m_world->markChanged<DabozzEngine::ECS::Transform>(m_selectedEntity);
     }
 
     m_prevPosition = newPos;
@@ -228,6 +229,7 @@ void ComponentInspector::onNameChanged()
         DabozzEngine::ECS::Name* nameComponent = m_world->getComponent<DabozzEngine::ECS::Name>(m_selectedEntity);
         if (nameComponent) {
             nameComponent->name = nameText;
+            m_world->markChanged<DabozzEngine::ECS::Name>(m_selectedEntity);
         } else {
             m_world->addComponent<DabozzEngine::ECS::Name>(m_selectedEntity, nameText);
         }
@@ -375,27 +377,27 @@ void ComponentInspector::updateComponentsList()
     
     // List all components on the selected entity
     auto components = m_world->getComponents(m_selectedEntity);
-    if (!components) return;
+    if (components.empty()) return;
     
-    for (const auto& [typeId, component] : *components) {
+    for (const auto& [typeId, component] : components) {
         QString displayName;
-        if (typeId == typeid(DabozzEngine::ECS::Transform)) {
+        if (typeId == DabozzEngine::ECS::componentTypeID<DabozzEngine::ECS::Transform>()) {
             displayName = "Transform";
-        } else if (typeId == typeid(DabozzEngine::ECS::Name)) {
+        } else if (typeId == DabozzEngine::ECS::componentTypeID<DabozzEngine::ECS::Name>()) {
             displayName = "Name";
-        } else if (typeId == typeid(DabozzEngine::ECS::RigidBody)) {
+        } else if (typeId == DabozzEngine::ECS::componentTypeID<DabozzEngine::ECS::RigidBody>()) {
             displayName = "RigidBody";
-        } else if (typeId == typeid(DabozzEngine::ECS::BoxCollider)) {
+        } else if (typeId == DabozzEngine::ECS::componentTypeID<DabozzEngine::ECS::BoxCollider>()) {
             displayName = "BoxCollider";
-        } else if (typeId == typeid(DabozzEngine::ECS::SphereCollider)) {
+        } else if (typeId == DabozzEngine::ECS::componentTypeID<DabozzEngine::ECS::SphereCollider>()) {
             displayName = "SphereCollider";
-        } else if (typeId == typeid(DabozzEngine::ECS::Mesh)) {
+        } else if (typeId == DabozzEngine::ECS::componentTypeID<DabozzEngine::ECS::Mesh>()) {
             displayName = "Mesh";
-        } else if (typeId == typeid(DabozzEngine::ECS::FirstPersonController)) {
+        } else if (typeId == DabozzEngine::ECS::componentTypeID<DabozzEngine::ECS::FirstPersonController>()) {
             displayName = "FirstPersonController";
-        } else if (typeId == typeid(DabozzEngine::ECS::Animator)) {
+        } else if (typeId == DabozzEngine::ECS::componentTypeID<DabozzEngine::ECS::Animator>()) {
             displayName = "Animator";
-        } else if (typeId == typeid(DabozzEngine::ECS::AudioSource)) {
+        } else if (typeId == DabozzEngine::ECS::componentTypeID<DabozzEngine::ECS::AudioSource>()) {
             displayName = "AudioSource";
         } else {
             displayName = QString::fromStdString(typeId.name());
@@ -404,9 +406,9 @@ void ComponentInspector::updateComponentsList()
         QGroupBox* componentGroup = new QGroupBox(displayName);
         QVBoxLayout* componentLayout = new QVBoxLayout(componentGroup);
 
-        bool isCoreComponent = (typeId == typeid(DabozzEngine::ECS::Transform) ||
-                                typeId == typeid(DabozzEngine::ECS::Name) ||
-                                typeId == typeid(DabozzEngine::ECS::Hierarchy));
+        bool isCoreComponent = (typeId == DabozzEngine::ECS::componentTypeID<DabozzEngine::ECS::Transform>() ||
+                                typeId == DabozzEngine::ECS::componentTypeID<DabozzEngine::ECS::Name>() ||
+                                typeId == DabozzEngine::ECS::componentTypeID<DabozzEngine::ECS::Hierarchy>());
 
         if (!isCoreComponent) {
             QPushButton* removeBtn = new QPushButton("X");
@@ -414,23 +416,23 @@ void ComponentInspector::updateComponentsList()
             removeBtn->setStyleSheet("QPushButton { color: red; font-weight: bold; border: none; }");
             removeBtn->setToolTip("Remove " + displayName);
 
-            std::type_index capturedType = typeId;
+            DabozzEngine::ECS::ComponentTypeID capturedType = typeId;
             DabozzEngine::ECS::EntityID entity = m_selectedEntity;
             connect(removeBtn, &QPushButton::clicked, this, [this, capturedType, entity]() {
                 if (!m_world || entity == 0) return;
-                if (capturedType == typeid(DabozzEngine::ECS::RigidBody))
+                if (capturedType == DabozzEngine::ECS::componentTypeID<DabozzEngine::ECS::RigidBody>())
                     m_world->removeComponent<DabozzEngine::ECS::RigidBody>(entity);
-                else if (capturedType == typeid(DabozzEngine::ECS::BoxCollider))
+                else if (capturedType == DabozzEngine::ECS::componentTypeID<DabozzEngine::ECS::BoxCollider>())
                     m_world->removeComponent<DabozzEngine::ECS::BoxCollider>(entity);
-                else if (capturedType == typeid(DabozzEngine::ECS::SphereCollider))
+                else if (capturedType == DabozzEngine::ECS::componentTypeID<DabozzEngine::ECS::SphereCollider>())
                     m_world->removeComponent<DabozzEngine::ECS::SphereCollider>(entity);
-                else if (capturedType == typeid(DabozzEngine::ECS::Mesh))
+                else if (capturedType == DabozzEngine::ECS::componentTypeID<DabozzEngine::ECS::Mesh>())
                     m_world->removeComponent<DabozzEngine::ECS::Mesh>(entity);
-                else if (capturedType == typeid(DabozzEngine::ECS::FirstPersonController))
+                else if (capturedType == DabozzEngine::ECS::componentTypeID<DabozzEngine::ECS::FirstPersonController>())
                     m_world->removeComponent<DabozzEngine::ECS::FirstPersonController>(entity);
-                else if (capturedType == typeid(DabozzEngine::ECS::Animator))
+                else if (capturedType == DabozzEngine::ECS::componentTypeID<DabozzEngine::ECS::Animator>())
                     m_world->removeComponent<DabozzEngine::ECS::Animator>(entity);
-                else if (capturedType == typeid(DabozzEngine::ECS::AudioSource))
+                else if (capturedType == DabozzEngine::ECS::componentTypeID<DabozzEngine::ECS::AudioSource>())
                     m_world->removeComponent<DabozzEngine::ECS::AudioSource>(entity);
                 updateUI();
             });
@@ -441,39 +443,39 @@ void ComponentInspector::updateComponentsList()
             componentLayout->addLayout(headerLayout);
         }
 
-        if (typeId == typeid(DabozzEngine::ECS::RigidBody)) {
-            DabozzEngine::ECS::RigidBody* rigidBody = static_cast<DabozzEngine::ECS::RigidBody*>(component.get());
+        if (typeId == DabozzEngine::ECS::componentTypeID<DabozzEngine::ECS::RigidBody>()) {
+            DabozzEngine::ECS::RigidBody* rigidBody = static_cast<DabozzEngine::ECS::RigidBody*>(component);
             if (rigidBody) {
                 componentLayout->addWidget(new QLabel(QString("Mass: %1").arg(rigidBody->mass)));
                 componentLayout->addWidget(new QLabel(QString("Static: %1").arg(rigidBody->isStatic ? "Yes" : "No")));
             }
-        } else if (typeId == typeid(DabozzEngine::ECS::BoxCollider)) {
-            DabozzEngine::ECS::BoxCollider* boxCollider = static_cast<DabozzEngine::ECS::BoxCollider*>(component.get());
+        } else if (typeId == DabozzEngine::ECS::componentTypeID<DabozzEngine::ECS::BoxCollider>()) {
+            DabozzEngine::ECS::BoxCollider* boxCollider = static_cast<DabozzEngine::ECS::BoxCollider*>(component);
             if (boxCollider) {
                 componentLayout->addWidget(new QLabel(QString("Size: %1, %2, %3")
                     .arg(boxCollider->size.x()).arg(boxCollider->size.y()).arg(boxCollider->size.z())));
             }
-        } else if (typeId == typeid(DabozzEngine::ECS::SphereCollider)) {
-            DabozzEngine::ECS::SphereCollider* sphereCollider = static_cast<DabozzEngine::ECS::SphereCollider*>(component.get());
+        } else if (typeId == DabozzEngine::ECS::componentTypeID<DabozzEngine::ECS::SphereCollider>()) {
+            DabozzEngine::ECS::SphereCollider* sphereCollider = static_cast<DabozzEngine::ECS::SphereCollider*>(component);
             if (sphereCollider) {
                 componentLayout->addWidget(new QLabel(QString("Radius: %1").arg(sphereCollider->radius)));
             }
-        } else if (typeId == typeid(DabozzEngine::ECS::Mesh)) {
-            DabozzEngine::ECS::Mesh* mesh = static_cast<DabozzEngine::ECS::Mesh*>(component.get());
+        } else if (typeId == DabozzEngine::ECS::componentTypeID<DabozzEngine::ECS::Mesh>()) {
+            DabozzEngine::ECS::Mesh* mesh = static_cast<DabozzEngine::ECS::Mesh*>(component);
             if (mesh) {
                 componentLayout->addWidget(new QLabel("Mesh Componet"));
             }
-        } else if (typeId == typeid(DabozzEngine::ECS::Name)) {
-            DabozzEngine::ECS::Name* nameComponent = static_cast<DabozzEngine::ECS::Name*>(component.get());
+        } else if (typeId == DabozzEngine::ECS::componentTypeID<DabozzEngine::ECS::Name>()) {
+            DabozzEngine::ECS::Name* nameComponent = static_cast<DabozzEngine::ECS::Name*>(component);
             if (nameComponent) {
                 componentLayout->addWidget(new QLabel(QString("Name: %1").arg(nameComponent->name)));
             }
-        } else if (typeId == typeid(DabozzEngine::ECS::Transform)) {
+        } else if (typeId == DabozzEngine::ECS::componentTypeID<DabozzEngine::ECS::Transform>()) {
             componentLayout->addWidget(new QLabel("Edit in Transform section above."));
-        } else if (typeId == typeid(DabozzEngine::ECS::FirstPersonController)) {
+        } else if (typeId == DabozzEngine::ECS::componentTypeID<DabozzEngine::ECS::FirstPersonController>()) {
             componentLayout->addWidget(new QLabel("First Person Controller"));
-        } else if (typeId == typeid(DabozzEngine::ECS::Animator)) {
-            DabozzEngine::ECS::Animator* animator = static_cast<DabozzEngine::ECS::Animator*>(component.get());
+        } else if (typeId == DabozzEngine::ECS::componentTypeID<DabozzEngine::ECS::Animator>()) {
+            DabozzEngine::ECS::Animator* animator = static_cast<DabozzEngine::ECS::Animator*>(component);
             if (animator) {
                 componentLayout->addWidget(new QLabel(QString("Clips: %1").arg(animator->animations.size())));
                 componentLayout->addWidget(new QLabel(QString("Playing: %1").arg(animator->isPlaying ? "Yes" : "No")));
@@ -501,8 +503,8 @@ void ComponentInspector::updateComponentsList()
                     componentLayout->addLayout(formLayout);
                 }
             }
-        } else if (typeId == typeid(DabozzEngine::ECS::AudioSource)) {
-            DabozzEngine::ECS::AudioSource* audio = static_cast<DabozzEngine::ECS::AudioSource*>(component.get());
+        } else if (typeId == DabozzEngine::ECS::componentTypeID<DabozzEngine::ECS::AudioSource>()) {
+            DabozzEngine::ECS::AudioSource* audio = static_cast<DabozzEngine::ECS::AudioSource*>(component);
             if (audio) {
                 componentLayout->addWidget(new QLabel(QString("File: %1").arg(audio->filePath.isEmpty() ? "None" : audio->filePath)));
                 componentLayout->addWidget(new QLabel(QString("Volume: %1").arg(audio->volume)));
@@ -520,6 +522,7 @@ void ComponentInspector::updateComponentsList()
                     if (!path.isEmpty()) {
                         a->filePath = path;
                         a->isLoaded = false;
+                        m_world->markChanged<DabozzEngine::ECS::AudioSource>(entity);
                         updateUI();
                     }
                 });
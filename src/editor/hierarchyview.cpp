@@ -1,4 +1,6 @@
 #include "editor/hierarchyview.h"
+#include "ecs/nameindex.h"
+#include "ecs/prefab.h"
 #include "ecs/components/name.h"
 #include "ecs/components/hierarchy.h"
 #include "ecs/components/transform.h"
@@ -9,9 +11,6 @@
 #include <QInputDialog>
 #include <QKeyEvent>
 #include "editor/undostack.h"
-#include "ecs/components/rigidbody.h"
-#include "ecs/components/boxcollider.h"
-#include "ecs/components/spherecollider.h"
 
 HierarchyView::HierarchyView(QWidget* parent)
     : QWidget(parent)
@@ -29,6 +28,11 @@ void HierarchyView::setupUI()
 {
     m_layout = new QVBoxLayout(this);
     
+    m_searchBox = new QLineEdit();
+    m_searchBox->setPlaceholderText("Search...");
+    m_searchBox->setClearButtonEnabled(true);
+    m_layout->addWidget(m_searchBox);
+    
     m_treeWidget = new QTreeWidget();
     m_treeWidget->setHeaderLabel("Scene Objects");
     m_treeWidget->setSelectionMode(QAbstractItemView::SingleSelection);
@@ -43,6 +47,7 @@ void HierarchyView::setupUI()
 void HierarchyView::connectSignals()
 {
     connect(m_treeWidget, &QTreeWidget::itemSelectionChanged, this, &HierarchyView::onItemSelectionChanged);
+    connect(m_searchBox, &QLineEdit::textChanged, this, &HierarchyView::refreshHierarchy);
     m_treeWidget->setContextMenuPolicy(Qt::CustomContextMenu);
     connect(m_treeWidget, &QTreeWidget::customContextMenuRequested, this, &HierarchyView::onContextMenuRequested);
 }
@@ -53,12 +58,29 @@ void HierarchyView::setWorld(DabozzEngine::ECS::World* world)
     refreshHierarchy();
 }
 
+void HierarchyView::setNameIndex(DabozzEngine::ECS::NameIndex* nameIndex)
+{
+    m_nameIndex = nameIndex;
+}
+
 void HierarchyView::refreshHierarchy()
 {
     if (!m_world) return;
     
     m_treeWidget->clear();
     
+    // While searching, list entities whose name starts with the text, flat
+    const QString search = m_searchBox->text().trimmed();
+    if (!search.isEmpty() && m_nameIndex) {
+        for (DabozzEngine::ECS::EntityID entity : m_nameIndex->findByPrefix(search)) {
+            DabozzEngine::ECS::Name* nameComponent = m_world->getComponent<DabozzEngine::ECS::Name>(entity);
+            QTreeWidgetItem* item = new QTreeWidgetItem(m_treeWidget);
+            item->setText(0, nameComponent ? nameComponent->name : QString("Entity %1").arg(entity));
+            item->setData(0, Qt::UserRole, QVariant::fromValue(entity));
+        }
+        return;
+    }
+    
     // Build a map of parent -> children
     std::unordered_map<DabozzEngine::ECS::EntityID, std::vector<DabozzEngine::ECS::EntityID>> hierarchyMap;
     std::unordered_map<DabozzEngine::ECS::EntityID, DabozzEngine::ECS::EntityID> parentMap;
@@ -219,22 +241,24 @@ void HierarchyView::onCreateCube()
     };
     
     // Extract positions, normals, texcoords
+    auto data = std::make_shared<DabozzEngine::ECS::MeshData>();
     for (int i = 0; i < 24; i++) {
-        meshComponent->vertices.push_back(vertices[i * 8 + 0]);
-        meshComponent->vertices.push_back(vertices[i * 8 + 1]);
-        meshComponent->vertices.push_back(vertices[i * 8 + 2]);
+        data->vertices.push_back(vertices[i * 8 + 0]);
+        data->vertices.push_back(vertices[i * 8 + 1]);
+        data->vertices.push_back(vertices[i * 8 + 2]);
         
-        meshComponent->normals.push_back(vertices[i * 8 + 3]);
-        meshComponent->normals.push_back(vertices[i * 8 + 4]);
-        meshComponent->normals.push_back(vertices[i * 8 + 5]);
+        data->normals.push_back(vertices[i * 8 + 3]);
+        data->normals.push_back(vertices[i * 8 + 4]);
+        data->normals.push_back(vertices[i * 8 + 5]);
         
-        meshComponent->texCoords.push_back(vertices[i * 8 + 6]);
-        meshComponent->texCoords.push_back(vertices[i * 8 + 7]);
+        data->texCoords.push_back(vertices[i * 8 + 6]);
+        data->texCoords.push_back(vertices[i * 8 + 7]);
     }
     
     for (int i = 0; i < 36; i++) {
-        meshComponent->indices.push_back(indices[i]);
+        data->indices.push_back(indices[i]);
     }
+    meshComponent->data = std::move(data);
     
     refreshHierarchy();
 }
@@ -289,8 +313,12 @@ void HierarchyView::keyPressEvent(QKeyEvent* event)
             QString currentName = nameComp ? nameComp->name : "";
             QString newName = QInputDialog::getText(this, "Rename Entity", "Name:", QLineEdit::Normal, currentName, &ok);
             if (ok && !newName.isEmpty()) {
-                if (nameComp) nameComp->name = newName;
-                else m_world->addComponent<DabozzEngine::ECS::Name>(entity, newName);
+                if (nameComp) {
+                    nameComp->name = newName;
+                    m_world->markChanged<DabozzEngine::ECS::Name>(entity);
+                } else {
+                    m_world->addComponent<DabozzEngine::ECS::Name>(entity, newName);
+                }
                 refreshHierarchy();
             }
         }
@@ -307,60 +335,14 @@ void HierarchyView::duplicateSelectedEntity()
     if (!item) return;
 
     DabozzEngine::ECS::EntityID srcEntity = item->data(0, Qt::UserRole).value<DabozzEngine::ECS::EntityID>();
-    DabozzEngine::ECS::EntityID newEntity = m_world->createEntity();
-
-    auto* srcName = m_world->getComponent<DabozzEngine::ECS::Name>(srcEntity);
-    if (srcName) {
-        m_world->addComponent<DabozzEngine::ECS::Name>(newEntity, srcName->name + " (Copy)");
-    }
-
-    auto* srcTransform = m_world->getComponent<DabozzEngine::ECS::Transform>(srcEntity);
-    if (srcTransform) {
-        auto* t = m_world->addComponent<DabozzEngine::ECS::Transform>(newEntity);
-        t->position = srcTransform->position;
-        t->rotation = srcTransform->rotation;
-        t->scale = srcTransform->scale;
-    }
-
-    if (m_world->hasComponent<DabozzEngine::ECS::Hierarchy>(srcEntity)) {
-        m_world->addComponent<DabozzEngine::ECS::Hierarchy>(newEntity);
-    }
-
-    auto* srcRb = m_world->getComponent<DabozzEngine::ECS::RigidBody>(srcEntity);
-    if (srcRb) {
-        m_world->addComponent<DabozzEngine::ECS::RigidBody>(newEntity, srcRb->mass, srcRb->isStatic, srcRb->useGravity);
-    }
 
-    auto* srcBc = m_world->getComponent<DabozzEngine::ECS::BoxCollider>(srcEntity);
-    if (srcBc) {
-        m_world->addComponent<DabozzEngine::ECS::BoxCollider>(newEntity, srcBc->size, srcBc->isTrigger);
-    }
-
-    auto* srcSc = m_world->getComponent<DabozzEngine::ECS::SphereCollider>(srcEntity);
-    if (srcSc) {
-        m_world->addComponent<DabozzEngine::ECS::SphereCollider>(newEntity, srcSc->radius, srcSc->isTrigger);
-    }
-
-    if (m_world->hasComponent<DabozzEngine::ECS::FirstPersonController>(srcEntity)) {
-        m_world->addComponent<DabozzEngine::ECS::FirstPersonController>(newEntity);
-    }
+    // Copies the entity and its children; mesh data is shared, not copied
+    DabozzEngine::ECS::EntityID newEntity = DabozzEngine::ECS::Prefab(*m_world, srcEntity).instantiate(*m_world);
+    if (newEntity == DabozzEngine::ECS::INVALID_ENTITY) return;
 
-    auto* srcMesh = m_world->getComponent<DabozzEngine::ECS::Mesh>(srcEntity);
-    if (srcMesh) {
-        auto* m = m_world->addComponent<DabozzEngine::ECS::Mesh>(newEntity);
-        m->vertices = srcMesh->vertices;
-        m->normals = srcMesh->normals;
-        m->texCoords = srcMesh->texCoords;
-        m->indices = srcMesh->indices;
-        m->modelPath = srcMesh->modelPath;
-        m->texturePath = srcMesh->texturePath;
-        m->hasTexture = srcMesh->hasTexture;
-        m->hasAnimation = srcMesh->hasAnimation;
-        m->boneIds = srcMesh->boneIds;
-        m->boneWeights = srcMesh->boneWeights;
-        m->embeddedTextureData = srcMesh->embeddedTextureData;
-        m->embeddedTextureWidth = srcMesh->embeddedTextureWidth;
-        m->embeddedTextureHeight = srcMesh->embeddedTextureHeight;
+    if (auto* name = m_world->getComponent<DabozzEngine::ECS::Name>(newEntity)) {
+        name->name += " (Copy)";
+        m_world->markChanged<DabozzEngine::ECS::Name>(newEntity);
     }
 
     refreshHierarchy();
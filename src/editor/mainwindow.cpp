@@ -19,6 +19,8 @@
 #include "ecs/components/animator.h"
 #include "ecs/systems/animationsystem.h"
 #include "ecs/systems/audiosystem.h"
+#include "ecs/systems/transformsystem.h"
+#include "ecs/nameindex.h"
 #include "renderer/meshloader.h"
 #include "renderer/animation.h"
 #include "renderer/skeleton.h"
@@ -27,15 +29,25 @@
 #include "ecs/components/rigidbody.h"
 #include "editor/undostack.h"
 #include "editor/scenefile.h"
+#include "input/inputrecording.h"
 #include "debug/logger.h"
+#include <QAbstractEventDispatcher>
+#include <QDialog>
+#include <QDialogButtonBox>
 #include <QDir>
 #include <QFileDialog>
+#include <QFontDatabase>
 #include <QMessageBox>
+#include <QPlainTextEdit>
+#include <QPushButton>
+#include <QVBoxLayout>
 #include <QTimer>
+#include <utility>
 
 MainWindow::MainWindow(const QString& projectPath, QWidget* parent)
     : QMainWindow(parent)
     , m_world(new DabozzEngine::ECS::World())
+    , m_nameIndex(new DabozzEngine::ECS::NameIndex(m_world))
     , m_gameWindow(nullptr)
     , m_scriptEditor(nullptr)
     , m_centralTabs(nullptr)
@@ -43,8 +55,10 @@ MainWindow::MainWindow(const QString& projectPath, QWidget* parent)
     , m_physicsSystem(nullptr)
     , m_animationSystem(nullptr)
     , m_audioSystem(nullptr)
+    , m_transformSystem(nullptr)
     , m_scriptEngine(nullptr)
     , m_gameLoopTimer(new QTimer(this))
+    , m_gameLoop(nullptr)
     , m_undoStack(new QUndoStack(this))
     , m_projectPath(projectPath)
     , m_editorMode(EditorMode::Edit)
@@ -71,15 +85,39 @@ MainWindow::MainWindow(const QString& projectPath, QWidget* parent)
     m_butsuri = nullptr;
     m_physicsSystem = nullptr;
     m_animationSystem = new DabozzEngine::Systems::AnimationSystem(m_world);
-    m_audioSystem = new DabozzEngine::Systems::AudioSystem(m_world);
+    m_transformSystem = new DabozzEngine::Systems::TransformSystem(m_world);
+    m_sceneView->renderer()->setTransformSystem(m_transformSystem);
+    m_audioSystem = new DabozzEngine::Systems::AudioSystem(m_world, m_transformSystem);
     m_audioSystem->initialize();
-    
-    // Setup game loop timer (60 FPS)
+    createSystemSchedule();
+
+    m_gameLoop = new DabozzEngine::ECS::GameLoop([this](float deltaTime) {
+        DabozzEngine::Input::InputManager& input = DabozzEngine::Input::InputManager::getInstance();
+        if (m_inputReplayer) {
+            m_inputReplayer->replayStep(input);
+        }
+        input.beginStep();
+        if (m_inputRecorder) {
+            m_inputRecorder->recordStep(input);
+        }
+
+        m_scheduler.run(deltaTime);
+        m_transformSystem->saveStep();
+        input.endStep();
+    });
+
+    // The simulation steps on the game loop's thread; this timer only
+    // redraws the game window while playing
     connect(m_gameLoopTimer, &QTimer::timeout, this, &MainWindow::updateGameLoop);
 }
 
 MainWindow::~MainWindow()
 {
+    stopSimulation();
+    delete m_gameLoop;
+    delete m_inputRecorder;
+    delete m_inputReplayer;
+
     if (m_gameWindow) {
         delete m_gameWindow;
     }
@@ -90,6 +128,9 @@ MainWindow::~MainWindow()
     if (m_animationSystem) {
         delete m_animationSystem;
     }
+    if (m_transformSystem) {
+        delete m_transformSystem;
+    }
     if (m_scriptEngine) {
         m_scriptEngine->shutdown();
         delete m_scriptEngine;
@@ -101,6 +142,9 @@ MainWindow::~MainWindow()
         m_butsuri->shutdown();
         delete m_butsuri;
     }
+    // Its chunks go back to the World's pool
+    m_editSnapshot = DabozzEngine::ECS::World::Snapshot();
+    delete m_nameIndex;
     delete m_world;
 }
 
@@ -169,6 +213,19 @@ void MainWindow::createMenus()
         m_animatorGraphEditor->activateWindow();
     });
 
+    QAction* memoryStatsAction = m_viewMenu->addAction("&Memory Stats");
+    connect(memoryStatsAction, &QAction::triggered, this, &MainWindow::showMemoryStats);
+
+    QMenu* playMenu = new QMenu("&Play", this);
+    menuBar()->insertMenu(m_helpMenu->menuAction(), playMenu);
+
+    m_recordInputAction = playMenu->addAction("&Record Input");
+    m_recordInputAction->setCheckable(true);
+    m_recordInputAction->setToolTip("Record keyboard and mouse input per step while playing, to replay later");
+
+    QAction* replayInputAction = playMenu->addAction("Re&play Input...");
+    connect(replayInputAction, &QAction::triggered, this, &MainWindow::replayInput);
+
     m_fileMenu->addSeparator();
     
     QAction* exitAction = m_fileMenu->addAction("E&xit");
@@ -218,6 +275,7 @@ void MainWindow::createDockWidgets()
     m_hierarchyView = new HierarchyView(this);
     m_hierarchyView->setWorld(m_world);
     m_hierarchyView->setUndoStack(m_undoStack);
+    m_hierarchyView->setNameIndex(m_nameIndex);
     QDockWidget* hierarchyDock = new QDockWidget("Hierarchy", this);
     hierarchyDock->setWidget(m_hierarchyView);
     addDockWidget(Qt::LeftDockWidgetArea, hierarchyDock);
@@ -287,23 +345,25 @@ void MainWindow::createSampleEntities()
     
     auto* floorMesh = m_world->addComponent<DabozzEngine::ECS::Mesh>(floor);
     // Generate floor cube mesh
-    floorMesh->vertices = {
+    auto floorData = std::make_shared<DabozzEngine::ECS::MeshData>();
+    floorData->vertices = {
         -0.5f, -0.5f, -0.5f,  0.5f, -0.5f, -0.5f,  0.5f,  0.5f, -0.5f, -0.5f,  0.5f, -0.5f,
         -0.5f, -0.5f,  0.5f,  0.5f, -0.5f,  0.5f,  0.5f,  0.5f,  0.5f, -0.5f,  0.5f,  0.5f
     };
-    floorMesh->normals = {
+    floorData->normals = {
         0,0,-1, 0,0,-1, 0,0,-1, 0,0,-1,
         0,0,1, 0,0,1, 0,0,1, 0,0,1
     };
-    floorMesh->texCoords = {
+    floorData->texCoords = {
         0,0, 1,0, 1,1, 0,1,
         0,0, 1,0, 1,1, 0,1
     };
-    floorMesh->indices = {
+    floorData->indices = {
         0,1,2, 2,3,0,  4,5,6, 6,7,4,
         0,4,7, 7,3,0,  1,5,6, 6,2,1,
         0,1,5, 5,4,0,  3,2,6, 6,7,3
     };
+    floorMesh->data = std::move(floorData);
     
     auto* floorRb = m_world->addComponent<DabozzEngine::ECS::RigidBody>(floor, 0.0f, true, false);
     m_world->addComponent<DabozzEngine::ECS::BoxCollider>(floor, QVector3D(10, 0.5f, 10));
@@ -329,10 +389,8 @@ void MainWindow::newScene()
         if (result == QMessageBox::Save) saveScene();
     }
 
-    auto entities = m_world->getEntities();
-    for (auto it = entities.rbegin(); it != entities.rend(); ++it) {
-        m_world->destroyEntity(*it);
-    }
+    m_world->clear();
+    m_world->releaseUnusedMemory();
 
     m_undoStack->clear();
     m_currentScenePath.clear();
@@ -586,20 +644,30 @@ void MainWindow::onPlayClicked()
         statusBar()->showMessage("Play Mode");
         m_sceneView->setModeLabel("Scene View - Play Mode");
 
-        saveSceneState();
+        // Shares the scene's chunks; whatever play mode changes gets copied
+        m_editSnapshot = m_world->snapshot();
+
+        // Sessions start with nothing held down, so recordings replay the same
+        DabozzEngine::Input::InputManager::getInstance().reset();
+        if (m_recordInputAction->isChecked() && !m_inputReplayer) {
+            m_inputRecorder = new DabozzEngine::Input::InputRecorder(m_gameLoop->stepSeconds());
+        }
 
         if (!m_butsuri) {
             DEBUG_LOG << "Initializing Butsuri Engine" << std::endl;
             m_butsuri = new DabozzEngine::Physics::ButsuriEngine();
             m_butsuri->initialize();
             m_physicsSystem = new DabozzEngine::Systems::PhysicsSystem(m_world);
-            m_physicsSystem->initialize();
             DEBUG_LOG << "Butsuri Engine initialized" << std::endl;
         }
+
+        // Bodies start where the edited scene has them
+        m_physicsSystem->initialize();
         
         if (!m_scriptEngine) {
             DEBUG_LOG << "Initializing Script Engine" << std::endl;
             m_scriptEngine = new DabozzEngine::Scripting::ScriptEngine();
+            DabozzEngine::Scripting::ScriptAPI::SetNameIndex(m_nameIndex);
             m_scriptEngine->initialize(m_world);
             loadProjectScripts();
             m_scriptEngine->callLuaStart();
@@ -612,21 +680,10 @@ void MainWindow::onPlayClicked()
         DEBUG_LOG << "Disabling gizmo" << std::endl;
         m_sceneView->renderer()->setSelectedEntity(DabozzEngine::ECS::INVALID_ENTITY);
         
-        DEBUG_LOG << "Resetting mesh upload status for new OpenGL context" << std::endl;
-        for (DabozzEngine::ECS::EntityID entity : m_world->getEntities()) {
-            DabozzEngine::ECS::Mesh* mesh = m_world->getComponent<DabozzEngine::ECS::Mesh>(entity);
-            if (mesh) {
-                mesh->isUploaded = false;
-                mesh->vao = 0;
-                mesh->vbo = 0;
-                mesh->ebo = 0;
-                mesh->textureID = 0;
-            }
-        }
-        
         DEBUG_LOG << "Creating game window" << std::endl;
         if (!m_gameWindow) {
             m_gameWindow = new GameWindow(m_world);
+            m_gameWindow->renderer()->setTransformSystem(m_transformSystem);
             DEBUG_LOG << "Game window created" << std::endl;
         }
         DEBUG_LOG << "Showing game window" << std::endl;
@@ -635,8 +692,8 @@ void MainWindow::onPlayClicked()
         m_gameWindow->activateWindow();
         DEBUG_LOG << "Game window shown" << std::endl;
         
-        DEBUG_LOG << "Starting game loop timer" << std::endl;
-        m_gameLoopTimer->start(16);
+        DEBUG_LOG << "Starting game loop" << std::endl;
+        startSimulation();
         DEBUG_LOG << "Play mode setup complete" << std::endl;
         
     } else if (m_editorMode == EditorMode::Paused) {
@@ -644,7 +701,7 @@ void MainWindow::onPlayClicked()
         m_editorMode = EditorMode::Play;
         statusBar()->showMessage("Play Mode (Resumed)");
         m_sceneView->setModeLabel("Scene View - Play Mode");
-        m_gameLoopTimer->start(16);
+        startSimulation();
     }
 }
 
@@ -654,7 +711,7 @@ void MainWindow::onPauseClicked()
         m_editorMode = EditorMode::Paused;
         statusBar()->showMessage("Play Mode (Paused)");
         m_sceneView->setModeLabel("Scene View - Paused");
-        m_gameLoopTimer->stop();
+        stopSimulation();
     }
 }
 
@@ -666,15 +723,40 @@ void MainWindow::onStopClicked()
         m_sceneView->setModeLabel("Scene View - Edit Mode");
 
         // Stop game loop
-        m_gameLoopTimer->stop();
+        stopSimulation();
+
+        DabozzEngine::Input::InputManager& input = DabozzEngine::Input::InputManager::getInstance();
+        if (m_inputReplayer) {
+            delete m_inputReplayer;
+            m_inputReplayer = nullptr;
+            input.setLiveInputEnabled(true);
+        }
+        input.reset();
+
+        if (m_inputRecorder) {
+            QString defaultDir = m_projectPath.isEmpty() ? "" : m_projectPath;
+            QString path = QFileDialog::getSaveFileName(this, "Save Input Recording", defaultDir,
+                                                        "Input Recordings (*.dzinput)");
+            if (!path.isEmpty() && !m_inputRecorder->save(path)) {
+                QMessageBox::critical(this, "Save Failed", "Failed to save input recording.");
+            }
+            delete m_inputRecorder;
+            m_inputRecorder = nullptr;
+        }
         
         // Hide game window
         if (m_gameWindow) {
             m_gameWindow->hide();
         }
 
-        // Restore scene state to pre-play values
-        restoreSceneState();
+        // Edit mode has no bodies; play mode creates them afresh
+        if (m_physicsSystem) {
+            m_physicsSystem->shutdown();
+        }
+
+        // Put the edited scene back, GPU handles of the editor's context included
+        m_world->restore(m_editSnapshot);
+        m_editSnapshot = DabozzEngine::ECS::World::Snapshot();
 
         // Resume the editor view
         m_sceneView->renderer()->setPlayMode(false);
@@ -684,43 +766,78 @@ void MainWindow::onStopClicked()
     }
 }
 
-void MainWindow::updateGameLoop()
+void MainWindow::createSystemSchedule()
 {
-    if (m_editorMode == EditorMode::Play) {
-        float deltaTime = 1.0f / 60.0f;
-        
+    using namespace DabozzEngine::ECS;
+
+    // Scripts can touch any component and own the Lua/AngelScript VMs
+    m_scheduler.addSystem("Scripts", [this](float deltaTime) {
         if (m_scriptEngine) {
             DabozzEngine::Scripting::ScriptAPI::SetDeltaTime(deltaTime);
             m_scriptEngine->callLuaUpdate(deltaTime);
             m_scriptEngine->callAngelScriptUpdate(deltaTime);
         }
-        
-        if (m_audioSystem) {
-            // Update listener position to match camera
-            // Find camera entity (you can tag it or use a specific name)
-            for (auto entity : m_world->getEntities()) {
-                auto* name = m_world->getComponent<DabozzEngine::ECS::Name>(entity);
-                if (name && name->name == "Camera") {
-                    auto* transform = m_world->getComponent<DabozzEngine::ECS::Transform>(entity);
-                    if (transform) {
-                        m_audioSystem->setListenerPosition(transform->position);
-                        // Calculate forward direction from rotation
-                        QVector3D forward = transform->rotation.rotatedVector(QVector3D(0, 0, -1));
-                        QVector3D up = transform->rotation.rotatedVector(QVector3D(0, 1, 0));
-                        m_audioSystem->setListenerOrientation(forward, up);
-                    }
-                    break;
-                }
-            }
-            m_audioSystem->update(deltaTime);
+    }).exclusive().mainThread();
+
+    m_scheduler.addSystem("Transforms", [this](float) {
+        m_transformSystem->update();
+    }).reads<Transform, Hierarchy>();
+
+    m_scheduler.addSystem("Audio", [this](float deltaTime) {
+        if (!m_audioSystem) return;
+
+        // Update listener position to match camera
+        // Find camera entity (you can tag it or use a specific name)
+        EntityID camera = m_nameIndex->find("Camera");
+        if (const Transform* transform = std::as_const(*m_world).getComponent<Transform>(camera)) {
+            m_audioSystem->setListenerPosition(transform->position);
+            // Calculate forward direction from rotation
+            QVector3D forward = transform->rotation.rotatedVector(QVector3D(0, 0, -1));
+            QVector3D up = transform->rotation.rotatedVector(QVector3D(0, 1, 0));
+            m_audioSystem->setListenerOrientation(forward, up);
         }
+        m_audioSystem->update(deltaTime);
+    }).reads<Name, Transform>().writes<AudioSource>().after("Transforms");
+
+    m_scheduler.addSystem("Animation", [this](float deltaTime) {
         if (m_animationSystem) {
             m_animationSystem->update(deltaTime);
         }
-        
+    }).writes<Animator>();
+
+    m_scheduler.addSystem("Physics", [this](float deltaTime) {
         if (m_physicsSystem) {
             m_physicsSystem->update(deltaTime);
         }
+    }).writes<Transform, RigidBody>().reads<BoxCollider, SphereCollider>();
+}
+
+void MainWindow::updateGameLoop()
+{
+    if (m_editorMode == EditorMode::Play) {
+        if (m_inputReplayer && m_inputReplayer->atEnd()) {
+            onStopClicked();
+            statusBar()->showMessage("Input replay finished");
+            return;
+        }
+
+        // Draw between the last two simulation steps
+        m_transformSystem->setInterpolation(true, m_gameLoop->interpolationAlpha());
+
+        // Per-system cost, refreshed about once a second
+        if (++m_scheduledFrames >= 60) {
+            m_scheduledFrames = 0;
+            QString timings = QString("Step %1 ms").arg(m_scheduler.lastFrameMs(), 0, 'f', 2);
+            for (const auto& timing : m_scheduler.timings()) {
+                timings += QString(" | %1 %2 ms")
+                    .arg(QString::fromStdString(timing.name))
+                    .arg(timing.averageMs, 0, 'f', 2);
+            }
+            if (m_gameLoop->droppedSteps() > 0) {
+                timings += QString(" | %1 steps dropped").arg(m_gameLoop->droppedSteps());
+            }
+            statusBar()->showMessage(timings);
+        }
         
         if (m_gameWindow) {
             m_gameWindow->renderer()->update();
@@ -728,68 +845,99 @@ void MainWindow::updateGameLoop()
     }
 }
 
-void MainWindow::saveSceneState()
+void MainWindow::startSimulation()
 {
-    m_savedState.clear();
-    for (DabozzEngine::ECS::EntityID entity : m_world->getEntities()) {
-        SavedEntityState state;
+    if (m_gameLoop->isRunning()) return;
+
+    // We're inside an event handler now; from here on the lock is let go
+    // whenever the event loop goes idle and taken back when it wakes up
+    m_worldLock = std::unique_lock<std::mutex>(m_gameLoop->mutex());
+    QAbstractEventDispatcher* dispatcher = QAbstractEventDispatcher::instance();
+    m_dispatcherAboutToBlock = connect(dispatcher, &QAbstractEventDispatcher::aboutToBlock, this, [this]() {
+        if (m_worldLock.owns_lock()) m_worldLock.unlock();
+    });
+    m_dispatcherAwake = connect(dispatcher, &QAbstractEventDispatcher::awake, this, [this]() {
+        if (!m_worldLock.owns_lock()) m_worldLock.lock();
+    });
 
-        auto* transform = m_world->getComponent<DabozzEngine::ECS::Transform>(entity);
-        if (transform) {
-            state.position = transform->position;
-            state.rotation = transform->rotation;
-            state.scale = transform->scale;
-        }
+    m_gameLoop->start();
+    m_gameLoopTimer->start(16);
+}
 
-        auto* rb = m_world->getComponent<DabozzEngine::ECS::RigidBody>(entity);
-        if (rb) {
-            state.velocity = rb->velocity;
-            state.angularVelocity = rb->angularVelocity;
-        }
+void MainWindow::stopSimulation()
+{
+    if (!m_gameLoop || !m_gameLoop->isRunning()) return;
 
-        auto* animator = m_world->getComponent<DabozzEngine::ECS::Animator>(entity);
-        if (animator) {
-            state.animatorTime = animator->currentTime;
-            state.animatorPlaying = animator->isPlaying;
-        }
+    m_gameLoopTimer->stop();
+    disconnect(m_dispatcherAboutToBlock);
+    disconnect(m_dispatcherAwake);
+    if (m_worldLock.owns_lock()) m_worldLock.unlock();
 
-        m_savedState[entity] = state;
-    }
+    // Waits for the step in progress, which may need the lock we just let go
+    m_gameLoop->stop();
+    m_worldLock = std::unique_lock<std::mutex>();
+    m_transformSystem->setInterpolation(false);
 }
 
-void MainWindow::restoreSceneState()
+void MainWindow::showMemoryStats()
 {
-    for (auto& [entity, state] : m_savedState) {
-        auto* transform = m_world->getComponent<DabozzEngine::ECS::Transform>(entity);
-        if (transform) {
-            transform->position = state.position;
-            transform->rotation = state.rotation;
-            transform->scale = state.scale;
-        }
+    QDialog* dialog = new QDialog(this);
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+    dialog->setWindowTitle("Memory Stats");
+    dialog->resize(720, 520);
+
+    QPlainTextEdit* text = new QPlainTextEdit(dialog);
+    text->setReadOnly(true);
+    text->setLineWrapMode(QPlainTextEdit::NoWrap);
+    text->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+
+    // Event handlers hold the World lock in play mode, so this is safe mid-game
+    auto refresh = [this, text]() {
+        text->setPlainText(QString::fromStdString(m_world->stats().format()));
+    };
+    refresh();
 
-        auto* rb = m_world->getComponent<DabozzEngine::ECS::RigidBody>(entity);
-        if (rb) {
-            rb->velocity = state.velocity;
-            rb->angularVelocity = state.angularVelocity;
-        }
+    QDialogButtonBox* buttons = new QDialogButtonBox(QDialogButtonBox::Close, dialog);
+    QPushButton* refreshButton = buttons->addButton("Refresh", QDialogButtonBox::ActionRole);
+    connect(refreshButton, &QPushButton::clicked, dialog, refresh);
+    connect(buttons, &QDialogButtonBox::rejected, dialog, &QDialog::close);
 
-        auto* animator = m_world->getComponent<DabozzEngine::ECS::Animator>(entity);
-        if (animator) {
-            animator->currentTime = state.animatorTime;
-            animator->isPlaying = state.animatorPlaying;
-        }
+    QVBoxLayout* layout = new QVBoxLayout(dialog);
+    layout->addWidget(text);
+    layout->addWidget(buttons);
+    dialog->show();
+}
 
-        // Reset mesh GPU state so the editor re-uploads for its own GL context
-        auto* mesh = m_world->getComponent<DabozzEngine::ECS::Mesh>(entity);
-        if (mesh) {
-            mesh->isUploaded = false;
-            mesh->vao = 0;
-            mesh->vbo = 0;
-            mesh->ebo = 0;
-            mesh->textureID = 0;
-        }
+void MainWindow::replayInput()
+{
+    if (m_editorMode != EditorMode::Edit) {
+        statusBar()->showMessage("Stop play mode before replaying input");
+        return;
     }
-    m_savedState.clear();
+
+    QString defaultDir = m_projectPath.isEmpty() ? "" : m_projectPath;
+    QString path = QFileDialog::getOpenFileName(this, "Replay Input", defaultDir, "Input Recordings (*.dzinput)");
+    if (path.isEmpty()) return;
+
+    auto* replayer = new DabozzEngine::Input::InputReplayer();
+    if (!replayer->load(path)) {
+        delete replayer;
+        QMessageBox::critical(this, "Replay Failed", "Not a valid input recording.");
+        return;
+    }
+    if (qAbs(replayer->stepSeconds() - m_gameLoop->stepSeconds()) > 1e-6f) {
+        QMessageBox::warning(this, "Replay Failed",
+            QString("The recording steps at %1 Hz, play mode at %2 Hz.")
+                .arg(1.0f / replayer->stepSeconds(), 0, 'f', 1)
+                .arg(1.0f / m_gameLoop->stepSeconds(), 0, 'f', 1));
+        delete replayer;
+        return;
+    }
+
+    m_inputReplayer = replayer;
+    DabozzEngine::Input::InputManager::getInstance().setLiveInputEnabled(false);
+    onPlayClicked();
+    statusBar()->showMessage(QString("Replaying %1 steps of input").arg(static_cast<qulonglong>(replayer->stepCount())));
 }
 
 void MainWindow::openScriptEditor()
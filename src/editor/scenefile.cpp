@@ -114,12 +114,12 @@ bool SceneFile::saveScene(DabozzEngine::ECS::World* world, const QString& path)
 
             /* Store vertex data for procedural meshes (cubes, floors) that
                don't have a modelPath to reload from. */
-            if (mesh->modelPath.empty()) {
+            if (mesh->modelPath.empty() && mesh->data) {
                 QJsonArray verts, norms, texcs, idxs;
-                for (float v : mesh->vertices) verts.append(v);
-                for (float n : mesh->normals) norms.append(n);
-                for (float t : mesh->texCoords) texcs.append(t);
-                for (unsigned int i : mesh->indices) idxs.append(static_cast<int>(i));
+                for (float v : mesh->data->vertices) verts.append(v);
+                for (float n : mesh->data->normals) norms.append(n);
+                for (float t : mesh->data->texCoords) texcs.append(t);
+                for (unsigned int i : mesh->data->indices) idxs.append(static_cast<int>(i));
                 meshObj["vertices"] = verts;
                 meshObj["normals"] = norms;
                 meshObj["texCoords"] = texcs;
@@ -157,21 +157,18 @@ bool SceneFile::loadScene(DabozzEngine::ECS::World* world, const QString& path)
     QJsonObject root = doc.object();
 
     /* Clear the world - destroy all existing entities */
-    auto entities = world->getEntities();
-    for (auto it = entities.rbegin(); it != entities.rend(); ++it) {
-        world->destroyEntity(*it);
-    }
+    world->clear();
 
     QJsonArray entitiesArray = root["entities"].toArray();
 
     /* First pass: create all entities with their IDs */
     std::unordered_map<int, DabozzEngine::ECS::EntityID> idMap;
+    idMap.reserve(entitiesArray.size());
 
-    for (const auto& val : entitiesArray) {
-        QJsonObject entityObj = val.toObject();
-        int savedId = entityObj["id"].toInt();
-        DabozzEngine::ECS::EntityID entity = world->createEntity();
-        idMap[savedId] = entity;
+    std::vector<DabozzEngine::ECS::EntityID> created = world->createEntities(entitiesArray.size());
+    for (size_t i = 0; i < created.size(); ++i) {
+        int savedId = entitiesArray[static_cast<int>(i)].toObject()["id"].toInt();
+        idMap[savedId] = created[i];
     }
 
     /* Second pass: add components */
@@ -248,14 +245,12 @@ bool SceneFile::loadScene(DabozzEngine::ECS::World* world, const QString& path)
             mesh->hasAnimation = meshObj["hasAnimation"].toBool();
 
             if (meshObj.contains("vertices")) {
-                mesh->vertices.clear();
-                mesh->normals.clear();
-                mesh->texCoords.clear();
-                mesh->indices.clear();
-                for (const auto& v : meshObj["vertices"].toArray()) mesh->vertices.push_back(v.toDouble());
-                for (const auto& n : meshObj["normals"].toArray()) mesh->normals.push_back(n.toDouble());
-                for (const auto& t : meshObj["texCoords"].toArray()) mesh->texCoords.push_back(t.toDouble());
-                for (const auto& i : meshObj["indices"].toArray()) mesh->indices.push_back(i.toInt());
+                auto data = std::make_shared<DabozzEngine::ECS::MeshData>();
+                for (const auto& v : meshObj["vertices"].toArray()) data->vertices.push_back(v.toDouble());
+                for (const auto& n : meshObj["normals"].toArray()) data->normals.push_back(n.toDouble());
+                for (const auto& t : meshObj["texCoords"].toArray()) data->texCoords.push_back(t.toDouble());
+                for (const auto& i : meshObj["indices"].toArray()) data->indices.push_back(i.toInt());
+                mesh->data = std::move(data);
             }
         }
     }
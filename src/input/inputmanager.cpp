@@ -9,16 +9,20 @@ InputManager& InputManager::getInstance()
     return instance;
 }
 
-void InputManager::update()
+void InputManager::beginStep()
+{
+    m_mouseDelta = m_mousePosition - m_lastMousePosition;
+    m_lastMousePosition = m_mousePosition;
+}
+
+void InputManager::endStep()
 {
     m_keysPressed.clear();
     m_keysReleased.clear();
     m_mouseButtonsPressed.clear();
     m_mouseButtonsReleased.clear();
-    
-    m_mouseDelta = m_mousePosition - m_lastMousePosition;
-    m_lastMousePosition = m_mousePosition;
     m_mouseScrollDelta = 0;
+    m_stepEvents.clear();
 }
 
 void InputManager::reset()
@@ -33,44 +37,74 @@ void InputManager::reset()
     m_lastMousePosition = QPoint(0, 0);
     m_mouseDelta = QPoint(0, 0);
     m_mouseScrollDelta = 0;
+    m_stepEvents.clear();
 }
 
-void InputManager::keyPressed(int key)
+void InputManager::applyEvent(const InputEvent& event)
 {
-    if (!m_keysDown.contains(key)) {
-        m_keysPressed.insert(key);
-        m_keysDown.insert(key);
+    switch (event.type) {
+    case InputEvent::Type::KeyDown:
+        if (!m_keysDown.contains(event.x)) {
+            m_keysPressed.insert(event.x);
+            m_keysDown.insert(event.x);
+        }
+        break;
+    case InputEvent::Type::KeyUp:
+        m_keysReleased.insert(event.x);
+        m_keysDown.remove(event.x);
+        break;
+    case InputEvent::Type::MouseDown: {
+        Qt::MouseButton button = static_cast<Qt::MouseButton>(event.x);
+        if (!m_mouseButtonsDown.contains(button)) {
+            m_mouseButtonsPressed.insert(button);
+            m_mouseButtonsDown.insert(button);
+        }
+        break;
     }
+    case InputEvent::Type::MouseUp: {
+        Qt::MouseButton button = static_cast<Qt::MouseButton>(event.x);
+        m_mouseButtonsReleased.insert(button);
+        m_mouseButtonsDown.remove(button);
+        break;
+    }
+    case InputEvent::Type::MouseMove:
+        m_mousePosition = QPoint(event.x, event.y);
+        break;
+    case InputEvent::Type::MouseScroll:
+        m_mouseScrollDelta = event.x;
+        break;
+    }
+    m_stepEvents.push_back(event);
+}
+
+void InputManager::keyPressed(int key)
+{
+    if (m_liveInputEnabled) applyEvent({ InputEvent::Type::KeyDown, key });
 }
 
 void InputManager::keyReleased(int key)
 {
-    m_keysReleased.insert(key);
-    m_keysDown.remove(key);
+    if (m_liveInputEnabled) applyEvent({ InputEvent::Type::KeyUp, key });
 }
 
 void InputManager::mousePressed(Qt::MouseButton button)
 {
-    if (!m_mouseButtonsDown.contains(button)) {
-        m_mouseButtonsPressed.insert(button);
-        m_mouseButtonsDown.insert(button);
-    }
+    if (m_liveInputEnabled) applyEvent({ InputEvent::Type::MouseDown, static_cast<int>(button) });
 }
 
 void InputManager::mouseReleased(Qt::MouseButton button)
 {
-    m_mouseButtonsReleased.insert(button);
-    m_mouseButtonsDown.remove(button);
+    if (m_liveInputEnabled) applyEvent({ InputEvent::Type::MouseUp, static_cast<int>(button) });
 }
 
 void InputManager::mouseMoved(const QPoint& pos)
 {
-    m_mousePosition = pos;
+    if (m_liveInputEnabled) applyEvent({ InputEvent::Type::MouseMove, pos.x(), pos.y() });
 }
 
 void InputManager::mouseScrolled(int delta)
 {
-    m_mouseScrollDelta = delta;
+    if (m_liveInputEnabled) applyEvent({ InputEvent::Type::MouseScroll, delta });
 }
 
 bool InputManager::isKeyDown(int key) const
@@ -0,0 +1,252 @@
+#include "input/inputrecording.h"
+#include <QFile>
+#include <cstring>
+
+namespace DabozzEngine {
+namespace Input {
+
+namespace {
+
+const char MAGIC[4] = { 'D', 'Z', 'I', 'R' };
+const uint8_t VERSION = 1;
+const int HEADER_SIZE = 9;
+
+void writeVarint(QByteArray& data, uint64_t value)
+{
+    while (value >= 0x80) {
+        data.append(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    data.append(static_cast<char>(value));
+}
+
+void writeSigned(QByteArray& data, int value)
+{
+    // Zigzag, so small negative numbers stay small too
+    int64_t wide = value;
+    writeVarint(data, (static_cast<uint64_t>(wide) << 1) ^ static_cast<uint64_t>(wide >> 63));
+}
+
+bool readVarint(const QByteArray& data, int& offset, uint64_t& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (offset >= data.size()) return false;
+        uint8_t byte = static_cast<uint8_t>(data[offset++]);
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+bool readSigned(const QByteArray& data, int& offset, int& value)
+{
+    uint64_t raw;
+    if (!readVarint(data, offset, raw)) return false;
+    value = static_cast<int>(static_cast<int64_t>(raw >> 1) ^ -static_cast<int64_t>(raw & 1));
+    return true;
+}
+
+}
+
+InputRecorder::InputRecorder(float stepSeconds)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &stepSeconds, sizeof(bits));
+
+    m_data.append(MAGIC, sizeof(MAGIC));
+    m_data.append(static_cast<char>(VERSION));
+    for (int byte = 0; byte < 4; ++byte) {
+        m_data.append(static_cast<char>((bits >> (byte * 8)) & 0xFF));
+    }
+}
+
+void InputRecorder::recordStep(const InputManager& input)
+{
+    ++m_stepCount;
+
+    // Only the last cursor move of a step matters
+    const std::vector<InputEvent>& events = input.stepEvents();
+    int lastMove = -1;
+    size_t count = 0;
+    for (size_t i = 0; i < events.size(); ++i) {
+        if (events[i].type == InputEvent::Type::MouseMove) {
+            if (lastMove < 0) ++count;
+            lastMove = static_cast<int>(i);
+        } else {
+            ++count;
+        }
+    }
+
+    if (count == 0) {
+        ++m_idleSteps;
+        return;
+    }
+
+    if (m_idleSteps > 0) {
+        writeVarint(m_data, m_idleSteps << 1);
+        m_idleSteps = 0;
+    }
+
+    writeVarint(m_data, (static_cast<uint64_t>(count) << 1) | 1);
+    for (size_t i = 0; i < events.size(); ++i) {
+        if (events[i].type == InputEvent::Type::MouseMove && static_cast<int>(i) != lastMove) continue;
+        writeEvent(events[i]);
+    }
+}
+
+void InputRecorder::writeEvent(const InputEvent& event)
+{
+    m_data.append(static_cast<char>(event.type));
+    switch (event.type) {
+    case InputEvent::Type::KeyDown:
+    case InputEvent::Type::KeyUp:
+    case InputEvent::Type::MouseDown:
+    case InputEvent::Type::MouseUp:
+        writeVarint(m_data, static_cast<uint32_t>(event.x));
+        break;
+    case InputEvent::Type::MouseMove:
+        writeSigned(m_data, event.x - m_lastX);
+        writeSigned(m_data, event.y - m_lastY);
+        m_lastX = event.x;
+        m_lastY = event.y;
+        break;
+    case InputEvent::Type::MouseScroll:
+        writeSigned(m_data, event.x);
+        break;
+    }
+}
+
+QByteArray InputRecorder::data() const
+{
+    QByteArray data = m_data;
+    if (m_idleSteps > 0) {
+        writeVarint(data, m_idleSteps << 1);
+    }
+    return data;
+}
+
+bool InputRecorder::save(const QString& path) const
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    const QByteArray stream = data();
+    return file.write(stream) == stream.size();
+}
+
+bool InputReplayer::load(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+    return setData(file.readAll());
+}
+
+bool InputReplayer::setData(const QByteArray& data)
+{
+    m_data.clear();
+    m_stepCount = 0;
+    rewind();
+
+    if (data.size() < HEADER_SIZE || std::memcmp(data.constData(), MAGIC, sizeof(MAGIC)) != 0
+        || static_cast<uint8_t>(data[4]) != VERSION) {
+        return false;
+    }
+
+    uint32_t bits = 0;
+    for (int byte = 0; byte < 4; ++byte) {
+        bits |= static_cast<uint32_t>(static_cast<uint8_t>(data[5 + byte])) << (byte * 8);
+    }
+    std::memcpy(&m_stepSeconds, &bits, sizeof(bits));
+    if (!(m_stepSeconds > 0.0f)) return false;
+
+    // Walk the whole stream once, to validate it and count the steps
+    m_data = data;
+    rewind();
+    uint64_t steps = 0;
+    std::vector<InputEvent> events;
+    while (m_offset < m_data.size() || m_idleSteps > 0) {
+        if (!readStep(events)) {
+            m_data.clear();
+            rewind();
+            return false;
+        }
+        ++steps;
+    }
+
+    m_stepCount = steps;
+    rewind();
+    return true;
+}
+
+bool InputReplayer::replayStep(InputManager& input)
+{
+    if (atEnd() || !readStep(m_events)) return false;
+
+    ++m_currentStep;
+    for (const InputEvent& event : m_events) {
+        input.applyEvent(event);
+    }
+    return true;
+}
+
+void InputReplayer::rewind()
+{
+    m_currentStep = 0;
+    m_offset = HEADER_SIZE;
+    m_idleSteps = 0;
+    m_lastX = 0;
+    m_lastY = 0;
+}
+
+bool InputReplayer::readStep(std::vector<InputEvent>& events)
+{
+    events.clear();
+    if (m_idleSteps > 0) {
+        --m_idleSteps;
+        return true;
+    }
+
+    uint64_t entry;
+    if (!readVarint(m_data, m_offset, entry) || (entry >> 1) == 0) return false;
+
+    if (!(entry & 1)) {
+        m_idleSteps = (entry >> 1) - 1;
+        return true;
+    }
+
+    for (uint64_t i = 0, count = entry >> 1; i < count; ++i) {
+        if (m_offset >= m_data.size()) return false;
+
+        InputEvent event;
+        const uint8_t type = static_cast<uint8_t>(m_data[m_offset++]);
+        if (type > static_cast<uint8_t>(InputEvent::Type::MouseScroll)) return false;
+        event.type = static_cast<InputEvent::Type>(type);
+
+        uint64_t value;
+        int dx, dy;
+        switch (event.type) {
+        case InputEvent::Type::KeyDown:
+        case InputEvent::Type::KeyUp:
+        case InputEvent::Type::MouseDown:
+        case InputEvent::Type::MouseUp:
+            if (!readVarint(m_data, m_offset, value)) return false;
+            event.x = static_cast<int>(static_cast<uint32_t>(value));
+            break;
+        case InputEvent::Type::MouseMove:
+            if (!readSigned(m_data, m_offset, dx) || !readSigned(m_data, m_offset, dy)) return false;
+            m_lastX += dx;
+            m_lastY += dy;
+            event.x = m_lastX;
+            event.y = m_lastY;
+            break;
+        case InputEvent::Type::MouseScroll:
+            if (!readSigned(m_data, m_offset, event.x)) return false;
+            break;
+        }
+        events.push_back(event);
+    }
+    return true;
+}
+
+}
+}
@@ -0,0 +1,221 @@
+#include "jobs/jobsystem.h"
+
+namespace DabozzEngine {
+namespace Jobs {
+
+namespace {
+
+// Which JobSystem worker, if any, the current thread is
+thread_local const JobSystem* t_owner = nullptr;
+thread_local size_t t_queue = 0;
+
+}
+
+JobSystem& JobSystem::instance()
+{
+    static JobSystem jobSystem(std::max(std::thread::hardware_concurrency(), 1u) - 1);
+    return jobSystem;
+}
+
+JobSystem::JobSystem(size_t workerCount)
+    : m_mainThread(std::this_thread::get_id())
+{
+    // One queue per worker plus the shared one for outside threads
+    for (size_t i = 0; i <= workerCount; ++i) {
+        m_queues.push_back(std::make_unique<JobQueue>());
+    }
+
+    m_workers.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; ++i) {
+        m_workers.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+
+    for (std::thread& worker : m_workers) {
+        worker.join();
+    }
+}
+
+void JobSystem::submit(JobFunction function, JobCounter* counter, JobAffinity affinity)
+{
+    if (counter) {
+        std::lock_guard<std::mutex> lock(counter->m_mutex);
+        counter->m_value.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    enqueue({ std::move(function), counter }, affinity);
+}
+
+void JobSystem::submitAfter(JobCounter& dependency, JobFunction function,
+                            JobCounter* counter, JobAffinity affinity)
+{
+    if (counter) {
+        std::lock_guard<std::mutex> lock(counter->m_mutex);
+        counter->m_value.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::unique_lock<std::mutex> lock(dependency.m_mutex);
+    if (dependency.m_value.load(std::memory_order_relaxed) == 0) {
+        lock.unlock();
+        enqueue({ std::move(function), counter }, affinity);
+        return;
+    }
+
+    auto job = std::make_shared<Job>(Job{ std::move(function), counter });
+    dependency.m_continuations.push_back([this, job, affinity] {
+        enqueue(std::move(*job), affinity);
+    });
+}
+
+void JobSystem::wait(JobCounter& counter)
+{
+    while (!counter.done()) {
+        if (!tryRunJob()) {
+            std::this_thread::yield();
+        }
+    }
+
+    // The last job may still be inside finish(); let it leave before the
+    // caller destroys the counter
+    std::lock_guard<std::mutex> lock(counter.m_mutex);
+}
+
+void JobSystem::runMainThreadJobs()
+{
+    Job job;
+    while (popMainThreadJob(job)) {
+        execute(job);
+    }
+}
+
+void JobSystem::enqueue(Job job, JobAffinity affinity)
+{
+    if (affinity == JobAffinity::MainThread) {
+        std::lock_guard<std::mutex> lock(m_mainThreadQueue.mutex);
+        m_mainThreadQueue.jobs.push_back(std::move(job));
+        return;
+    }
+
+    JobQueue& queue = *m_queues[localQueue()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(std::move(job));
+    }
+
+    m_queuedJobs.fetch_add(1);
+    if (m_sleepingWorkers.load() > 0) {
+        // Taking the lock orders this against a worker about to sleep
+        { std::lock_guard<std::mutex> lock(m_sleepMutex); }
+        m_wake.notify_one();
+    }
+}
+
+bool JobSystem::tryRunJob()
+{
+    Job job;
+    if ((isMainThread() && popMainThreadJob(job))
+        || popJob(localQueue(), job)
+        || stealJob(localQueue(), job)) {
+        execute(job);
+        return true;
+    }
+    return false;
+}
+
+bool JobSystem::popJob(size_t queue, Job& job)
+{
+    JobQueue& own = *m_queues[queue];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (own.jobs.empty()) return false;
+
+    // Newest first: its data is most likely still in cache
+    job = std::move(own.jobs.back());
+    own.jobs.pop_back();
+    m_queuedJobs.fetch_sub(1);
+    return true;
+}
+
+bool JobSystem::stealJob(size_t thief, Job& job)
+{
+    const size_t queueCount = m_queues.size();
+    for (size_t offset = 1; offset < queueCount; ++offset) {
+        JobQueue& victim = *m_queues[(thief + offset) % queueCount];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.jobs.empty()) continue;
+
+        // Oldest first, away from the end the owner works on
+        job = std::move(victim.jobs.front());
+        victim.jobs.pop_front();
+        m_queuedJobs.fetch_sub(1);
+        return true;
+    }
+    return false;
+}
+
+bool JobSystem::popMainThreadJob(Job& job)
+{
+    std::lock_guard<std::mutex> lock(m_mainThreadQueue.mutex);
+    if (m_mainThreadQueue.jobs.empty()) return false;
+
+    job = std::move(m_mainThreadQueue.jobs.front());
+    m_mainThreadQueue.jobs.pop_front();
+    return true;
+}
+
+void JobSystem::execute(Job& job)
+{
+    job.function();
+    job.function = nullptr;
+
+    if (job.counter) {
+        finish(*job.counter);
+    }
+}
+
+void JobSystem::finish(JobCounter& counter)
+{
+    std::vector<JobFunction> continuations;
+    {
+        std::lock_guard<std::mutex> lock(counter.m_mutex);
+        if (counter.m_value.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            continuations.swap(counter.m_continuations);
+        }
+    }
+
+    for (JobFunction& continuation : continuations) {
+        continuation();
+    }
+}
+
+void JobSystem::workerLoop(size_t index)
+{
+    t_owner = this;
+    t_queue = index;
+
+    while (true) {
+        if (tryRunJob()) continue;
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_sleepingWorkers.fetch_add(1);
+        m_wake.wait(lock, [this] { return m_stopping || m_queuedJobs.load() > 0; });
+        m_sleepingWorkers.fetch_sub(1);
+
+        if (m_stopping && m_queuedJobs.load() == 0) return;
+    }
+}
+
+size_t JobSystem::localQueue() const
+{
+    return t_owner == this ? t_queue : m_workers.size();
+}
+
+}
+}
@@ -10,6 +10,7 @@
 #include "editor/mainwindow.h"
 #include "editor/projectmanager.h"
 #include "editor/splashscreen.h"
+#include "jobs/jobsystem.h"
 
 int main(int argc, char* argv[])
 {
@@ -19,6 +20,9 @@ int main(int argc, char* argv[])
     
     app.setQuitOnLastWindowClosed(true);
 
+    // Start the workers here so this thread owns main-thread jobs
+    DabozzEngine::Jobs::JobSystem::instance();
+
     // Session-based suppression
     QString lockFilePath = QDir::tempPath() + "/dabozz_editor_session.lock";
     bool sessionActive = QFile::exists(lockFilePath);
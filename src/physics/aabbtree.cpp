@@ -0,0 +1,292 @@
+#include "physics/aabbtree.h"
+#include <algorithm>
+#include <cmath>
+
+namespace DabozzEngine::Physics {
+
+// How far ahead of its last displacement a moving proxy's box reaches
+static constexpr float DISPLACEMENT_MULTIPLIER = 2.0f;
+
+int DynamicAABBTree::createProxy(const AABB& bounds, int userData)
+{
+    const QVector3D margin(FAT_MARGIN, FAT_MARGIN, FAT_MARGIN);
+
+    int proxy = allocateNode();
+    Node& node = m_nodes[proxy];
+    node.bounds.min = bounds.min - margin;
+    node.bounds.max = bounds.max + margin;
+    node.userData = userData;
+    node.height = 0;
+    insertLeaf(proxy);
+    return proxy;
+}
+
+void DynamicAABBTree::destroyProxy(int proxy)
+{
+    removeLeaf(proxy);
+    freeNode(proxy);
+}
+
+bool DynamicAABBTree::moveProxy(int proxy, const AABB& bounds, const QVector3D& displacement)
+{
+    const QVector3D margin(FAT_MARGIN, FAT_MARGIN, FAT_MARGIN);
+    AABB fat{ bounds.min - margin, bounds.max + margin };
+
+    const AABB& current = m_nodes[proxy].bounds;
+    if (contains(current, bounds)) {
+        // Still inside, unless the box has grown far too loose around a
+        // body that has slowed down
+        const QVector3D slack = margin * 4.0f;
+        const AABB loosest{ fat.min - slack, fat.max + slack };
+        if (contains(loosest, current)) return false;
+    }
+
+    // Stretch the box the way the body is heading
+    const QVector3D predicted = displacement * DISPLACEMENT_MULTIPLIER;
+    if (predicted.x() < 0.0f) fat.min.setX(fat.min.x() + predicted.x()); else fat.max.setX(fat.max.x() + predicted.x());
+    if (predicted.y() < 0.0f) fat.min.setY(fat.min.y() + predicted.y()); else fat.max.setY(fat.max.y() + predicted.y());
+    if (predicted.z() < 0.0f) fat.min.setZ(fat.min.z() + predicted.z()); else fat.max.setZ(fat.max.z() + predicted.z());
+
+    removeLeaf(proxy);
+    m_nodes[proxy].bounds = fat;
+    insertLeaf(proxy);
+    return true;
+}
+
+void DynamicAABBTree::clear()
+{
+    m_nodes.clear();
+    m_root = -1;
+    m_freeList = -1;
+}
+
+int DynamicAABBTree::allocateNode()
+{
+    if (m_freeList < 0) {
+        m_nodes.emplace_back();
+        return static_cast<int>(m_nodes.size() - 1);
+    }
+
+    int node = m_freeList;
+    m_freeList = m_nodes[node].parent;
+    m_nodes[node] = Node();
+    return node;
+}
+
+void DynamicAABBTree::freeNode(int node)
+{
+    m_nodes[node].parent = m_freeList;
+    m_nodes[node].height = -1;
+    m_freeList = node;
+}
+
+void DynamicAABBTree::insertLeaf(int leaf)
+{
+    if (m_root < 0) {
+        m_root = leaf;
+        m_nodes[leaf].parent = -1;
+        return;
+    }
+
+    // Walk down to the sibling that makes the tree grow least
+    const AABB leafBounds = m_nodes[leaf].bounds;
+    int index = m_root;
+    while (!m_nodes[index].isLeaf()) {
+        const Node& node = m_nodes[index];
+        const float nodeArea = area(node.bounds);
+        const float combinedArea = area(combine(node.bounds, leafBounds));
+
+        // Pairing with this node makes a new parent here; going further down
+        // makes every node on the way grow
+        const float cost = 2.0f * combinedArea;
+        const float inheritedCost = 2.0f * (combinedArea - nodeArea);
+
+        auto descendCost = [&](int child) {
+            const Node& childNode = m_nodes[child];
+            const float grownArea = area(combine(leafBounds, childNode.bounds));
+            return childNode.isLeaf() ? grownArea + inheritedCost
+                                      : grownArea - area(childNode.bounds) + inheritedCost;
+        };
+        const float cost1 = descendCost(node.child1);
+        const float cost2 = descendCost(node.child2);
+
+        if (cost < cost1 && cost < cost2) break;
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+
+    const int sibling = index;
+    const int oldParent = m_nodes[sibling].parent;
+    const int newParent = allocateNode();
+    m_nodes[newParent].parent = oldParent;
+    m_nodes[newParent].bounds = combine(leafBounds, m_nodes[sibling].bounds);
+    m_nodes[newParent].height = m_nodes[sibling].height + 1;
+    m_nodes[newParent].child1 = sibling;
+    m_nodes[newParent].child2 = leaf;
+    m_nodes[sibling].parent = newParent;
+    m_nodes[leaf].parent = newParent;
+
+    if (oldParent < 0) {
+        m_root = newParent;
+    } else if (m_nodes[oldParent].child1 == sibling) {
+        m_nodes[oldParent].child1 = newParent;
+    } else {
+        m_nodes[oldParent].child2 = newParent;
+    }
+
+    // Refit and rebalance on the way back up
+    index = m_nodes[leaf].parent;
+    while (index >= 0) {
+        index = balance(index);
+        Node& node = m_nodes[index];
+        node.height = 1 + std::max(m_nodes[node.child1].height, m_nodes[node.child2].height);
+        node.bounds = combine(m_nodes[node.child1].bounds, m_nodes[node.child2].bounds);
+        index = node.parent;
+    }
+}
+
+void DynamicAABBTree::removeLeaf(int leaf)
+{
+    if (leaf == m_root) {
+        m_root = -1;
+        return;
+    }
+
+    const int parent = m_nodes[leaf].parent;
+    const int grandParent = m_nodes[parent].parent;
+    const int sibling = m_nodes[parent].child1 == leaf ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+    freeNode(parent);
+    if (grandParent < 0) {
+        m_root = sibling;
+        m_nodes[sibling].parent = -1;
+        return;
+    }
+
+    // The sibling takes the parent's place
+    if (m_nodes[grandParent].child1 == parent) {
+        m_nodes[grandParent].child1 = sibling;
+    } else {
+        m_nodes[grandParent].child2 = sibling;
+    }
+    m_nodes[sibling].parent = grandParent;
+
+    int index = grandParent;
+    while (index >= 0) {
+        index = balance(index);
+        Node& node = m_nodes[index];
+        node.height = 1 + std::max(m_nodes[node.child1].height, m_nodes[node.child2].height);
+        node.bounds = combine(m_nodes[node.child1].bounds, m_nodes[node.child2].bounds);
+        index = node.parent;
+    }
+}
+
+int DynamicAABBTree::balance(int indexA)
+{
+    Node& a = m_nodes[indexA];
+    if (a.isLeaf() || a.height < 2) return indexA;
+
+    const int indexB = a.child1;
+    const int indexC = a.child2;
+    Node& b = m_nodes[indexB];
+    Node& c = m_nodes[indexC];
+    const int heightDifference = c.height - b.height;
+
+    // Rotates child up into a's place; a keeps other and the shorter of
+    // child's children
+    auto rotateUp = [&](int indexUp, Node& up, Node& other, bool upWasChild2) {
+        const int indexF = up.child1;
+        const int indexG = up.child2;
+        Node& f = m_nodes[indexF];
+        Node& g = m_nodes[indexG];
+
+        up.child1 = indexA;
+        up.parent = a.parent;
+        a.parent = indexUp;
+
+        if (up.parent < 0) {
+            m_root = indexUp;
+        } else if (m_nodes[up.parent].child1 == indexA) {
+            m_nodes[up.parent].child1 = indexUp;
+        } else {
+            m_nodes[up.parent].child2 = indexUp;
+        }
+
+        const bool keepF = f.height > g.height;
+        const int indexKept = keepF ? indexF : indexG;
+        const int indexGiven = keepF ? indexG : indexF;
+        Node& kept = m_nodes[indexKept];
+        Node& given = m_nodes[indexGiven];
+
+        up.child2 = indexKept;
+        if (upWasChild2) {
+            a.child2 = indexGiven;
+        } else {
+            a.child1 = indexGiven;
+        }
+        given.parent = indexA;
+
+        a.bounds = combine(other.bounds, given.bounds);
+        a.height = 1 + std::max(other.height, given.height);
+        up.bounds = combine(a.bounds, kept.bounds);
+        up.height = 1 + std::max(a.height, kept.height);
+        return indexUp;
+    };
+
+    if (heightDifference > 1) return rotateUp(indexC, c, b, true);
+    if (heightDifference < -1) return rotateUp(indexB, b, c, false);
+    return indexA;
+}
+
+bool DynamicAABBTree::overlaps(const AABB& a, const AABB& b)
+{
+    return (a.min.x() <= b.max.x() && a.max.x() >= b.min.x()) &&
+           (a.min.y() <= b.max.y() && a.max.y() >= b.min.y()) &&
+           (a.min.z() <= b.max.z() && a.max.z() >= b.min.z());
+}
+
+bool DynamicAABBTree::contains(const AABB& outer, const AABB& inner)
+{
+    return outer.min.x() <= inner.min.x() && outer.min.y() <= inner.min.y() && outer.min.z() <= inner.min.z()
+        && inner.max.x() <= outer.max.x() && inner.max.y() <= outer.max.y() && inner.max.z() <= outer.max.z();
+}
+
+AABB DynamicAABBTree::combine(const AABB& a, const AABB& b)
+{
+    return AABB{
+        QVector3D(std::min(a.min.x(), b.min.x()), std::min(a.min.y(), b.min.y()), std::min(a.min.z(), b.min.z())),
+        QVector3D(std::max(a.max.x(), b.max.x()), std::max(a.max.y(), b.max.y()), std::max(a.max.z(), b.max.z()))
+    };
+}
+
+float DynamicAABBTree::area(const AABB& bounds)
+{
+    const QVector3D size = bounds.max - bounds.min;
+    return 2.0f * (size.x() * size.y() + size.y() * size.z() + size.z() * size.x());
+}
+
+bool DynamicAABBTree::rayEnters(const QVector3D& origin, const QVector3D& inverseDirection, const AABB& bounds, float maxDistance, float& distance)
+{
+    float near = 0.0f;
+    float far = maxDistance;
+    for (int axis = 0; axis < 3; ++axis) {
+        const float o = origin[axis];
+        const float inverse = inverseDirection[axis];
+        if (std::isinf(inverse)) {
+            // Parallel to this slab: inside it or never
+            if (o < bounds.min[axis] || o > bounds.max[axis]) return false;
+            continue;
+        }
+
+        float t1 = (bounds.min[axis] - o) * inverse;
+        float t2 = (bounds.max[axis] - o) * inverse;
+        if (t1 > t2) std::swap(t1, t2);
+        near = std::max(near, t1);
+        far = std::min(far, t2);
+        if (near > far) return false;
+    }
+
+    distance = near;
+    return true;
+}
+
+}
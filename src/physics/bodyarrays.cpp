@@ -0,0 +1,397 @@
+#include "physics/bodyarrays.h"
+#include <algorithm>
+
+#if !defined(BUTSURI_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64))
+#define BUTSURI_SSE2 1
+#include <immintrin.h>
+#endif
+#if defined(BUTSURI_SSE2) && defined(__AVX__)
+#define BUTSURI_AVX 1
+#endif
+
+namespace DabozzEngine::Physics {
+
+namespace {
+
+using Column = std::vector<float> BodyArrays::*;
+
+const Column COLUMNS[] = {
+    &BodyArrays::positionX, &BodyArrays::positionY, &BodyArrays::positionZ,
+    &BodyArrays::velocityX, &BodyArrays::velocityY, &BodyArrays::velocityZ,
+    &BodyArrays::extentX, &BodyArrays::extentY, &BodyArrays::extentZ,
+    &BodyArrays::minX, &BodyArrays::minY, &BodyArrays::minZ,
+    &BodyArrays::maxX, &BodyArrays::maxY, &BodyArrays::maxZ,
+    &BodyArrays::inverseMass, &BodyArrays::moving, &BodyArrays::sphere,
+};
+
+// The kernels are written once against these, and run with those of the
+// current path for the bulk of the bodies and ScalarOps for what's left.
+struct ScalarOps {
+    static constexpr size_t WIDTH = 1;
+    using Reg = float;
+    using Mask = bool;
+
+    static Reg load(const float* p) { return *p; }
+    static void store(float* p, Reg v) { *p = v; }
+    static Reg splat(float v) { return v; }
+    static Reg gather(const float* base, const int* index) { return base[*index]; }
+
+    static Reg add(Reg a, Reg b) { return a + b; }
+    static Reg sub(Reg a, Reg b) { return a - b; }
+    static Reg mul(Reg a, Reg b) { return a * b; }
+    static Reg min(Reg a, Reg b) { return std::min(a, b); }
+    static Reg max(Reg a, Reg b) { return std::max(a, b); }
+
+    static Mask less(Reg a, Reg b) { return a < b; }
+    static Mask lessEqual(Reg a, Reg b) { return a <= b; }
+    static Mask isSet(Reg flag) { return flag != 0.0f; }
+    static Mask both(Mask a, Mask b) { return a && b; }
+    static Mask either(Mask a, Mask b) { return a || b; }
+    static Mask andNot(Mask a, Mask b) { return !a && b; }
+    static Reg select(Mask m, Reg a, Reg b) { return m ? a : b; }
+    static void storeMask(uint8_t* out, Mask m) { *out = m ? 1 : 0; }
+};
+
+#ifdef BUTSURI_AVX
+
+struct AvxOps {
+    static constexpr size_t WIDTH = 8;
+    using Reg = __m256;
+    using Mask = __m256;
+
+    static Reg load(const float* p) { return _mm256_loadu_ps(p); }
+    static void store(float* p, Reg v) { _mm256_storeu_ps(p, v); }
+    static Reg splat(float v) { return _mm256_set1_ps(v); }
+    static Reg gather(const float* base, const int* index) {
+        return _mm256_setr_ps(base[index[0]], base[index[1]], base[index[2]], base[index[3]],
+                              base[index[4]], base[index[5]], base[index[6]], base[index[7]]);
+    }
+
+    static Reg add(Reg a, Reg b) { return _mm256_add_ps(a, b); }
+    static Reg sub(Reg a, Reg b) { return _mm256_sub_ps(a, b); }
+    static Reg mul(Reg a, Reg b) { return _mm256_mul_ps(a, b); }
+    static Reg min(Reg a, Reg b) { return _mm256_min_ps(a, b); }
+    static Reg max(Reg a, Reg b) { return _mm256_max_ps(a, b); }
+
+    static Mask less(Reg a, Reg b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static Mask lessEqual(Reg a, Reg b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+    static Mask isSet(Reg flag) { return _mm256_cmp_ps(flag, _mm256_setzero_ps(), _CMP_NEQ_UQ); }
+    static Mask both(Mask a, Mask b) { return _mm256_and_ps(a, b); }
+    static Mask either(Mask a, Mask b) { return _mm256_or_ps(a, b); }
+    static Mask andNot(Mask a, Mask b) { return _mm256_andnot_ps(a, b); }
+    static Reg select(Mask m, Reg a, Reg b) { return _mm256_blendv_ps(b, a, m); }
+    static void storeMask(uint8_t* out, Mask m) {
+        const int bits = _mm256_movemask_ps(m);
+        for (size_t lane = 0; lane < WIDTH; ++lane) out[lane] = (bits >> lane) & 1;
+    }
+};
+
+#endif
+
+#ifdef BUTSURI_SSE2
+
+struct Sse2Ops {
+    static constexpr size_t WIDTH = 4;
+    using Reg = __m128;
+    using Mask = __m128;
+
+    static Reg load(const float* p) { return _mm_loadu_ps(p); }
+    static void store(float* p, Reg v) { _mm_storeu_ps(p, v); }
+    static Reg splat(float v) { return _mm_set1_ps(v); }
+    static Reg gather(const float* base, const int* index) {
+        return _mm_setr_ps(base[index[0]], base[index[1]], base[index[2]], base[index[3]]);
+    }
+
+    static Reg add(Reg a, Reg b) { return _mm_add_ps(a, b); }
+    static Reg sub(Reg a, Reg b) { return _mm_sub_ps(a, b); }
+    static Reg mul(Reg a, Reg b) { return _mm_mul_ps(a, b); }
+    static Reg min(Reg a, Reg b) { return _mm_min_ps(a, b); }
+    static Reg max(Reg a, Reg b) { return _mm_max_ps(a, b); }
+
+    static Mask less(Reg a, Reg b) { return _mm_cmplt_ps(a, b); }
+    static Mask lessEqual(Reg a, Reg b) { return _mm_cmple_ps(a, b); }
+    static Mask isSet(Reg flag) { return _mm_cmpneq_ps(flag, _mm_setzero_ps()); }
+    static Mask both(Mask a, Mask b) { return _mm_and_ps(a, b); }
+    static Mask either(Mask a, Mask b) { return _mm_or_ps(a, b); }
+    static Mask andNot(Mask a, Mask b) { return _mm_andnot_ps(a, b); }
+    static Reg select(Mask m, Reg a, Reg b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+    static void storeMask(uint8_t* out, Mask m) {
+        const int bits = _mm_movemask_ps(m);
+        for (size_t lane = 0; lane < WIDTH; ++lane) out[lane] = (bits >> lane) & 1;
+    }
+};
+
+#endif
+
+#if defined(BUTSURI_AVX)
+constexpr SimdPath WIDEST_PATH = SimdPath::AVX;
+#elif defined(BUTSURI_SSE2)
+constexpr SimdPath WIDEST_PATH = SimdPath::SSE2;
+#else
+constexpr SimdPath WIDEST_PATH = SimdPath::Scalar;
+#endif
+
+SimdPath g_simdPath = WIDEST_PATH;
+
+// Runs kernel(ops, start) with the ops of the current path over the bulk of
+// the bodies, then with ScalarOps from where that stopped
+template<typename Kernel>
+void runLanes(Kernel&& kernel)
+{
+    size_t done = 0;
+    switch (g_simdPath) {
+#ifdef BUTSURI_AVX
+    case SimdPath::AVX:
+        done = kernel(AvxOps(), size_t(0));
+        break;
+#endif
+#ifdef BUTSURI_SSE2
+    case SimdPath::SSE2:
+        done = kernel(Sse2Ops(), size_t(0));
+        break;
+#endif
+    default:
+        break;
+    }
+    kernel(ScalarOps(), done);
+}
+
+// Each returns where it stopped, for the next, narrower pass to go on from
+template<typename Ops>
+size_t integrateGravityLanes(BodyArrays& b, size_t i, const QVector3D& gravityStep)
+{
+    const typename Ops::Reg gx = Ops::splat(gravityStep.x());
+    const typename Ops::Reg gy = Ops::splat(gravityStep.y());
+    const typename Ops::Reg gz = Ops::splat(gravityStep.z());
+
+    for (; i + Ops::WIDTH <= b.size(); i += Ops::WIDTH) {
+        // Static and sleeping bodies get nothing added
+        const typename Ops::Reg moving = Ops::load(&b.moving[i]);
+        Ops::store(&b.velocityX[i], Ops::add(Ops::load(&b.velocityX[i]), Ops::mul(gx, moving)));
+        Ops::store(&b.velocityY[i], Ops::add(Ops::load(&b.velocityY[i]), Ops::mul(gy, moving)));
+        Ops::store(&b.velocityZ[i], Ops::add(Ops::load(&b.velocityZ[i]), Ops::mul(gz, moving)));
+    }
+    return i;
+}
+
+template<typename Ops>
+size_t integratePositionsLanes(BodyArrays& b, size_t i, float deltaTime, float floorY)
+{
+    const typename Ops::Reg dt = Ops::splat(deltaTime);
+    const typename Ops::Reg floor = Ops::splat(floorY);
+    const typename Ops::Reg zero = Ops::splat(0.0f);
+
+    for (; i + Ops::WIDTH <= b.size(); i += Ops::WIDTH) {
+        const typename Ops::Reg moving = Ops::load(&b.moving[i]);
+        const typename Ops::Reg vy = Ops::load(&b.velocityY[i]);
+        const typename Ops::Reg ey = Ops::load(&b.extentY[i]);
+
+        Ops::store(&b.positionX[i], Ops::add(Ops::load(&b.positionX[i]), Ops::mul(Ops::mul(Ops::load(&b.velocityX[i]), dt), moving)));
+        Ops::store(&b.positionZ[i], Ops::add(Ops::load(&b.positionZ[i]), Ops::mul(Ops::mul(Ops::load(&b.velocityZ[i]), dt), moving)));
+        const typename Ops::Reg y = Ops::add(Ops::load(&b.positionY[i]), Ops::mul(Ops::mul(vy, dt), moving));
+
+        // Hard clamp to prevent falling through floor
+        const typename Ops::Mask below = Ops::both(Ops::isSet(moving), Ops::less(Ops::sub(y, ey), floor));
+        Ops::store(&b.positionY[i], Ops::select(below, Ops::add(floor, ey), y));
+        Ops::store(&b.velocityY[i], Ops::select(below, zero, vy));
+    }
+    return i;
+}
+
+template<typename Ops>
+size_t refreshBoundsLanes(BodyArrays& b, size_t i)
+{
+    for (; i + Ops::WIDTH <= b.size(); i += Ops::WIDTH) {
+        const typename Ops::Reg x = Ops::load(&b.positionX[i]);
+        const typename Ops::Reg y = Ops::load(&b.positionY[i]);
+        const typename Ops::Reg z = Ops::load(&b.positionZ[i]);
+        const typename Ops::Reg ex = Ops::load(&b.extentX[i]);
+        const typename Ops::Reg ey = Ops::load(&b.extentY[i]);
+        const typename Ops::Reg ez = Ops::load(&b.extentZ[i]);
+        Ops::store(&b.minX[i], Ops::sub(x, ex));
+        Ops::store(&b.minY[i], Ops::sub(y, ey));
+        Ops::store(&b.minZ[i], Ops::sub(z, ez));
+        Ops::store(&b.maxX[i], Ops::add(x, ex));
+        Ops::store(&b.maxY[i], Ops::add(y, ey));
+        Ops::store(&b.maxZ[i], Ops::add(z, ez));
+    }
+    return i;
+}
+
+template<typename Ops>
+size_t findTouchingLanes(const BodyArrays& b, size_t body, const int* others, size_t k, size_t count, uint8_t* touching)
+{
+    using Reg = typename Ops::Reg;
+    using Mask = typename Ops::Mask;
+
+    const Reg aMinX = Ops::splat(b.minX[body]), aMinY = Ops::splat(b.minY[body]), aMinZ = Ops::splat(b.minZ[body]);
+    const Reg aMaxX = Ops::splat(b.maxX[body]), aMaxY = Ops::splat(b.maxY[body]), aMaxZ = Ops::splat(b.maxZ[body]);
+    const Reg aX = Ops::splat(b.positionX[body]), aY = Ops::splat(b.positionY[body]), aZ = Ops::splat(b.positionZ[body]);
+    const Reg aRadius = Ops::splat(b.extentX[body]);
+    const Mask aSphere = Ops::isSet(Ops::splat(b.sphere[body]));
+
+    for (; k + Ops::WIDTH <= count; k += Ops::WIDTH) {
+        const int* index = others + k;
+        const Reg bMinX = Ops::gather(b.minX.data(), index), bMinY = Ops::gather(b.minY.data(), index), bMinZ = Ops::gather(b.minZ.data(), index);
+        const Reg bMaxX = Ops::gather(b.maxX.data(), index), bMaxY = Ops::gather(b.maxY.data(), index), bMaxZ = Ops::gather(b.maxZ.data(), index);
+        const Reg bX = Ops::gather(b.positionX.data(), index), bY = Ops::gather(b.positionY.data(), index), bZ = Ops::gather(b.positionZ.data(), index);
+        const Reg bRadius = Ops::gather(b.extentX.data(), index);
+        const Mask bSphere = Ops::isSet(Ops::gather(b.sphere.data(), index));
+
+        // Tight boxes first, for every shape
+        const Mask overlap = Ops::both(
+            Ops::both(Ops::both(Ops::lessEqual(aMinX, bMaxX), Ops::lessEqual(bMinX, aMaxX)),
+                      Ops::both(Ops::lessEqual(aMinY, bMaxY), Ops::lessEqual(bMinY, aMaxY))),
+            Ops::both(Ops::lessEqual(aMinZ, bMaxZ), Ops::lessEqual(bMinZ, aMaxZ)));
+
+        // Sphere against sphere: centres closer than the radii together
+        const Reg dx = Ops::sub(aX, bX), dy = Ops::sub(aY, bY), dz = Ops::sub(aZ, bZ);
+        const Reg reach = Ops::add(aRadius, bRadius);
+        const Mask spheresHit = Ops::less(Ops::add(Ops::add(Ops::mul(dx, dx), Ops::mul(dy, dy)), Ops::mul(dz, dz)), Ops::mul(reach, reach));
+
+        // Sphere against box: the box point closest to the centre is inside
+        const Reg boxMinX = Ops::select(aSphere, bMinX, aMinX), boxMaxX = Ops::select(aSphere, bMaxX, aMaxX);
+        const Reg boxMinY = Ops::select(aSphere, bMinY, aMinY), boxMaxY = Ops::select(aSphere, bMaxY, aMaxY);
+        const Reg boxMinZ = Ops::select(aSphere, bMinZ, aMinZ), boxMaxZ = Ops::select(aSphere, bMaxZ, aMaxZ);
+        const Reg cx = Ops::select(aSphere, aX, bX), cy = Ops::select(aSphere, aY, bY), cz = Ops::select(aSphere, aZ, bZ);
+        const Reg radius = Ops::select(aSphere, aRadius, bRadius);
+        const Reg ox = Ops::sub(Ops::max(boxMinX, Ops::min(cx, boxMaxX)), cx);
+        const Reg oy = Ops::sub(Ops::max(boxMinY, Ops::min(cy, boxMaxY)), cy);
+        const Reg oz = Ops::sub(Ops::max(boxMinZ, Ops::min(cz, boxMaxZ)), cz);
+        const Mask boxHit = Ops::less(Ops::add(Ops::add(Ops::mul(ox, ox), Ops::mul(oy, oy)), Ops::mul(oz, oz)), Ops::mul(radius, radius));
+
+        const Mask anySphere = Ops::either(aSphere, bSphere);
+        const Mask twoSpheres = Ops::both(aSphere, bSphere);
+        const Mask mixed = Ops::andNot(twoSpheres, anySphere);
+        const Mask shapesHit = Ops::either(Ops::both(twoSpheres, spheresHit), Ops::both(mixed, boxHit));
+        Ops::storeMask(touching + k, Ops::either(Ops::andNot(anySphere, overlap), Ops::both(overlap, shapesHit)));
+    }
+    return k;
+}
+
+}
+
+void BodyArrays::add(const QVector3D& position, const QVector3D& extent, float bodyInverseMass, bool isSphere, bool isMoving)
+{
+    positionX.push_back(position.x());
+    positionY.push_back(position.y());
+    positionZ.push_back(position.z());
+    velocityX.push_back(0.0f);
+    velocityY.push_back(0.0f);
+    velocityZ.push_back(0.0f);
+    extentX.push_back(extent.x());
+    extentY.push_back(extent.y());
+    extentZ.push_back(extent.z());
+    minX.push_back(position.x() - extent.x());
+    minY.push_back(position.y() - extent.y());
+    minZ.push_back(position.z() - extent.z());
+    maxX.push_back(position.x() + extent.x());
+    maxY.push_back(position.y() + extent.y());
+    maxZ.push_back(position.z() + extent.z());
+    inverseMass.push_back(bodyInverseMass);
+    moving.push_back(isMoving ? 1.0f : 0.0f);
+    sphere.push_back(isSphere ? 1.0f : 0.0f);
+}
+
+void BodyArrays::swapRemove(size_t index)
+{
+    for (Column column : COLUMNS) {
+        std::vector<float>& values = this->*column;
+        values[index] = values.back();
+        values.pop_back();
+    }
+}
+
+void BodyArrays::reserve(size_t count)
+{
+    for (Column column : COLUMNS) {
+        (this->*column).reserve(count);
+    }
+}
+
+void BodyArrays::clear()
+{
+    for (Column column : COLUMNS) {
+        (this->*column).clear();
+    }
+}
+
+void BodyArrays::setPosition(size_t i, const QVector3D& position)
+{
+    positionX[i] = position.x();
+    positionY[i] = position.y();
+    positionZ[i] = position.z();
+}
+
+void BodyArrays::setVelocity(size_t i, const QVector3D& velocity)
+{
+    velocityX[i] = velocity.x();
+    velocityY[i] = velocity.y();
+    velocityZ[i] = velocity.z();
+}
+
+void BodyArrays::fitBounds(size_t i)
+{
+    minX[i] = positionX[i] - extentX[i];
+    minY[i] = positionY[i] - extentY[i];
+    minZ[i] = positionZ[i] - extentZ[i];
+    maxX[i] = positionX[i] + extentX[i];
+    maxY[i] = positionY[i] + extentY[i];
+    maxZ[i] = positionZ[i] + extentZ[i];
+}
+
+SimdPath widestSimdPath()
+{
+    return WIDEST_PATH;
+}
+
+SimdPath simdPath()
+{
+    return g_simdPath;
+}
+
+bool setSimdPath(SimdPath path)
+{
+    if (path > WIDEST_PATH) return false;
+    g_simdPath = path;
+    return true;
+}
+
+const char* simdPathName(SimdPath path)
+{
+    switch (path) {
+    case SimdPath::AVX: return "AVX";
+    case SimdPath::SSE2: return "SSE2";
+    default: return "scalar";
+    }
+}
+
+void integrateGravity(BodyArrays& bodies, const QVector3D& gravityStep)
+{
+    runLanes([&](auto ops, size_t start) {
+        return integrateGravityLanes<decltype(ops)>(bodies, start, gravityStep);
+    });
+}
+
+void integratePositions(BodyArrays& bodies, float deltaTime, float floorY)
+{
+    runLanes([&](auto ops, size_t start) {
+        return integratePositionsLanes<decltype(ops)>(bodies, start, deltaTime, floorY);
+    });
+}
+
+void refreshBounds(BodyArrays& bodies)
+{
+    runLanes([&](auto ops, size_t start) {
+        return refreshBoundsLanes<decltype(ops)>(bodies, start);
+    });
+}
+
+void findTouching(const BodyArrays& bodies, size_t body, const int* others, size_t count, uint8_t* touching)
+{
+    runLanes([&](auto ops, size_t start) {
+        return findTouchingLanes<decltype(ops)>(bodies, body, others, start, count, touching);
+    });
+}
+
+}
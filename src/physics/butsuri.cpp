@@ -1,13 +1,19 @@
 #include "physics/simplephysics.h"
 #include "debug/logger.h"
+#include "jobs/jobsystem.h"
 #include <algorithm>
+#include <chrono>
 #include <limits>
+#include <numeric>
 #include <cmath>
 
 namespace DabozzEngine::Physics {
 
 static ButsuriEngine* g_instance = nullptr;
 
+// Nothing falls below this
+static constexpr float FLOOR_Y = -4.75f;
+
 ButsuriEngine::ButsuriEngine()
     : m_gravity(0.0f, -9.81f, 0.0f)
 {
@@ -23,27 +29,85 @@ ButsuriEngine::~ButsuriEngine()
 void ButsuriEngine::initialize()
 {
     DEBUG_LOG << "Butsuri Engine initialized" << std::endl;
-    m_bodies.clear();
+    clearBodies();
 }
 
 void ButsuriEngine::shutdown()
 {
+    clearBodies();
+}
+
+void ButsuriEngine::clearBodies()
+{
+    // Slots are kept, so handles from before stay stale
+    for (BodyID bodyId : m_bodyIds) {
+        BodySlot& slot = m_slots[bodyIndex(bodyId)];
+        slot.dense = -1;
+        slot.generation = (slot.generation + 1) & BODY_GENERATION_MASK;
+        m_freeSlots.push_back(bodyIndex(bodyId));
+    }
     m_bodies.clear();
+    m_arrays.clear();
+    m_bodyIds.clear();
+    m_awakeBodies.clear();
+    m_islandHeads.clear();
+    m_freeIslands.clear();
+    m_tree.clear();
+    m_sweep.clear();
+    m_pairs.clear();
+}
+
+void ButsuriEngine::setBroadPhase(BroadPhase broadPhase)
+{
+    if (broadPhase == m_broadPhase) return;
+    m_broadPhase = broadPhase;
+    
+    m_sweep.clear();
+    for (size_t i = 0; i < m_bodies.size(); i++) {
+        BodyRecord& body = m_bodies[i];
+        body.sweepProxy = broadPhase == BroadPhase::SweepAndPrune
+            ? m_sweep.createProxy(m_arrays.bounds(i), static_cast<int>(i), body.isStatic || body.isSleeping)
+            : -1;
+    }
+    m_pairs.clear();
 }
 
 void ButsuriEngine::update(float deltaTime)
 {
+    if (m_timeToSleep > 0.0f) {
+        m_stepStarts.resize(m_bodies.size());
+        for (size_t i = 0; i < m_bodies.size(); i++) {
+            m_stepStarts[i] = m_arrays.position(i);
+        }
+    }
+    
     integrateVelocities(deltaTime);
     integratePositions(deltaTime);
     
+    const auto broadPhaseStart = std::chrono::steady_clock::now();
+    updateBroadPhase(deltaTime);
+    detectCollisions();
+    m_stepStats.pairCount = m_pairs.size();
+    m_stepStats.broadPhaseMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - broadPhaseStart).count();
+    
     // Multiple collision resolution iterations to prevent sinking
+    m_contacts.clear();
     for (int i = 0; i < 4; i++) {
-        detectCollisions();
         resolveCollisions();
     }
+    
+    // Bodies falling asleep below still moved this step
+    m_awakeBodies.clear();
+    for (size_t i = 0; i < m_bodies.size(); i++) {
+        if (!m_bodies[i].isStatic && !m_bodies[i].isSleeping) {
+            m_awakeBodies.push_back(m_bodyIds[i]);
+        }
+    }
+    
+    updateSleep(deltaTime);
 }
 
-int ButsuriEngine::createBody(const QVector3D& position, const QVector3D& size, float mass, bool isStatic)
+BodyID ButsuriEngine::createBody(const QVector3D& position, const QVector3D& size, float mass, bool isStatic)
 {
     RigidBodyState body;
     body.position = position;
@@ -61,11 +125,10 @@ int ButsuriEngine::createBody(const QVector3D& position, const QVector3D& size,
     body.bounds.min = position - halfSize;
     body.bounds.max = position + halfSize;
     
-    m_bodies.push_back(body);
-    return m_bodies.size() - 1;
+    return addBody(body, halfSize);
 }
 
-int ButsuriEngine::createSphereBody(const QVector3D& position, float radius, float mass, bool isStatic)
+BodyID ButsuriEngine::createSphereBody(const QVector3D& position, float radius, float mass, bool isStatic)
 {
     RigidBodyState body;
     body.position = position;
@@ -86,23 +149,234 @@ int ButsuriEngine::createSphereBody(const QVector3D& position, float radius, flo
     body.bounds.min = position - QVector3D(radius, radius, radius);
     body.bounds.max = position + QVector3D(radius, radius, radius);
     
+    return addBody(body, QVector3D(radius, radius, radius));
+}
+
+void ButsuriEngine::removeBody(BodyID bodyId)
+{
+    removeBodies(&bodyId, 1);
+}
+
+std::vector<BodyID> ButsuriEngine::createBodies(const BodyDesc* descs, size_t count)
+{
+    std::vector<BodyID> created;
+    created.reserve(count);
+    m_bodies.reserve(m_bodies.size() + count);
+    m_arrays.reserve(m_bodies.size() + count);
+    m_bodyIds.reserve(m_bodyIds.size() + count);
+    
+    for (size_t i = 0; i < count; i++) {
+        const BodyDesc& desc = descs[i];
+        BodyID bodyId = desc.colliderType == ColliderType::Sphere
+            ? createSphereBody(desc.position, desc.radius, desc.mass, desc.isStatic)
+            : createBody(desc.position, desc.size, desc.mass, desc.isStatic);
+        if (bodyId == INVALID_BODY) break;
+        created.push_back(bodyId);
+    }
+    return created;
+}
+
+void ButsuriEngine::removeBodies(const BodyID* bodies, size_t count)
+{
+    bool removed = false;
+    for (size_t i = 0; i < count; i++) {
+        const int index = findBody(bodies[i]);
+        if (index < 0) continue;
+        
+        // Whatever rested on it has to fall
+        wakeTouching(m_arrays.bounds(index));
+        eraseBody(index);
+        removed = true;
+    }
+    if (removed) m_pairs.clear();
+}
+
+bool ButsuriEngine::getBody(BodyID bodyId, RigidBodyState& state) const
+{
+    const int index = findBody(bodyId);
+    if (index < 0) return false;
+    
+    const BodyRecord& body = m_bodies[index];
+    state.position = m_arrays.position(index);
+    state.rotation = body.rotation;
+    state.velocity = m_arrays.velocity(index);
+    state.angularVelocity = body.angularVelocity;
+    state.mass = body.mass;
+    state.inverseMass = m_arrays.inverseMass[index];
+    state.isStatic = body.isStatic;
+    state.isSleeping = body.isSleeping;
+    state.colliderType = body.colliderType;
+    state.bounds = m_arrays.bounds(index);
+    state.sphere.center = state.position;
+    state.sphere.radius = m_arrays.extentX[index];
+    return true;
+}
+
+bool ButsuriEngine::getBodyPosition(BodyID bodyId, QVector3D& position) const
+{
+    const int index = findBody(bodyId);
+    if (index < 0) return false;
+    
+    position = m_arrays.position(index);
+    return true;
+}
+
+int ButsuriEngine::findBody(BodyID bodyId) const
+{
+    if (bodyId < 0) return -1;
+    
+    const uint32_t slot = bodyIndex(bodyId);
+    if (slot >= m_slots.size() || m_slots[slot].generation != bodyGeneration(bodyId)) return -1;
+    return m_slots[slot].dense;
+}
+
+BodyID ButsuriEngine::addBody(const RigidBodyState& state, const QVector3D& extent)
+{
+    uint32_t slot;
+    if (!m_freeSlots.empty()) {
+        slot = m_freeSlots.front();
+        m_freeSlots.pop_front();
+    } else if (m_slots.size() <= BODY_INDEX_MASK) {
+        m_slots.emplace_back();
+        slot = static_cast<uint32_t>(m_slots.size() - 1);
+    } else {
+        DEBUG_LOG << "Butsuri: body limit reached" << std::endl;
+        return INVALID_BODY;
+    }
+    
+    BodyRecord body;
+    body.rotation = state.rotation;
+    body.angularVelocity = state.angularVelocity;
+    body.mass = state.mass;
+    body.isStatic = state.isStatic;
+    body.isSleeping = false;
+    body.colliderType = state.colliderType;
+    
+    const int index = static_cast<int>(m_bodies.size());
+    body.proxy = m_tree.createProxy(state.bounds, index);
+    if (m_broadPhase == BroadPhase::SweepAndPrune) {
+        body.sweepProxy = m_sweep.createProxy(state.bounds, index, body.isStatic);
+    }
+    
+    m_slots[slot].dense = index;
+    const BodyID bodyId = makeBodyID(slot, m_slots[slot].generation);
     m_bodies.push_back(body);
-    return m_bodies.size() - 1;
+    m_arrays.add(state.position, extent, state.inverseMass, state.colliderType == ColliderType::Sphere, !state.isStatic);
+    m_bodyIds.push_back(bodyId);
+    return bodyId;
 }
 
-void ButsuriEngine::removeBody(int bodyId)
+void ButsuriEngine::eraseBody(size_t index)
 {
-    if (bodyId >= 0 && bodyId < (int)m_bodies.size()) {
-        m_bodies.erase(m_bodies.begin() + bodyId);
+    // The rest of its island lost whatever the body held up
+    if (m_bodies[index].isSleeping) {
+        wakeIsland(m_bodies[index].island);
+    }
+    
+    m_tree.destroyProxy(m_bodies[index].proxy);
+    if (m_bodies[index].sweepProxy >= 0) {
+        m_sweep.destroyProxy(m_bodies[index].sweepProxy);
     }
+    
+    const uint32_t freed = bodyIndex(m_bodyIds[index]);
+    m_slots[freed].dense = -1;
+    m_slots[freed].generation = (m_slots[freed].generation + 1) & BODY_GENERATION_MASK;
+    m_freeSlots.push_back(freed);
+    
+    // The last body fills the hole
+    const size_t last = m_bodies.size() - 1;
+    m_arrays.swapRemove(index);
+    if (index != last) {
+        m_bodies[index] = m_bodies[last];
+        m_bodyIds[index] = m_bodyIds[last];
+        m_slots[bodyIndex(m_bodyIds[index])].dense = static_cast<int>(index);
+        m_tree.setUserData(m_bodies[index].proxy, static_cast<int>(index));
+        if (m_bodies[index].sweepProxy >= 0) {
+            m_sweep.setUserData(m_bodies[index].sweepProxy, static_cast<int>(index));
+        }
+        
+        const BodyRecord& moved = m_bodies[index];
+        if (moved.isSleeping) {
+            if (moved.islandPrev >= 0) {
+                m_bodies[moved.islandPrev].islandNext = static_cast<int>(index);
+            } else {
+                m_islandHeads[moved.island] = static_cast<int>(index);
+            }
+            if (moved.islandNext >= 0) {
+                m_bodies[moved.islandNext].islandPrev = static_cast<int>(index);
+            }
+        }
+    }
+    m_bodies.pop_back();
+    m_bodyIds.pop_back();
+}
+
+void ButsuriEngine::wakeBody(BodyID bodyId)
+{
+    const int index = findBody(bodyId);
+    if (index >= 0) wakeIndex(index);
+}
+
+void ButsuriEngine::wakeIndex(size_t index)
+{
+    BodyRecord& body = m_bodies[index];
+    if (body.isStatic) return;
+    
+    body.sleepTime = 0.0f;
+    if (body.isSleeping) wakeIsland(body.island);
+}
+
+void ButsuriEngine::applyImpulse(BodyID bodyId, const QVector3D& impulse)
+{
+    const int index = findBody(bodyId);
+    if (index < 0 || m_bodies[index].isStatic) return;
+    
+    m_arrays.setVelocity(index, m_arrays.velocity(index) + impulse * m_arrays.inverseMass[index]);
+    wakeIndex(index);
+}
+
+void ButsuriEngine::setBodyVelocity(BodyID bodyId, const QVector3D& velocity)
+{
+    const int index = findBody(bodyId);
+    if (index < 0 || m_bodies[index].isStatic || m_arrays.velocity(index) == velocity) return;
+    
+    m_arrays.setVelocity(index, velocity);
+    wakeIndex(index);
 }
 
-RigidBodyState* ButsuriEngine::getBody(int bodyId)
+void ButsuriEngine::setBodyPosition(BodyID bodyId, const QVector3D& position)
 {
-    if (bodyId >= 0 && bodyId < (int)m_bodies.size()) {
-        return &m_bodies[bodyId];
+    const int index = findBody(bodyId);
+    if (index < 0 || m_arrays.position(index) == position) return;
+    
+    // Bodies resting on it lose their support, bodies at the new spot get hit
+    wakeTouching(m_arrays.bounds(index));
+    
+    m_arrays.setPosition(index, position);
+    m_arrays.fitBounds(index);
+    
+    wakeTouching(m_arrays.bounds(index));
+    wakeIndex(index);
+}
+
+void ButsuriEngine::setSleepThresholds(float velocity, float seconds)
+{
+    m_sleepVelocity = velocity;
+    m_timeToSleep = seconds;
+    if (seconds > 0.0f) return;
+    
+    for (size_t i = 0; i < m_bodies.size(); i++) {
+        if (m_bodies[i].isSleeping) wakeIsland(m_bodies[i].island);
+    }
+}
+
+void ButsuriEngine::setGravity(const QVector3D& gravity)
+{
+    m_gravity = gravity;
+    for (size_t i = 0; i < m_bodies.size(); i++) {
+        if (m_bodies[i].isSleeping) wakeIsland(m_bodies[i].island);
+        m_bodies[i].sleepTime = 0.0f;
     }
-    return nullptr;
 }
 
 ButsuriEngine* ButsuriEngine::getInstance()
@@ -112,75 +386,104 @@ ButsuriEngine* ButsuriEngine::getInstance()
 
 void ButsuriEngine::integrateVelocities(float deltaTime)
 {
-    for (auto& body : m_bodies) {
-        if (body.isStatic) continue;
+    // Static and sleeping bodies aren't moving in m_arrays, and are left be
+    integrateGravity(m_arrays, m_gravity * deltaTime);
+}
+
+void ButsuriEngine::updateBroadPhase(float deltaTime)
+{
+    // Also picks up static bodies moved through setBodyPosition()
+    for (size_t i = 0; i < m_bodies.size(); i++) {
+        const BodyRecord& body = m_bodies[i];
+        if (body.isSleeping) continue;
         
-        // Apply gravity
-        body.velocity += m_gravity * deltaTime;
+        const AABB bounds = m_arrays.bounds(i);
+        QVector3D displacement = body.isStatic ? QVector3D(0, 0, 0) : m_arrays.velocity(i) * deltaTime;
+        m_tree.moveProxy(body.proxy, bounds, displacement);
+        if (body.sweepProxy >= 0) {
+            m_sweep.moveProxy(body.sweepProxy, bounds);
+        }
     }
 }
 
 void ButsuriEngine::detectCollisions()
 {
-    // Simple broad phase - check all pairs
-    // TODO: Add spatial partitioning for better performance
+    // Fat boxes leave room for the resolution passes to push bodies around,
+    // so the pairs are only gathered once per step
+    if (m_broadPhase == BroadPhase::SweepAndPrune) {
+        m_sweep.findPairs(m_pairs, Jobs::JobSystem::instance());
+        return;
+    }
+    
+    m_pairs.clear();
+    for (size_t i = 0; i < m_bodies.size(); i++) {
+        if (m_bodies[i].isStatic || m_bodies[i].isSleeping) continue;
+        
+        const int self = static_cast<int>(i);
+        m_tree.query(m_tree.fatBounds(m_bodies[i].proxy), [&](int other) {
+            // Each pair of awake bodies is found from both sides, keep one.
+            // Static and sleeping bodies don't look for pairs themselves.
+            const bool passive = m_bodies[other].isStatic || m_bodies[other].isSleeping;
+            if (other == self || (!passive && other < self)) return true;
+            m_pairs.emplace_back(std::min(self, other), std::max(self, other));
+            return true;
+        });
+    }
+    
+    // Same order as walking all pairs, so results don't depend on tree shape
+    std::sort(m_pairs.begin(), m_pairs.end());
 }
 
 void ButsuriEngine::resolveCollisions()
 {
-    // Check all body pairs
-    for (size_t i = 0; i < m_bodies.size(); i++) {
-        for (size_t j = i + 1; j < m_bodies.size(); j++) {
-            if (m_bodies[i].isStatic && m_bodies[j].isStatic) continue;
-            
-            // Broad phase - AABB check first
-            if (!checkAABBCollision(m_bodies[i].bounds, m_bodies[j].bounds)) continue;
+    // Pairs are sorted, so each body's pairs come in one run, and the whole
+    // run is tested at once. A contact that moves the body means whatever is
+    // left of the run is tested again from there; the other bodies in it
+    // appear only once, so nothing else can change the answers.
+    size_t run = 0;
+    while (run < m_pairs.size()) {
+        const size_t i = m_pairs[run].first;
+        m_candidates.clear();
+        for (; run < m_pairs.size() && static_cast<size_t>(m_pairs[run].first) == i; run++) {
+            m_candidates.push_back(m_pairs[run].second);
+        }
+        
+        const size_t count = m_candidates.size();
+        m_touching.resize(count);
+        findTouching(m_arrays, i, m_candidates.data(), count, m_touching.data());
+        
+        for (size_t k = 0; k < count; k++) {
+            if (!m_touching[k]) continue;
+            const size_t j = m_candidates[k];
+            const QVector3D start = m_arrays.position(i);
             
-            // Narrow phase - check actual collider types
-            bool colliding = false;
-            if (m_bodies[i].colliderType == ColliderType::Box && m_bodies[j].colliderType == ColliderType::Box) {
-                colliding = true;
-                resolveAABBCollision(m_bodies[i], m_bodies[j]);
-            } else if (m_bodies[i].colliderType == ColliderType::Sphere && m_bodies[j].colliderType == ColliderType::Sphere) {
-                if (checkSphereCollision(m_bodies[i].sphere, m_bodies[j].sphere)) {
-                    resolveSphereCollision(m_bodies[i], m_bodies[j]);
-                    colliding = true;
-                }
+            const ColliderType typeI = m_bodies[i].colliderType;
+            const ColliderType typeJ = m_bodies[j].colliderType;
+            if (typeI == ColliderType::Box && typeJ == ColliderType::Box) {
+                resolveAABBCollision(i, j);
+            } else if (typeI == ColliderType::Sphere && typeJ == ColliderType::Sphere) {
+                resolveSphereCollision(i, j);
+            } else if (typeI == ColliderType::Box) {
+                resolveAABBSphereCollision(i, j);
             } else {
-                // One box, one sphere
-                RigidBodyState& box = (m_bodies[i].colliderType == ColliderType::Box) ? m_bodies[i] : m_bodies[j];
-                RigidBodyState& sphere = (m_bodies[i].colliderType == ColliderType::Sphere) ? m_bodies[i] : m_bodies[j];
-                if (checkAABBSphereCollision(box.bounds, sphere.sphere)) {
-                    resolveAABBSphereCollision(box, sphere);
-                    colliding = true;
-                }
+                resolveAABBSphereCollision(j, i);
             }
             
-            if (colliding) {
-                // Update AABBs after resolution
-                if (m_bodies[i].colliderType == ColliderType::Box) {
-                    QVector3D sizeI = m_bodies[i].bounds.max - m_bodies[i].bounds.min;
-                    QVector3D halfSizeI = sizeI * 0.5f;
-                    m_bodies[i].bounds.min = m_bodies[i].position - halfSizeI;
-                    m_bodies[i].bounds.max = m_bodies[i].position + halfSizeI;
-                } else {
-                    m_bodies[i].sphere.center = m_bodies[i].position;
-                    float r = m_bodies[i].sphere.radius;
-                    m_bodies[i].bounds.min = m_bodies[i].position - QVector3D(r, r, r);
-                    m_bodies[i].bounds.max = m_bodies[i].position + QVector3D(r, r, r);
-                }
-                
-                if (m_bodies[j].colliderType == ColliderType::Box) {
-                    QVector3D sizeJ = m_bodies[j].bounds.max - m_bodies[j].bounds.min;
-                    QVector3D halfSizeJ = sizeJ * 0.5f;
-                    m_bodies[j].bounds.min = m_bodies[j].position - halfSizeJ;
-                    m_bodies[j].bounds.max = m_bodies[j].position + halfSizeJ;
-                } else {
-                    m_bodies[j].sphere.center = m_bodies[j].position;
-                    float r = m_bodies[j].sphere.radius;
-                    m_bodies[j].bounds.min = m_bodies[j].position - QVector3D(r, r, r);
-                    m_bodies[j].bounds.max = m_bodies[j].position + QVector3D(r, r, r);
-                }
+            if (!m_bodies[i].isStatic && !m_bodies[j].isStatic) {
+                m_contacts.emplace_back(static_cast<int>(i), static_cast<int>(j));
+            }
+            
+            // Hit while asleep, wake up with the whole island
+            for (size_t index : { i, j }) {
+                if (m_bodies[index].isSleeping) wakeIsland(m_bodies[index].island);
+            }
+            
+            // Update AABBs after resolution
+            m_arrays.fitBounds(i);
+            m_arrays.fitBounds(j);
+            
+            if (k + 1 < count && m_arrays.position(i) != start) {
+                findTouching(m_arrays, i, m_candidates.data() + k + 1, count - k - 1, m_touching.data() + k + 1);
             }
         }
     }
@@ -188,64 +491,150 @@ void ButsuriEngine::resolveCollisions()
 
 void ButsuriEngine::integratePositions(float deltaTime)
 {
-    for (auto& body : m_bodies) {
-        if (body.isStatic) continue;
+    Physics::integratePositions(m_arrays, deltaTime, FLOOR_Y);
+    refreshBounds(m_arrays);
+}
+
+void ButsuriEngine::updateSleep(float deltaTime)
+{
+    if (m_timeToSleep <= 0.0f) return;
+    
+    // Islands are bodies in contact, directly or through other bodies.
+    // Static bodies don't join islands, or a whole level would be one.
+    const size_t count = m_bodies.size();
+    m_islandParents.resize(count);
+    std::iota(m_islandParents.begin(), m_islandParents.end(), 0);
+    for (const auto& contact : m_contacts) {
+        const int a = findIsland(contact.first);
+        const int b = findIsland(contact.second);
+        if (a != b) m_islandParents[std::max(a, b)] = std::min(a, b);
+    }
+    
+    // An island is as restless as its most restless body. Bodies resting
+    // in a stack keep some velocity that the contacts cancel out every step,
+    // so judge them by how far they actually moved.
+    const float sleepDistance = m_sleepVelocity * deltaTime;
+    const float sleepDistanceSquared = sleepDistance * sleepDistance;
+    m_islandSleepTimes.assign(count, std::numeric_limits<float>::max());
+    for (size_t i = 0; i < count; i++) {
+        BodyRecord& body = m_bodies[i];
+        if (body.isStatic || body.isSleeping) continue;
         
-        // Update position
-        body.position += body.velocity * deltaTime;
+        const bool still = (m_arrays.position(i) - m_stepStarts[i]).lengthSquared() < sleepDistanceSquared;
+        body.sleepTime = still ? body.sleepTime + deltaTime : 0.0f;
+        float& islandTime = m_islandSleepTimes[findIsland(static_cast<int>(i))];
+        islandTime = std::min(islandTime, body.sleepTime);
+    }
+    
+    m_islandIds.assign(count, -1);
+    for (size_t i = 0; i < count; i++) {
+        const BodyRecord& body = m_bodies[i];
+        if (body.isStatic || body.isSleeping) continue;
         
-        // Update collider and AABB based on type
-        if (body.colliderType == ColliderType::Box) {
-            QVector3D size = body.bounds.max - body.bounds.min;
-            QVector3D halfSize = size * 0.5f;
-            body.bounds.min = body.position - halfSize;
-            body.bounds.max = body.position + halfSize;
-            
-            // Hard clamp to prevent falling through floor
-            if (body.bounds.min.y() < -4.75f) {
-                float correction = -4.75f - body.bounds.min.y();
-                body.position.setY(body.position.y() + correction);
-                body.bounds.min.setY(-4.75f);
-                body.bounds.max.setY(body.bounds.min.y() + size.y());
-                body.velocity.setY(0);
-            }
-        } else {
-            // Sphere
-            body.sphere.center = body.position;
-            float r = body.sphere.radius;
-            body.bounds.min = body.position - QVector3D(r, r, r);
-            body.bounds.max = body.position + QVector3D(r, r, r);
-            
-            // Hard clamp for sphere
-            if (body.position.y() - r < -4.75f) {
-                body.position.setY(-4.75f + r);
-                body.sphere.center = body.position;
-                body.bounds.min = body.position - QVector3D(r, r, r);
-                body.bounds.max = body.position + QVector3D(r, r, r);
-                body.velocity.setY(0);
-            }
-        }
+        const int root = findIsland(static_cast<int>(i));
+        if (m_islandSleepTimes[root] < m_timeToSleep) continue;
+        if (m_islandIds[root] < 0) m_islandIds[root] = createIsland();
+        setAsleep(i, m_islandIds[root]);
+    }
+}
+
+int ButsuriEngine::findIsland(int index)
+{
+    while (m_islandParents[index] != index) {
+        m_islandParents[index] = m_islandParents[m_islandParents[index]];
+        index = m_islandParents[index];
+    }
+    return index;
+}
+
+void ButsuriEngine::setAwake(size_t index)
+{
+    BodyRecord& body = m_bodies[index];
+    body.isSleeping = false;
+    body.sleepTime = 0.0f;
+    body.island = -1;
+    body.islandPrev = -1;
+    body.islandNext = -1;
+    m_arrays.moving[index] = 1.0f;
+    if (body.sweepProxy >= 0) {
+        m_sweep.setProxyStatic(body.sweepProxy, false);
+    }
+}
+
+void ButsuriEngine::setAsleep(size_t index, int island)
+{
+    BodyRecord& body = m_bodies[index];
+    body.isSleeping = true;
+    body.island = island;
+    
+    // Pushed on the front of the island's chain
+    body.islandPrev = -1;
+    body.islandNext = m_islandHeads[island];
+    if (body.islandNext >= 0) {
+        m_bodies[body.islandNext].islandPrev = static_cast<int>(index);
+    }
+    m_islandHeads[island] = static_cast<int>(index);
+    
+    m_arrays.setVelocity(index, QVector3D(0, 0, 0));
+    m_arrays.moving[index] = 0.0f;
+    if (body.sweepProxy >= 0) {
+        m_sweep.setProxyStatic(body.sweepProxy, true);
+    }
+}
+
+int ButsuriEngine::createIsland()
+{
+    if (!m_freeIslands.empty()) {
+        const int island = m_freeIslands.back();
+        m_freeIslands.pop_back();
+        return island;
     }
+    m_islandHeads.push_back(-1);
+    return static_cast<int>(m_islandHeads.size() - 1);
 }
 
-bool ButsuriEngine::checkAABBCollision(const AABB& a, const AABB& b)
+void ButsuriEngine::wakeIsland(int island)
 {
-    return (a.min.x() <= b.max.x() && a.max.x() >= b.min.x()) &&
-           (a.min.y() <= b.max.y() && a.max.y() >= b.min.y()) &&
-           (a.min.z() <= b.max.z() && a.max.z() >= b.min.z());
+    int index = m_islandHeads[island];
+    while (index >= 0) {
+        const int next = m_bodies[index].islandNext;
+        setAwake(index);
+        index = next;
+    }
+    m_islandHeads[island] = -1;
+    m_freeIslands.push_back(island);
 }
 
-void ButsuriEngine::resolveAABBCollision(RigidBodyState& a, RigidBodyState& b)
+void ButsuriEngine::wakeTouching(const AABB& bounds)
 {
+    m_tree.query(bounds, [&](int other) {
+        if (m_bodies[other].isSleeping) wakeIndex(other);
+        return true;
+    });
+}
+
+void ButsuriEngine::resolveAABBCollision(size_t a, size_t b)
+{
+    const AABB boundsA = m_arrays.bounds(a);
+    const AABB boundsB = m_arrays.bounds(b);
+    const float inverseMassA = m_arrays.inverseMass[a];
+    const float inverseMassB = m_arrays.inverseMass[b];
+    const bool staticA = m_bodies[a].isStatic;
+    const bool staticB = m_bodies[b].isStatic;
+    QVector3D positionA = m_arrays.position(a);
+    QVector3D positionB = m_arrays.position(b);
+    QVector3D velocityA = m_arrays.velocity(a);
+    QVector3D velocityB = m_arrays.velocity(b);
+    
     // Calculate center-to-center vector
-    QVector3D centerA = (a.bounds.min + a.bounds.max) * 0.5f;
-    QVector3D centerB = (b.bounds.min + b.bounds.max) * 0.5f;
+    QVector3D centerA = (boundsA.min + boundsA.max) * 0.5f;
+    QVector3D centerB = (boundsB.min + boundsB.max) * 0.5f;
     QVector3D delta = centerB - centerA;
     
     // Calculate overlap on each axis
-    float overlapX = std::min(a.bounds.max.x() - b.bounds.min.x(), b.bounds.max.x() - a.bounds.min.x());
-    float overlapY = std::min(a.bounds.max.y() - b.bounds.min.y(), b.bounds.max.y() - a.bounds.min.y());
-    float overlapZ = std::min(a.bounds.max.z() - b.bounds.min.z(), b.bounds.max.z() - a.bounds.min.z());
+    float overlapX = std::min(boundsA.max.x() - boundsB.min.x(), boundsB.max.x() - boundsA.min.x());
+    float overlapY = std::min(boundsA.max.y() - boundsB.min.y(), boundsB.max.y() - boundsA.min.y());
+    float overlapZ = std::min(boundsA.max.z() - boundsB.min.z(), boundsB.max.z() - boundsA.min.z());
     
     // Find minimum overlap axis
     QVector3D normal;
@@ -263,23 +652,23 @@ void ButsuriEngine::resolveAABBCollision(RigidBodyState& a, RigidBodyState& b)
     }
     
     // Separate bodies more aggressively
-    float totalInverseMass = a.inverseMass + b.inverseMass;
+    float totalInverseMass = inverseMassA + inverseMassB;
     if (totalInverseMass > 0.0f) {
         float percent = 1.0f; // Full penetration correction
         float slop = 0.001f;
         QVector3D correction = normal * std::max(penetration - slop, 0.0f) * percent;
         
-        if (!a.isStatic) {
-            a.position -= correction * (a.inverseMass / totalInverseMass);
+        if (!staticA) {
+            positionA -= correction * (inverseMassA / totalInverseMass);
         }
-        if (!b.isStatic) {
-            b.position += correction * (b.inverseMass / totalInverseMass);
+        if (!staticB) {
+            positionB += correction * (inverseMassB / totalInverseMass);
         }
     }
     
     // Apply impulse with friction
     float restitution = 0.2f; // Low bounciness
-    QVector3D relativeVelocity = b.velocity - a.velocity;
+    QVector3D relativeVelocity = velocityB - velocityA;
     float velocityAlongNormal = QVector3D::dotProduct(relativeVelocity, normal);
     
     // Only resolve if objects are moving towards each other
@@ -289,67 +678,65 @@ void ButsuriEngine::resolveAABBCollision(RigidBodyState& a, RigidBodyState& b)
         
         QVector3D impulse = normal * j;
         
-        if (!a.isStatic) {
-            a.velocity -= impulse * a.inverseMass;
+        if (!staticA) {
+            velocityA -= impulse * inverseMassA;
             // Stop small velocities to prevent jitter
-            if (a.velocity.length() < 0.05f) {
-                a.velocity = QVector3D(0, 0, 0);
+            if (velocityA.length() < 0.05f) {
+                velocityA = QVector3D(0, 0, 0);
             }
         }
-        if (!b.isStatic) {
-            b.velocity += impulse * b.inverseMass;
-            if (b.velocity.length() < 0.05f) {
-                b.velocity = QVector3D(0, 0, 0);
+        if (!staticB) {
+            velocityB += impulse * inverseMassB;
+            if (velocityB.length() < 0.05f) {
+                velocityB = QVector3D(0, 0, 0);
             }
         }
     }
+    
+    m_arrays.setPosition(a, positionA);
+    m_arrays.setPosition(b, positionB);
+    m_arrays.setVelocity(a, velocityA);
+    m_arrays.setVelocity(b, velocityB);
 }
 
 }
 
-bool DabozzEngine::Physics::ButsuriEngine::checkSphereCollision(const Sphere& a, const Sphere& b)
-{
-    float distance = (a.center - b.center).length();
-    return distance < (a.radius + b.radius);
-}
-
-bool DabozzEngine::Physics::ButsuriEngine::checkAABBSphereCollision(const AABB& aabb, const Sphere& sphere)
+void DabozzEngine::Physics::ButsuriEngine::resolveSphereCollision(size_t a, size_t b)
 {
-    // Find closest point on AABB to sphere center
-    QVector3D closest;
-    closest.setX(std::max(aabb.min.x(), std::min(sphere.center.x(), aabb.max.x())));
-    closest.setY(std::max(aabb.min.y(), std::min(sphere.center.y(), aabb.max.y())));
-    closest.setZ(std::max(aabb.min.z(), std::min(sphere.center.z(), aabb.max.z())));
+    const float radiusA = m_arrays.extentX[a];
+    const float radiusB = m_arrays.extentX[b];
+    const float inverseMassA = m_arrays.inverseMass[a];
+    const float inverseMassB = m_arrays.inverseMass[b];
+    const bool staticA = m_bodies[a].isStatic;
+    const bool staticB = m_bodies[b].isStatic;
+    QVector3D positionA = m_arrays.position(a);
+    QVector3D positionB = m_arrays.position(b);
+    QVector3D velocityA = m_arrays.velocity(a);
+    QVector3D velocityB = m_arrays.velocity(b);
     
-    float distance = (closest - sphere.center).length();
-    return distance < sphere.radius;
-}
-
-void DabozzEngine::Physics::ButsuriEngine::resolveSphereCollision(RigidBodyState& a, RigidBodyState& b)
-{
-    QVector3D delta = b.position - a.position;
+    QVector3D delta = positionB - positionA;
     float distance = delta.length();
-    float overlap = (a.sphere.radius + b.sphere.radius) - distance;
+    float overlap = (radiusA + radiusB) - distance;
     
     if (overlap <= 0) return;
     
     QVector3D normal = delta.normalized();
     
     // Separate spheres
-    float totalInverseMass = a.inverseMass + b.inverseMass;
+    float totalInverseMass = inverseMassA + inverseMassB;
     if (totalInverseMass > 0.0f) {
         QVector3D correction = normal * overlap;
-        if (!a.isStatic) {
-            a.position -= correction * (a.inverseMass / totalInverseMass);
+        if (!staticA) {
+            positionA -= correction * (inverseMassA / totalInverseMass);
         }
-        if (!b.isStatic) {
-            b.position += correction * (b.inverseMass / totalInverseMass);
+        if (!staticB) {
+            positionB += correction * (inverseMassB / totalInverseMass);
         }
     }
     
     // Apply impulse
     float restitution = 0.3f;
-    QVector3D relativeVelocity = b.velocity - a.velocity;
+    QVector3D relativeVelocity = velocityB - velocityA;
     float velocityAlongNormal = QVector3D::dotProduct(relativeVelocity, normal);
     
     if (velocityAlongNormal < 0) {
@@ -358,46 +745,62 @@ void DabozzEngine::Physics::ButsuriEngine::resolveSphereCollision(RigidBodyState
         
         QVector3D impulse = normal * j;
         
-        if (!a.isStatic) {
-            a.velocity -= impulse * a.inverseMass;
+        if (!staticA) {
+            velocityA -= impulse * inverseMassA;
         }
-        if (!b.isStatic) {
-            b.velocity += impulse * b.inverseMass;
+        if (!staticB) {
+            velocityB += impulse * inverseMassB;
         }
     }
+    
+    m_arrays.setPosition(a, positionA);
+    m_arrays.setPosition(b, positionB);
+    m_arrays.setVelocity(a, velocityA);
+    m_arrays.setVelocity(b, velocityB);
 }
 
-void DabozzEngine::Physics::ButsuriEngine::resolveAABBSphereCollision(RigidBodyState& box, RigidBodyState& sphere)
+void DabozzEngine::Physics::ButsuriEngine::resolveAABBSphereCollision(size_t box, size_t sphere)
 {
+    const AABB boxBounds = m_arrays.bounds(box);
+    const float sphereRadius = m_arrays.extentX[sphere];
+    const float boxInverseMass = m_arrays.inverseMass[box];
+    const float sphereInverseMass = m_arrays.inverseMass[sphere];
+    const bool boxStatic = m_bodies[box].isStatic;
+    const bool sphereStatic = m_bodies[sphere].isStatic;
+    QVector3D boxPosition = m_arrays.position(box);
+    QVector3D spherePosition = m_arrays.position(sphere);
+    QVector3D boxVelocity = m_arrays.velocity(box);
+    QVector3D sphereVelocity = m_arrays.velocity(sphere);
+    
     // Find closest point on box to sphere
     QVector3D closest;
-    closest.setX(std::max(box.bounds.min.x(), std::min(sphere.position.x(), box.bounds.max.x())));
-    closest.setY(std::max(box.bounds.min.y(), std::min(sphere.position.y(), box.bounds.max.y())));
-    closest.setZ(std::max(box.bounds.min.z(), std::min(sphere.position.z(), box.bounds.max.z())));
+    closest.setX(std::max(boxBounds.min.x(), std::min(spherePosition.x(), boxBounds.max.x())));
+    closest.setY(std::max(boxBounds.min.y(), std::min(spherePosition.y(), boxBounds.max.y())));
+    closest.setZ(std::max(boxBounds.min.z(), std::min(spherePosition.z(), boxBounds.max.z())));
     
-    QVector3D delta = sphere.position - closest;
+    QVector3D delta = spherePosition - closest;
     float distance = delta.length();
-    float overlap = sphere.sphere.radius - distance;
+    float overlap = sphereRadius - distance;
     
     if (overlap <= 0) return;
     
     QVector3D normal = (distance > 0.0001f) ? delta.normalized() : QVector3D(0, 1, 0);
     
     // Separate
-    float totalInverseMass = box.inverseMass + sphere.inverseMass;
+    float totalInverseMass = boxInverseMass + sphereInverseMass;
     if (totalInverseMass > 0.0f) {
         QVector3D correction = normal * overlap;
-        if (!box.isStatic) {
-            box.position -= correction * (box.inverseMass / totalInverseMass);
+        if (!boxStatic) {
+            boxPosition -= correction * (boxInverseMass / totalInverseMass);
         }
-        if (!sphere.isStatic) {
-            sphere.position += correction * (sphere.inverseMass / totalInverseMass);
+        if (!sphereStatic) {
+            spherePosition += correction * (sphereInverseMass / totalInverseMass);
         }
     }
     
     // Apply impulse
     float restitution = 0.3f;
-    QVector3D relativeVelocity = sphere.velocity - box.velocity;
+    QVector3D relativeVelocity = sphereVelocity - boxVelocity;
     float velocityAlongNormal = QVector3D::dotProduct(relativeVelocity, normal);
     
     if (velocityAlongNormal < 0) {
@@ -406,13 +809,18 @@ void DabozzEngine::Physics::ButsuriEngine::resolveAABBSphereCollision(RigidBodyS
         
         QVector3D impulse = normal * j;
         
-        if (!box.isStatic) {
-            box.velocity -= impulse * box.inverseMass;
+        if (!boxStatic) {
+            boxVelocity -= impulse * boxInverseMass;
         }
-        if (!sphere.isStatic) {
-            sphere.velocity += impulse * sphere.inverseMass;
+        if (!sphereStatic) {
+            sphereVelocity += impulse * sphereInverseMass;
         }
     }
+    
+    m_arrays.setPosition(box, boxPosition);
+    m_arrays.setPosition(sphere, spherePosition);
+    m_arrays.setVelocity(box, boxVelocity);
+    m_arrays.setVelocity(sphere, sphereVelocity);
 }
 
 DabozzEngine::Physics::ButsuriEngine::RaycastHit DabozzEngine::Physics::ButsuriEngine::raycast(const QVector3D& origin, const QVector3D& direction, float maxDistance)
@@ -420,32 +828,36 @@ DabozzEngine::Physics::ButsuriEngine::RaycastHit DabozzEngine::Physics::ButsuriE
     RaycastHit result;
     result.hit = false;
     result.distance = maxDistance;
-    result.bodyId = -1;
+    result.bodyId = INVALID_BODY;
     
     QVector3D dir = direction.normalized();
     
-    for (size_t i = 0; i < m_bodies.size(); i++) {
+    m_tree.raycast(origin, dir, maxDistance, [&](int i, float) {
         float t = 0.0f;
         bool hit = false;
         
+        const AABB bounds = m_arrays.bounds(i);
+        const Sphere sphere{ m_arrays.position(i), m_arrays.extentX[i] };
         if (m_bodies[i].colliderType == ColliderType::Box) {
-            hit = rayAABBIntersect(origin, dir, m_bodies[i].bounds, t);
+            hit = rayAABBIntersect(origin, dir, bounds, t);
         } else {
-            hit = raySphereIntersect(origin, dir, m_bodies[i].sphere, t);
+            hit = raySphereIntersect(origin, dir, sphere, t);
         }
         
-        if (hit && t < result.distance && t >= 0) {
+        // Ties go to the lower ID, whatever order the tree visits them in
+        bool closer = t < result.distance || (result.hit && t == result.distance && m_bodyIds[i] < result.bodyId);
+        if (hit && closer && t >= 0) {
             result.hit = true;
             result.distance = t;
             result.point = origin + dir * t;
-            result.bodyId = i;
+            result.bodyId = m_bodyIds[i];
             
             // Calculate normal (simplified)
             if (m_bodies[i].colliderType == ColliderType::Sphere) {
-                result.normal = (result.point - m_bodies[i].sphere.center).normalized();
+                result.normal = (result.point - sphere.center).normalized();
             } else {
                 // Box normal approximation
-                QVector3D center = (m_bodies[i].bounds.min + m_bodies[i].bounds.max) * 0.5f;
+                QVector3D center = (bounds.min + bounds.max) * 0.5f;
                 QVector3D delta = result.point - center;
                 QVector3D absD(std::abs(delta.x()), std::abs(delta.y()), std::abs(delta.z()));
                 
@@ -458,7 +870,10 @@ DabozzEngine::Physics::ButsuriEngine::RaycastHit DabozzEngine::Physics::ButsuriE
                 }
             }
         }
-    }
+        
+        // Only nearer bodies can still win
+        return result.distance;
+    });
     
     return result;
 }
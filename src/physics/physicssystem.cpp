@@ -6,12 +6,14 @@
 #include "ecs/components/spherecollider.h"
 #include "physics/simplephysics.h"
 #include "debug/logger.h"
+#include <utility>
 
 namespace DabozzEngine::Systems {
 
 PhysicsSystem::PhysicsSystem(ECS::World* world)
     : m_world(world)
     , m_butsuri(nullptr)
+    , m_movedBodies(ECS::View<const ECS::Transform, const ECS::RigidBody>(world).changed<ECS::Transform>())
 {
 }
 
@@ -22,12 +24,66 @@ PhysicsSystem::~PhysicsSystem()
 
 void PhysicsSystem::initialize()
 {
+    if (!m_world || !m_observers.empty()) return;
+
     m_butsuri = Physics::ButsuriEngine::getInstance();
+    if (!m_butsuri) return;
+
+    // Bodies for what's already there go in as one batch
+    std::vector<ECS::EntityID> entities;
+    std::vector<Physics::BodyDesc> descs;
+    m_world->view<const ECS::Transform, ECS::RigidBody, const ECS::BoxCollider>().each(
+        [&](ECS::EntityID entity, const ECS::Transform& transform, ECS::RigidBody& rigidBody, const ECS::BoxCollider& boxCollider) {
+            // Nothing is ours yet, so any ID a RigidBody carries is stale
+            rigidBody.bodyId = -1;
+            
+            Physics::BodyDesc desc;
+            desc.position = transform.position;
+            desc.size = boxCollider.size;
+            desc.mass = rigidBody.mass;
+            desc.isStatic = rigidBody.isStatic;
+            entities.push_back(entity);
+            descs.push_back(desc);
+        });
+    
+    const std::vector<Physics::BodyID> bodies = m_butsuri->createBodies(descs);
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        m_world->getComponent<ECS::RigidBody>(entities[i])->bodyId = bodies[i];
+        setOwner(bodies[i], entities[i]);
+    }
+
+    // Whichever of the three components arrives last completes the body
+    m_observers.push_back(m_world->onAdd<ECS::Transform>([this](ECS::EntityID entity, ECS::Transform&) { createBody(entity); }));
+    m_observers.push_back(m_world->onAdd<ECS::RigidBody>([this](ECS::EntityID entity, ECS::RigidBody&) { createBody(entity); }));
+    m_observers.push_back(m_world->onAdd<ECS::BoxCollider>([this](ECS::EntityID entity, ECS::BoxCollider&) { createBody(entity); }));
+
+    m_observers.push_back(m_world->onRemove<ECS::Transform>([this](ECS::EntityID entity, const ECS::Transform&) { releaseBody(entity); }));
+    m_observers.push_back(m_world->onRemove<ECS::RigidBody>([this](ECS::EntityID entity, const ECS::RigidBody&) { releaseBody(entity); }));
+    m_observers.push_back(m_world->onRemove<ECS::BoxCollider>([this](ECS::EntityID entity, const ECS::BoxCollider&) { releaseBody(entity); }));
 }
 
 void PhysicsSystem::shutdown()
 {
-    // Don't shutdown the engine here - MainWindow owns it
+    // Don't shutdown the engine here - MainWindow owns it, but take our
+    // bodies back out of it
+    for (ECS::World::ObserverID observer : m_observers) {
+        m_world->removeObserver(observer);
+    }
+    m_observers.clear();
+
+    std::vector<Physics::BodyID> bodies;
+    for (const BodyOwner& owner : m_bodyOwners) {
+        if (owner.body == Physics::INVALID_BODY) continue;
+        
+        if (ECS::RigidBody* rigidBody = m_world->getComponent<ECS::RigidBody>(owner.entity)) {
+            rigidBody->bodyId = -1;
+        }
+        bodies.push_back(owner.body);
+    }
+    if (m_butsuri) {
+        m_butsuri->removeBodies(bodies);
+    }
+    m_bodyOwners.clear();
 }
 
 void PhysicsSystem::update(float deltaTime)
@@ -37,47 +93,83 @@ void PhysicsSystem::update(float deltaTime)
         return;
     }
     
-    createPhysicsBodies();
+    // Scripts or the editor may have moved bodies; that wakes them. Our own
+    // writes from the last sync show up here too, but match their bodies.
+    m_movedBodies.each([this](const ECS::Transform& transform, const ECS::RigidBody& rigidBody) {
+        if (rigidBody.bodyId >= 0) {
+            m_butsuri->setBodyPosition(rigidBody.bodyId, transform.position);
+        }
+    });
+    
     m_butsuri->update(deltaTime);
     syncTransforms();
 }
 
-void PhysicsSystem::createPhysicsBodies()
+void PhysicsSystem::createBody(ECS::EntityID entity)
 {
-    if (!m_world || !m_butsuri) return;
-    
-    for (ECS::EntityID entity : m_world->getEntities()) {
-        ECS::Transform* transform = m_world->getComponent<ECS::Transform>(entity);
-        ECS::RigidBody* rigidBody = m_world->getComponent<ECS::RigidBody>(entity);
-        ECS::BoxCollider* boxCollider = m_world->getComponent<ECS::BoxCollider>(entity);
-        
-        if (!transform || !rigidBody || !boxCollider) continue;
-        
-        // Only create body if it doesn't exist yet
-        if (rigidBody->bodyId < 0) {
-            QVector3D size(boxCollider->size.x(), boxCollider->size.y(), boxCollider->size.z());
-            QVector3D pos(transform->position.x(), transform->position.y(), transform->position.z());
-            
-            rigidBody->bodyId = m_butsuri->createBody(pos, size, rigidBody->mass, rigidBody->isStatic);
-        }
+    ECS::RigidBody* rigidBody = m_world->getComponent<ECS::RigidBody>(entity);
+    const ECS::BoxCollider* boxCollider = std::as_const(*m_world).getComponent<ECS::BoxCollider>(entity);
+    const ECS::Transform* transform = std::as_const(*m_world).getComponent<ECS::Transform>(entity);
+    if (!rigidBody || !boxCollider || !transform) return;
+
+    // A copied or restored RigidBody can carry an ID that isn't its own
+    if (rigidBody->bodyId >= 0) {
+        if (ownsBody(entity, rigidBody->bodyId)) return;
+        rigidBody->bodyId = -1;
+    }
+
+    rigidBody->bodyId = m_butsuri->createBody(transform->position, boxCollider->size, rigidBody->mass, rigidBody->isStatic);
+    if (rigidBody->bodyId >= 0) {
+        setOwner(rigidBody->bodyId, entity);
     }
 }
 
+void PhysicsSystem::releaseBody(ECS::EntityID entity)
+{
+    ECS::RigidBody* rigidBody = m_world->getComponent<ECS::RigidBody>(entity);
+    if (!rigidBody || rigidBody->bodyId < 0) return;
+
+    const Physics::BodyID bodyId = rigidBody->bodyId;
+    rigidBody->bodyId = -1;
+    if (!ownsBody(entity, bodyId)) return;
+
+    m_butsuri->removeBody(bodyId);
+    m_bodyOwners[Physics::bodyIndex(bodyId)] = BodyOwner();
+}
+
+bool PhysicsSystem::ownsBody(ECS::EntityID entity, Physics::BodyID body) const
+{
+    const uint32_t slot = Physics::bodyIndex(body);
+    return slot < m_bodyOwners.size() && m_bodyOwners[slot].body == body && m_bodyOwners[slot].entity == entity;
+}
+
+void PhysicsSystem::setOwner(Physics::BodyID body, ECS::EntityID entity)
+{
+    const uint32_t slot = Physics::bodyIndex(body);
+    if (slot >= m_bodyOwners.size()) {
+        m_bodyOwners.resize(slot + 1);
+    }
+    m_bodyOwners[slot] = BodyOwner{ body, entity };
+}
+
 void PhysicsSystem::syncTransforms()
 {
     if (!m_world || !m_butsuri) return;
     
-    for (ECS::EntityID entity : m_world->getEntities()) {
-        ECS::Transform* transform = m_world->getComponent<ECS::Transform>(entity);
-        ECS::RigidBody* rigidBody = m_world->getComponent<ECS::RigidBody>(entity);
+    // Static and sleeping bodies don't move, so only the ones the step
+    // moved are visited
+    for (Physics::BodyID body : m_butsuri->getAwakeBodies()) {
+        const uint32_t slot = Physics::bodyIndex(body);
+        if (slot >= m_bodyOwners.size() || m_bodyOwners[slot].body != body) continue;
         
-        if (!transform || !rigidBody || rigidBody->bodyId < 0) continue;
+        QVector3D position;
+        if (!m_butsuri->getBodyPosition(body, position)) continue;
         
-        Physics::RigidBodyState* body = m_butsuri->getBody(rigidBody->bodyId);
-        if (body) {
-            transform->position.setX(body->position.x());
-            transform->position.setY(body->position.y());
-            transform->position.setZ(body->position.z());
+        const ECS::EntityID entity = m_bodyOwners[slot].entity;
+        ECS::Transform* transform = m_world->getComponent<ECS::Transform>(entity);
+        if (transform && transform->position != position) {
+            transform->position = position;
+            m_world->markChanged<ECS::Transform>(entity);
         }
     }
 }
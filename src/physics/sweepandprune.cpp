@@ -0,0 +1,273 @@
+#include "physics/sweepandprune.h"
+#include "jobs/jobsystem.h"
+#include <algorithm>
+
+namespace DabozzEngine::Physics {
+
+// Entries per scan job
+static constexpr size_t SLICE_SIZE = 256;
+
+static bool overlaps(const AABB& a, const AABB& b)
+{
+    return (a.min.x() <= b.max.x() && a.max.x() >= b.min.x()) &&
+           (a.min.y() <= b.max.y() && a.max.y() >= b.min.y()) &&
+           (a.min.z() <= b.max.z() && a.max.z() >= b.min.z());
+}
+
+int SweepAndPrune::createProxy(const AABB& bounds, int userData, bool isStatic)
+{
+    int proxy;
+    if (m_freeList < 0) {
+        proxy = static_cast<int>(m_proxies.size());
+        m_proxies.emplace_back();
+    } else {
+        proxy = m_freeList;
+        m_freeList = m_proxies[proxy].nextFree;
+    }
+
+    Proxy& state = m_proxies[proxy];
+    state.bounds = fatten(bounds);
+    state.userData = userData;
+    state.isStatic = isStatic;
+    state.nextFree = -1;
+    ++m_proxyCount;
+
+    if (isStatic) {
+        insertStatic(Entry{ state.bounds, proxy });
+    } else {
+        // Sorted into place by the next findPairs
+        m_dynamics.push_back(Entry{ state.bounds, proxy });
+    }
+    return proxy;
+}
+
+void SweepAndPrune::destroyProxy(int proxy)
+{
+    Proxy& state = m_proxies[proxy];
+    std::vector<Entry>& list = state.isStatic ? m_statics : m_dynamics;
+    list.erase(findEntry(list, proxy));
+
+    state.userData = -1;
+    state.nextFree = m_freeList;
+    m_freeList = proxy;
+    --m_proxyCount;
+}
+
+void SweepAndPrune::moveProxy(int proxy, const AABB& bounds)
+{
+    Proxy& state = m_proxies[proxy];
+    const AABB fat = fatten(bounds);
+    if (!state.isStatic) {
+        state.bounds = fat;
+        return;
+    }
+
+    // Static boxes rarely move, but when one does it goes back in order
+    if (fat.min == state.bounds.min && fat.max == state.bounds.max) return;
+    m_statics.erase(findEntry(m_statics, proxy));
+    state.bounds = fat;
+    insertStatic(Entry{ fat, proxy });
+}
+
+void SweepAndPrune::setProxyStatic(int proxy, bool isStatic)
+{
+    Proxy& state = m_proxies[proxy];
+    if (state.isStatic == isStatic) return;
+
+    std::vector<Entry>& from = state.isStatic ? m_statics : m_dynamics;
+    from.erase(findEntry(from, proxy));
+    state.isStatic = isStatic;
+    if (isStatic) {
+        insertStatic(Entry{ state.bounds, proxy });
+    } else {
+        m_dynamics.push_back(Entry{ state.bounds, proxy });
+    }
+}
+
+void SweepAndPrune::setUserData(int proxy, int userData)
+{
+    m_proxies[proxy].userData = userData;
+}
+
+void SweepAndPrune::clear()
+{
+    m_proxies.clear();
+    m_freeList = -1;
+    m_proxyCount = 0;
+    m_statics.clear();
+    m_dynamics.clear();
+    m_axis = 0;
+    m_axisProxyCount = 0;
+}
+
+void SweepAndPrune::findPairs(std::vector<std::pair<int, int>>& pairs, Jobs::JobSystem& jobs)
+{
+    pairs.clear();
+    chooseAxis();
+    sortDynamic();
+    if (m_dynamics.empty()) return;
+
+    const int axis = m_axis;
+    auto minBelow = [axis](const Entry& entry, float value) { return entry.bounds.min[axis] < value; };
+    auto minAbove = [axis](float value, const Entry& entry) { return value < entry.bounds.min[axis]; };
+
+    // Pairs where a dynamic box starts inside a static one are found from
+    // the static side; only statics starting before the last dynamic box
+    // can have any
+    const size_t dynamicCount = m_dynamics.size();
+    const size_t staticCount = std::lower_bound(m_statics.begin(), m_statics.end(),
+                                                m_dynamics.back().bounds.min[axis], minBelow) - m_statics.begin();
+    const size_t total = dynamicCount + staticCount;
+    const size_t sliceCount = (total + SLICE_SIZE - 1) / SLICE_SIZE;
+    if (m_slicePairs.size() < sliceCount) m_slicePairs.resize(sliceCount);
+
+    jobs.parallelFor(total, SLICE_SIZE, [&](size_t begin, size_t end) {
+        std::vector<std::pair<int, int>>& found = m_slicePairs[begin / SLICE_SIZE];
+        found.clear();
+
+        auto add = [&](const Entry& a, const Entry& b) {
+            const int userA = m_proxies[a.proxy].userData;
+            const int userB = m_proxies[b.proxy].userData;
+            found.emplace_back(std::min(userA, userB), std::max(userA, userB));
+        };
+
+        // Statics are in order, so the first dynamic box past each one only
+        // moves forward
+        auto firstAfter = m_dynamics.end();
+        bool walking = false;
+
+        for (size_t index = begin; index < end; ++index) {
+            if (index < dynamicCount) {
+                // Dynamic boxes starting inside this one, and statics
+                // starting inside it or level with it
+                const Entry& entry = m_dynamics[index];
+                const float upper = entry.bounds.max[axis];
+                for (size_t other = index + 1; other < dynamicCount && m_dynamics[other].bounds.min[axis] <= upper; ++other) {
+                    if (overlaps(entry.bounds, m_dynamics[other].bounds)) add(entry, m_dynamics[other]);
+                }
+
+                auto other = std::lower_bound(m_statics.begin(), m_statics.end(), entry.bounds.min[axis], minBelow);
+                for (; other != m_statics.end() && other->bounds.min[axis] <= upper; ++other) {
+                    if (overlaps(entry.bounds, other->bounds)) add(entry, *other);
+                }
+            } else {
+                // Dynamic boxes starting strictly inside this static one
+                const Entry& entry = m_statics[index - dynamicCount];
+                const float lower = entry.bounds.min[axis];
+                const float upper = entry.bounds.max[axis];
+                if (!walking) {
+                    firstAfter = std::upper_bound(m_dynamics.begin(), m_dynamics.end(), lower, minAbove);
+                    walking = true;
+                }
+                while (firstAfter != m_dynamics.end() && firstAfter->bounds.min[axis] <= lower) ++firstAfter;
+
+                for (auto other = firstAfter; other != m_dynamics.end() && other->bounds.min[axis] <= upper; ++other) {
+                    if (overlaps(entry.bounds, other->bounds)) add(entry, *other);
+                }
+            }
+        }
+
+        std::sort(found.begin(), found.end());
+    });
+
+    // Each slice came back sorted; merge them pairwise
+    std::vector<size_t> offsets(sliceCount + 1, 0);
+    for (size_t slice = 0; slice < sliceCount; ++slice) {
+        offsets[slice + 1] = offsets[slice] + m_slicePairs[slice].size();
+    }
+    pairs.reserve(offsets[sliceCount]);
+    for (size_t slice = 0; slice < sliceCount; ++slice) {
+        pairs.insert(pairs.end(), m_slicePairs[slice].begin(), m_slicePairs[slice].end());
+    }
+    for (size_t width = 1; width < sliceCount; width *= 2) {
+        for (size_t first = 0; first + width < sliceCount; first += 2 * width) {
+            const size_t last = std::min(first + 2 * width, sliceCount);
+            std::inplace_merge(pairs.begin() + offsets[first], pairs.begin() + offsets[first + width],
+                               pairs.begin() + offsets[last]);
+        }
+    }
+}
+
+AABB SweepAndPrune::fatten(const AABB& bounds)
+{
+    const float margin = DynamicAABBTree::FAT_MARGIN;
+    const QVector3D grow(margin, margin, margin);
+    return AABB{ bounds.min - grow, bounds.max + grow };
+}
+
+bool SweepAndPrune::entryBefore(const Entry& a, const Entry& b) const
+{
+    return a.bounds.min[m_axis] < b.bounds.min[m_axis];
+}
+
+std::vector<SweepAndPrune::Entry>::iterator SweepAndPrune::findEntry(std::vector<Entry>& list, int proxy)
+{
+    if (&list == &m_dynamics) {
+        return std::find_if(list.begin(), list.end(), [proxy](const Entry& entry) { return entry.proxy == proxy; });
+    }
+
+    // Statics are sorted by the bounds the proxy still holds
+    const Entry key{ m_proxies[proxy].bounds, proxy };
+    auto entry = std::lower_bound(list.begin(), list.end(), key,
+                                  [this](const Entry& a, const Entry& b) { return entryBefore(a, b); });
+    while (entry->proxy != proxy) ++entry;
+    return entry;
+}
+
+void SweepAndPrune::insertStatic(const Entry& entry)
+{
+    auto position = std::upper_bound(m_statics.begin(), m_statics.end(), entry,
+                                     [this](const Entry& a, const Entry& b) { return entryBefore(a, b); });
+    m_statics.insert(position, entry);
+}
+
+void SweepAndPrune::chooseAxis()
+{
+    // Only worth a look once the scene has grown noticeably
+    if (m_proxyCount == 0 || m_proxyCount < m_axisProxyCount * 2) return;
+    m_axisProxyCount = m_proxyCount;
+
+    QVector3D sum(0, 0, 0);
+    QVector3D sumSquares(0, 0, 0);
+    for (const std::vector<Entry>* list : { &m_statics, &m_dynamics }) {
+        for (const Entry& entry : *list) {
+            const QVector3D center = (entry.bounds.min + entry.bounds.max) * 0.5f;
+            sum += center;
+            sumSquares += center * center;
+        }
+    }
+
+    const float count = static_cast<float>(m_proxyCount);
+    const QVector3D variance = sumSquares / count - (sum / count) * (sum / count);
+    int axis = 0;
+    if (variance.y() > variance[axis]) axis = 1;
+    if (variance.z() > variance[axis]) axis = 2;
+    if (axis == m_axis) return;
+
+    m_axis = axis;
+    auto before = [this](const Entry& a, const Entry& b) { return entryBefore(a, b); };
+    std::sort(m_statics.begin(), m_statics.end(), before);
+    std::sort(m_dynamics.begin(), m_dynamics.end(), before);
+}
+
+void SweepAndPrune::sortDynamic()
+{
+    for (Entry& entry : m_dynamics) {
+        entry.bounds = m_proxies[entry.proxy].bounds;
+    }
+
+    // Bodies barely move between steps, so most entries are already in place
+    for (size_t i = 1; i < m_dynamics.size(); ++i) {
+        if (!entryBefore(m_dynamics[i], m_dynamics[i - 1])) continue;
+
+        const Entry entry = m_dynamics[i];
+        size_t j = i;
+        while (j > 0 && entryBefore(entry, m_dynamics[j - 1])) {
+            m_dynamics[j] = m_dynamics[j - 1];
+            --j;
+        }
+        m_dynamics[j] = entry;
+    }
+}
+
+}
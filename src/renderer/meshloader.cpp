@@ -54,21 +54,23 @@ std::vector<ECS::Mesh> MeshLoader::LoadMesh(const std::string& filepath, Skeleto
     for (unsigned int meshIndex = 0; meshIndex < scene->mNumMeshes; ++meshIndex) {
         aiMesh* aiMesh = scene->mMeshes[meshIndex];
         ECS::Mesh mesh;
+        auto data = std::make_shared<ECS::MeshData>();
+        ECS::MeshData& geometry = *data;
 
         for (unsigned int i = 0; i < aiMesh->mNumVertices; i++) {
-            mesh.vertices.push_back(aiMesh->mVertices[i].x);
-            mesh.vertices.push_back(aiMesh->mVertices[i].y);
-            mesh.vertices.push_back(aiMesh->mVertices[i].z);
+            geometry.vertices.push_back(aiMesh->mVertices[i].x);
+            geometry.vertices.push_back(aiMesh->mVertices[i].y);
+            geometry.vertices.push_back(aiMesh->mVertices[i].z);
             
             if (aiMesh->HasNormals()) {
-                mesh.normals.push_back(aiMesh->mNormals[i].x);
-                mesh.normals.push_back(aiMesh->mNormals[i].y);
-                mesh.normals.push_back(aiMesh->mNormals[i].z);
+                geometry.normals.push_back(aiMesh->mNormals[i].x);
+                geometry.normals.push_back(aiMesh->mNormals[i].y);
+                geometry.normals.push_back(aiMesh->mNormals[i].z);
             }
             
             if (aiMesh->mTextureCoords[0]) {
-                mesh.texCoords.push_back(aiMesh->mTextureCoords[0][i].x);
-                mesh.texCoords.push_back(aiMesh->mTextureCoords[0][i].y);
+                geometry.texCoords.push_back(aiMesh->mTextureCoords[0][i].x);
+                geometry.texCoords.push_back(aiMesh->mTextureCoords[0][i].y);
             }
         }
         
@@ -76,8 +78,8 @@ std::vector<ECS::Mesh> MeshLoader::LoadMesh(const std::string& filepath, Skeleto
         if (aiMesh->HasBones()) {
             mesh.hasAnimation = true;
             const int maxBoneInfluence = 4;
-            mesh.boneIds.resize(aiMesh->mNumVertices * maxBoneInfluence, -1);
-            mesh.boneWeights.resize(aiMesh->mNumVertices * maxBoneInfluence, 0.0f);
+            geometry.boneIds.resize(aiMesh->mNumVertices * maxBoneInfluence, -1);
+            geometry.boneWeights.resize(aiMesh->mNumVertices * maxBoneInfluence, 0.0f);
             
             // Build bone name to ID map from skeleton if available
             std::map<std::string, int> boneNameToId;
@@ -111,9 +113,9 @@ std::vector<ECS::Mesh> MeshLoader::LoadMesh(const std::string& filepath, Skeleto
                     
                     // Find empty slot for this bone influence
                     for (int i = 0; i < maxBoneInfluence; i++) {
-                        if (mesh.boneIds[vertexId * maxBoneInfluence + i] == -1) {
-                            mesh.boneIds[vertexId * maxBoneInfluence + i] = globalBoneId;
-                            mesh.boneWeights[vertexId * maxBoneInfluence + i] = weight;
+                        if (geometry.boneIds[vertexId * maxBoneInfluence + i] == -1) {
+                            geometry.boneIds[vertexId * maxBoneInfluence + i] = globalBoneId;
+                            geometry.boneWeights[vertexId * maxBoneInfluence + i] = weight;
                             break;
                         }
                     }
@@ -125,13 +127,13 @@ std::vector<ECS::Mesh> MeshLoader::LoadMesh(const std::string& filepath, Skeleto
         for (unsigned int i = 0; i < aiMesh->mNumFaces; i++) {
             aiFace face = aiMesh->mFaces[i];
             for (unsigned int j = 0; j < face.mNumIndices; j++) {
-                mesh.indices.push_back(face.mIndices[j]);
+                geometry.indices.push_back(face.mIndices[j]);
             }
         }
         
         mesh.modelPath = filepath;
         
-        DEBUG_LOG << "Mesh loaded: " << mesh.vertices.size()/3 << " vertices, " << mesh.indices.size()/3 << " triangles" << std::endl;
+        DEBUG_LOG << "Mesh loaded: " << geometry.vertices.size()/3 << " vertices, " << geometry.indices.size()/3 << " triangles" << std::endl;
         
         if (scene->mNumMaterials > aiMesh->mMaterialIndex) {
             aiMaterial* material = scene->mMaterials[aiMesh->mMaterialIndex];
@@ -172,30 +174,30 @@ std::vector<ECS::Mesh> MeshLoader::LoadMesh(const std::string& filepath, Skeleto
                         
                         if (embeddedTexture->mHeight == 0) {
                             // Compressed format (PNG, JPG, etc)
-                            mesh.embeddedTextureData.assign(
+                            geometry.embeddedTextureData.assign(
                                 reinterpret_cast<const unsigned char*>(embeddedTexture->pcData),
                                 reinterpret_cast<const unsigned char*>(embeddedTexture->pcData) + embeddedTexture->mWidth
                             );
-                            mesh.embeddedTextureWidth = embeddedTexture->mWidth;
+                            geometry.embeddedTextureWidth = embeddedTexture->mWidth;
                             mesh.hasTexture = true;
                             mesh.texturePath = "embedded_compressed";
-                            DEBUG_LOG << "Loaded compressed embedded texture (" << embeddedTexture->achFormatHint << "): " << mesh.embeddedTextureData.size() << " bytes" << std::endl;
+                            DEBUG_LOG << "Loaded compressed embedded texture (" << embeddedTexture->achFormatHint << "): " << geometry.embeddedTextureData.size() << " bytes" << std::endl;
                         } else {
                             // Raw RGBA format
                             int pixelCount = embeddedTexture->mWidth * embeddedTexture->mHeight;
-                            mesh.embeddedTextureData.resize(pixelCount * 4);
+                            geometry.embeddedTextureData.resize(pixelCount * 4);
                             const aiTexel* texels = reinterpret_cast<const aiTexel*>(embeddedTexture->pcData);
                             for (int i = 0; i < pixelCount; i++) {
-                                mesh.embeddedTextureData[i * 4 + 0] = texels[i].r;
-                                mesh.embeddedTextureData[i * 4 + 1] = texels[i].g;
-                                mesh.embeddedTextureData[i * 4 + 2] = texels[i].b;
-                                mesh.embeddedTextureData[i * 4 + 3] = texels[i].a;
+                                geometry.embeddedTextureData[i * 4 + 0] = texels[i].r;
+                                geometry.embeddedTextureData[i * 4 + 1] = texels[i].g;
+                                geometry.embeddedTextureData[i * 4 + 2] = texels[i].b;
+                                geometry.embeddedTextureData[i * 4 + 3] = texels[i].a;
                             }
-                            mesh.embeddedTextureWidth = embeddedTexture->mWidth;
-                            mesh.embeddedTextureHeight = embeddedTexture->mHeight;
+                            geometry.embeddedTextureWidth = embeddedTexture->mWidth;
+                            geometry.embeddedTextureHeight = embeddedTexture->mHeight;
                             mesh.hasTexture = true;
                             mesh.texturePath = "embedded_raw";
-                            DEBUG_LOG << "Loaded raw embedded texture: " << mesh.embeddedTextureWidth << "x" << mesh.embeddedTextureHeight << std::endl;
+                            DEBUG_LOG << "Loaded raw embedded texture: " << geometry.embeddedTextureWidth << "x" << geometry.embeddedTextureHeight << std::endl;
                         }
                     } else {
                         DEBUG_LOG << "ERROR: Invalid texture index " << textureIndex << " (scene has " << scene->mNumTextures << " textures)" << std::endl;
@@ -246,29 +248,29 @@ std::vector<ECS::Mesh> MeshLoader::LoadMesh(const std::string& filepath, Skeleto
                             aiTexture* embeddedTexture = scene->mTextures[0];
                             
                             if (embeddedTexture->mHeight == 0) {
-                                mesh.embeddedTextureData.assign(
+                                geometry.embeddedTextureData.assign(
                                     reinterpret_cast<const unsigned char*>(embeddedTexture->pcData),
                                     reinterpret_cast<const unsigned char*>(embeddedTexture->pcData) + embeddedTexture->mWidth
                                 );
-                                mesh.embeddedTextureWidth = embeddedTexture->mWidth;
+                                geometry.embeddedTextureWidth = embeddedTexture->mWidth;
                                 mesh.hasTexture = true;
                                 mesh.texturePath = "embedded_compressed";
-                                DEBUG_LOG << "Using embedded texture 0: " << mesh.embeddedTextureData.size() << " bytes" << std::endl;
+                                DEBUG_LOG << "Using embedded texture 0: " << geometry.embeddedTextureData.size() << " bytes" << std::endl;
                             } else {
                                 int pixelCount = embeddedTexture->mWidth * embeddedTexture->mHeight;
-                                mesh.embeddedTextureData.resize(pixelCount * 4);
+                                geometry.embeddedTextureData.resize(pixelCount * 4);
                                 const aiTexel* texels = reinterpret_cast<const aiTexel*>(embeddedTexture->pcData);
                                 for (int i = 0; i < pixelCount; i++) {
-                                    mesh.embeddedTextureData[i * 4 + 0] = texels[i].r;
-                                    mesh.embeddedTextureData[i * 4 + 1] = texels[i].g;
-                                    mesh.embeddedTextureData[i * 4 + 2] = texels[i].b;
-                                    mesh.embeddedTextureData[i * 4 + 3] = texels[i].a;
+                                    geometry.embeddedTextureData[i * 4 + 0] = texels[i].r;
+                                    geometry.embeddedTextureData[i * 4 + 1] = texels[i].g;
+                                    geometry.embeddedTextureData[i * 4 + 2] = texels[i].b;
+                                    geometry.embeddedTextureData[i * 4 + 3] = texels[i].a;
                                 }
-                                mesh.embeddedTextureWidth = embeddedTexture->mWidth;
-                                mesh.embeddedTextureHeight = embeddedTexture->mHeight;
+                                geometry.embeddedTextureWidth = embeddedTexture->mWidth;
+                                geometry.embeddedTextureHeight = embeddedTexture->mHeight;
                                 mesh.hasTexture = true;
                                 mesh.texturePath = "embedded_raw";
-                                DEBUG_LOG << "Using embedded texture 0: " << mesh.embeddedTextureWidth << "x" << mesh.embeddedTextureHeight << std::endl;
+                                DEBUG_LOG << "Using embedded texture 0: " << geometry.embeddedTextureWidth << "x" << geometry.embeddedTextureHeight << std::endl;
                             }
                         } else {
                             DEBUG_LOG << "No fallback available - no embedded textures in scene" << std::endl;
@@ -284,35 +286,36 @@ std::vector<ECS::Mesh> MeshLoader::LoadMesh(const std::string& filepath, Skeleto
                     aiTexture* embeddedTexture = scene->mTextures[0];
                     
                     if (embeddedTexture->mHeight == 0) {
-                        mesh.embeddedTextureData.assign(
+                        geometry.embeddedTextureData.assign(
                             reinterpret_cast<const unsigned char*>(embeddedTexture->pcData),
                             reinterpret_cast<const unsigned char*>(embeddedTexture->pcData) + embeddedTexture->mWidth
                         );
-                        mesh.embeddedTextureWidth = embeddedTexture->mWidth;
+                        geometry.embeddedTextureWidth = embeddedTexture->mWidth;
                         mesh.hasTexture = true;
                         mesh.texturePath = "embedded_compressed";
-                        DEBUG_LOG << "Using embedded texture 0: " << mesh.embeddedTextureData.size() << " bytes" << std::endl;
+                        DEBUG_LOG << "Using embedded texture 0: " << geometry.embeddedTextureData.size() << " bytes" << std::endl;
                     } else {
                         int pixelCount = embeddedTexture->mWidth * embeddedTexture->mHeight;
-                        mesh.embeddedTextureData.resize(pixelCount * 4);
+                        geometry.embeddedTextureData.resize(pixelCount * 4);
                         const aiTexel* texels = reinterpret_cast<const aiTexel*>(embeddedTexture->pcData);
                         for (int i = 0; i < pixelCount; i++) {
-                            mesh.embeddedTextureData[i * 4 + 0] = texels[i].r;
-                            mesh.embeddedTextureData[i * 4 + 1] = texels[i].g;
-                            mesh.embeddedTextureData[i * 4 + 2] = texels[i].b;
-                            mesh.embeddedTextureData[i * 4 + 3] = texels[i].a;
+                            geometry.embeddedTextureData[i * 4 + 0] = texels[i].r;
+                            geometry.embeddedTextureData[i * 4 + 1] = texels[i].g;
+                            geometry.embeddedTextureData[i * 4 + 2] = texels[i].b;
+                            geometry.embeddedTextureData[i * 4 + 3] = texels[i].a;
                         }
-                        mesh.embeddedTextureWidth = embeddedTexture->mWidth;
-                        mesh.embeddedTextureHeight = embeddedTexture->mHeight;
+                        geometry.embeddedTextureWidth = embeddedTexture->mWidth;
+                        geometry.embeddedTextureHeight = embeddedTexture->mHeight;
                         mesh.hasTexture = true;
                         mesh.texturePath = "embedded_raw";
-                        DEBUG_LOG << "Using embedded texture 0: " << mesh.embeddedTextureWidth << "x" << mesh.embeddedTextureHeight << std::endl;
+                        DEBUG_LOG << "Using embedded texture 0: " << geometry.embeddedTextureWidth << "x" << geometry.embeddedTextureHeight << std::endl;
                     }
                 }
             }
         } else {
             DEBUG_LOG << "No material for this mesh" << std::endl;
         }
+        mesh.data = std::move(data);
         meshes.push_back(mesh);
     }
     
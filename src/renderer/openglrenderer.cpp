@@ -79,12 +79,234 @@ OpenGLRenderer::~OpenGLRenderer()
     glDeleteBuffers(1, &m_arrowEBO);
     glDeleteVertexArrays(1, &m_skyboxVAO);
     glDeleteBuffers(1, &m_skyboxVBO);
+    for (auto& entry : m_gpuMeshes) {
+        releaseGpuMesh(entry.second);
+    }
+    for (auto& entry : m_fileTextures) {
+        glDeleteTextures(1, &entry.second);
+    }
     doneCurrent();
 }
 
 void OpenGLRenderer::setWorld(DabozzEngine::ECS::World* world)
 {
     m_world = world;
+    m_renderables = DabozzEngine::ECS::View<const DabozzEngine::ECS::Transform, const DabozzEngine::ECS::Mesh>(world);
+}
+
+const OpenGLRenderer::GpuMesh* OpenGLRenderer::gpuMesh(const DabozzEngine::ECS::Mesh& mesh)
+{
+    const DabozzEngine::ECS::MeshData& data = *mesh.data;
+    if (data.vertices.empty()) return nullptr;
+
+    auto it = m_gpuMeshes.find(&data);
+    if (it != m_gpuMeshes.end()) {
+        if (!it->second.data.expired()) return &it->second;
+
+        // The MeshData this was uploaded from is gone; this one reuses its address
+        makeCurrent();
+        releaseGpuMesh(it->second);
+        m_gpuMeshes.erase(it);
+    }
+
+    // Drop uploads of geometry nothing uses anymore every so often
+    if (m_gpuMeshes.size() >= m_gpuMeshSweepSize) {
+        makeCurrent();
+        for (auto entry = m_gpuMeshes.begin(); entry != m_gpuMeshes.end();) {
+            if (entry->second.data.expired()) {
+                releaseGpuMesh(entry->second);
+                entry = m_gpuMeshes.erase(entry);
+            } else {
+                ++entry;
+            }
+        }
+        m_gpuMeshSweepSize = std::max<size_t>(64, m_gpuMeshes.size() * 2);
+    }
+
+    DEBUG_LOG << "Uploading mesh data " << &data << std::endl;
+    makeCurrent();
+
+    GpuMesh& gpu = m_gpuMeshes[&data];
+    gpu.data = mesh.data;
+    gpu.indexCount = static_cast<GLsizei>(data.indices.size());
+
+    glGenVertexArrays(1, &gpu.vao);
+    glGenBuffers(1, &gpu.vbo);
+    glGenBuffers(1, &gpu.ebo);
+    
+    glBindVertexArray(gpu.vao);
+    
+    // Interleave vertex data: position(3) + normal(3) + texcoord(2)
+    std::vector<float> interleavedData;
+    size_t vertexCount = data.vertices.size() / 3;
+    interleavedData.reserve(vertexCount * 8);
+    for (size_t i = 0; i < vertexCount; i++) {
+        // Position
+        interleavedData.push_back(data.vertices[i * 3 + 0]);
+        interleavedData.push_back(data.vertices[i * 3 + 1]);
+        interleavedData.push_back(data.vertices[i * 3 + 2]);
+        // Normal
+        if (i * 3 + 2 < data.normals.size()) {
+            interleavedData.push_back(data.normals[i * 3 + 0]);
+            interleavedData.push_back(data.normals[i * 3 + 1]);
+            interleavedData.push_back(data.normals[i * 3 + 2]);
+        } else {
+            interleavedData.push_back(0.0f);
+            interleavedData.push_back(1.0f);
+            interleavedData.push_back(0.0f);
+        }
+        // TexCoord
+        if (i * 2 + 1 < data.texCoords.size()) {
+            interleavedData.push_back(data.texCoords[i * 2 + 0]);
+            interleavedData.push_back(data.texCoords[i * 2 + 1]);
+        } else {
+            interleavedData.push_back(0.0f);
+            interleavedData.push_back(0.0f);
+        }
+    }
+    
+    glBindBuffer(GL_ARRAY_BUFFER, gpu.vbo);
+    glBufferData(GL_ARRAY_BUFFER, interleavedData.size() * sizeof(float), interleavedData.data(), GL_STATIC_DRAW);
+    
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gpu.ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, data.indices.size() * sizeof(unsigned int), data.indices.data(), GL_STATIC_DRAW);
+    
+    // Position attribute
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    // Normal attribute
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    // TexCoord attribute
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+    
+    // Upload bone data if mesh has animation
+    if (mesh.hasAnimation) {
+        glGenBuffers(1, &gpu.boneVBO);
+        glGenBuffers(1, &gpu.weightVBO);
+        
+        // Bone IDs
+        glBindBuffer(GL_ARRAY_BUFFER, gpu.boneVBO);
+        glBufferData(GL_ARRAY_BUFFER, data.boneIds.size() * sizeof(int), data.boneIds.data(), GL_STATIC_DRAW);
+        glVertexAttribIPointer(3, 4, GL_INT, 4 * sizeof(int), (void*)0);
+        glEnableVertexAttribArray(3);
+        
+        // Bone Weights
+        glBindBuffer(GL_ARRAY_BUFFER, gpu.weightVBO);
+        glBufferData(GL_ARRAY_BUFFER, data.boneWeights.size() * sizeof(float), data.boneWeights.data(), GL_STATIC_DRAW);
+        glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(4);
+        
+        DEBUG_LOG << "Uploaded bone data for animated mesh" << std::endl;
+    }
+    
+    glBindVertexArray(0);
+    return &gpu;
+}
+
+GLuint OpenGLRenderer::textureFor(const DabozzEngine::ECS::Mesh& mesh)
+{
+    // Embedded textures belong to the MeshData, files to their path
+    const bool embedded = !mesh.data->embeddedTextureData.empty();
+    GLuint* slot = embedded ? &m_gpuMeshes[mesh.data.get()].textureID : &m_fileTextures[mesh.texturePath];
+    if (*slot) return *slot;
+
+    const DabozzEngine::ECS::MeshData& data = *mesh.data;
+    makeCurrent();
+
+    DEBUG_LOG << "=== TEXTURE UPLOAD START ===" << std::endl;
+    DEBUG_LOG << "Path: " << mesh.texturePath << std::endl;
+    DEBUG_LOG << "Embedded data size: " << data.embeddedTextureData.size() << std::endl;
+
+    GLuint textureID = 0;
+    glGenTextures(1, &textureID);
+    glBindTexture(GL_TEXTURE_2D, textureID);
+
+    int width = 0, height = 0, channels = 0;
+    const unsigned char* imageData = nullptr;
+    bool loaded = false;
+
+    if (embedded) {
+        if (mesh.texturePath == "embedded_compressed") {
+            DEBUG_LOG << "Loading compressed embedded texture with STB..." << std::endl;
+            imageData = stbi_load_from_memory(
+                data.embeddedTextureData.data(),
+                data.embeddedTextureData.size(),
+                &width, &height, &channels, 4
+            );
+            loaded = (imageData != nullptr);
+        } else if (mesh.texturePath == "embedded_raw") {
+            DEBUG_LOG << "Using raw embedded texture data..." << std::endl;
+            width = data.embeddedTextureWidth;
+            height = data.embeddedTextureHeight;
+            channels = 4;
+            imageData = data.embeddedTextureData.data();
+            loaded = true;
+        }
+    } else if (!mesh.texturePath.empty()) {
+        DEBUG_LOG << "Loading external texture: " << mesh.texturePath << std::endl;
+        imageData = stbi_load(mesh.texturePath.c_str(), &width, &height, &channels, 4);
+        loaded = (imageData != nullptr);
+    }
+    
+    if (loaded && imageData) {
+        DEBUG_LOG << "Texture loaded successfully: " << width << "x" << height << " channels: " << channels << std::endl;
+        
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, imageData);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glGenerateMipmap(GL_TEXTURE_2D);
+        
+        GLenum err = glGetError();
+        if (err != GL_NO_ERROR) {
+            DEBUG_LOG << "OpenGL ERROR during texture upload: " << err << std::endl;
+            mesh.hasTexture = false;
+            glDeleteTextures(1, &textureID);
+            textureID = 0;
+        } else {
+            DEBUG_LOG << "SUCCESS: Texture uploaded to GPU (ID: " << textureID << ")" << std::endl;
+        }
+        
+        // Free STB allocated memory (but not raw embedded data)
+        if (mesh.texturePath != "embedded_raw" && imageData) {
+            stbi_image_free(const_cast<unsigned char*>(imageData));
+        }
+    } else {
+        DEBUG_LOG << "=== TEXTURE LOAD FAILED ===" << std::endl;
+        DEBUG_LOG << "Texture path: " << mesh.texturePath << std::endl;
+        DEBUG_LOG << "Has embedded data: " << (embedded ? "yes" : "no") << std::endl;
+        if (embedded) {
+            DEBUG_LOG << "Embedded data size: " << data.embeddedTextureData.size() << " bytes" << std::endl;
+        }
+        if (mesh.texturePath != "embedded_raw" && mesh.texturePath != "embedded_compressed") {
+            DEBUG_LOG << "STB Error: " << stbi_failure_reason() << std::endl;
+        } else if (mesh.texturePath == "embedded_compressed") {
+            DEBUG_LOG << "STB Error (compressed embedded): " << stbi_failure_reason() << std::endl;
+        }
+        mesh.hasTexture = false;
+        glDeleteTextures(1, &textureID);
+        textureID = 0;
+    }
+    
+    glBindTexture(GL_TEXTURE_2D, 0);
+    DEBUG_LOG << "=== TEXTURE UPLOAD END ===" << std::endl;
+
+    *slot = textureID;
+    return textureID;
+}
+
+void OpenGLRenderer::releaseGpuMesh(GpuMesh& gpu)
+{
+    glDeleteVertexArrays(1, &gpu.vao);
+    glDeleteBuffers(1, &gpu.vbo);
+    glDeleteBuffers(1, &gpu.ebo);
+    if (gpu.boneVBO) glDeleteBuffers(1, &gpu.boneVBO);
+    if (gpu.weightVBO) glDeleteBuffers(1, &gpu.weightVBO);
+    if (gpu.textureID) glDeleteTextures(1, &gpu.textureID);
+    gpu = GpuMesh();
 }
 
 void OpenGLRenderer::setSelectedEntity(DabozzEngine::ECS::EntityID entity)
@@ -143,247 +365,89 @@ void OpenGLRenderer::paintGL()
     
     // Render entities from ECS
     if (m_world) {
-        DEBUG_LOG << "Rendering " << m_world->getEntities().size() << " entities" << std::endl;
-        for (DabozzEngine::ECS::EntityID entity : m_world->getEntities()) {
-            DEBUG_LOG << "Processing entity " << entity << std::endl;
-            DabozzEngine::ECS::Transform* transform = m_world->getComponent<DabozzEngine::ECS::Transform>(entity);
-            DabozzEngine::ECS::Mesh* mesh = m_world->getComponent<DabozzEngine::ECS::Mesh>(entity);
-            
-            DEBUG_LOG << "Entity " << entity << " - transform: " << (transform != nullptr) << " mesh: " << (mesh != nullptr) << std::endl;
-            
-            if (transform && mesh) {
-                DEBUG_LOG << "Entity " << entity << " has mesh, checking upload status: " << mesh->isUploaded << std::endl;
-                // Upload mesh to GPU if not already uploaded
-                if (!mesh->isUploaded && !mesh->vertices.empty()) {
-                    DEBUG_LOG << "Uploading mesh for entity " << entity << std::endl;
-                    makeCurrent();
-                    
-                    glGenVertexArrays(1, &mesh->vao);
-                    glGenBuffers(1, &mesh->vbo);
-                    glGenBuffers(1, &mesh->ebo);
-                    
-                    glBindVertexArray(mesh->vao);
-                    
-                    // Interleave vertex data: position(3) + normal(3) + texcoord(2)
-                    std::vector<float> interleavedData;
-                    size_t vertexCount = mesh->vertices.size() / 3;
-                    for (size_t i = 0; i < vertexCount; i++) {
-                        // Position
-                        interleavedData.push_back(mesh->vertices[i * 3 + 0]);
-                        interleavedData.push_back(mesh->vertices[i * 3 + 1]);
-                        interleavedData.push_back(mesh->vertices[i * 3 + 2]);
-                        // Normal
-                        if (i * 3 + 2 < mesh->normals.size()) {
-                            interleavedData.push_back(mesh->normals[i * 3 + 0]);
-                            interleavedData.push_back(mesh->normals[i * 3 + 1]);
-                            interleavedData.push_back(mesh->normals[i * 3 + 2]);
-                        } else {
-                            interleavedData.push_back(0.0f);
-                            interleavedData.push_back(1.0f);
-                            interleavedData.push_back(0.0f);
-                        }
-                        // TexCoord
-                        if (i * 2 + 1 < mesh->texCoords.size()) {
-                            interleavedData.push_back(mesh->texCoords[i * 2 + 0]);
-                            interleavedData.push_back(mesh->texCoords[i * 2 + 1]);
-                        } else {
-                            interleavedData.push_back(0.0f);
-                            interleavedData.push_back(0.0f);
-                        }
-                    }
-                    
-                    glBindBuffer(GL_ARRAY_BUFFER, mesh->vbo);
-                    glBufferData(GL_ARRAY_BUFFER, interleavedData.size() * sizeof(float), interleavedData.data(), GL_STATIC_DRAW);
-                    
-                    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->ebo);
-                    glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh->indices.size() * sizeof(unsigned int), mesh->indices.data(), GL_STATIC_DRAW);
-                    
-                    // Position attribute
-                    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
-                    glEnableVertexAttribArray(0);
-                    // Normal attribute
-                    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
-                    glEnableVertexAttribArray(1);
-                    // TexCoord attribute
-                    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
-                    glEnableVertexAttribArray(2);
-                    
-                    // Upload bone data if mesh has animation
-                    if (mesh->hasAnimation) {
-                        glGenBuffers(1, &mesh->boneVBO);
-                        glGenBuffers(1, &mesh->weightVBO);
-                        
-                        // Bone IDs
-                        glBindBuffer(GL_ARRAY_BUFFER, mesh->boneVBO);
-                        glBufferData(GL_ARRAY_BUFFER, mesh->boneIds.size() * sizeof(int), mesh->boneIds.data(), GL_STATIC_DRAW);
-                        glVertexAttribIPointer(3, 4, GL_INT, 4 * sizeof(int), (void*)0);
-                        glEnableVertexAttribArray(3);
-                        
-                        // Bone Weights
-                        glBindBuffer(GL_ARRAY_BUFFER, mesh->weightVBO);
-                        glBufferData(GL_ARRAY_BUFFER, mesh->boneWeights.size() * sizeof(float), mesh->boneWeights.data(), GL_STATIC_DRAW);
-                        glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
-                        glEnableVertexAttribArray(4);
-                        
-                        DEBUG_LOG << "Uploaded bone data for animated mesh" << std::endl;
+        if (m_transforms) {
+            m_transforms->update();
+        }
+
+        DEBUG_LOG << "Rendering " << m_renderables.count() << " meshes" << std::endl;
+        // Read-only, so drawing doesn't copy chunks shared with an edit
+        // snapshot
+        const DabozzEngine::ECS::World& world = *m_world;
+        m_renderables.each([&](DabozzEngine::ECS::EntityID entity, const DabozzEngine::ECS::Transform&, const DabozzEngine::ECS::Mesh& meshComponent) {
+            const DabozzEngine::ECS::Mesh* mesh = &meshComponent;
+            // Meshes sharing MeshData share one upload
+            const GpuMesh* gpu = mesh->data ? gpuMesh(*mesh) : nullptr;
+            if (gpu) {
+                const GLuint textureID = mesh->hasTexture ? textureFor(*mesh) : 0;
+
+                // Calculate world transform by multiplying parent transforms
+                QMatrix4x4 modelMatrix = getWorldTransform(entity);
+                
+                m_shaderProgram->setUniformValue("model", modelMatrix);
+                m_shaderProgram->setUniformValue("view", m_view);
+                m_shaderProgram->setUniformValue("projection", m_projection);
+                
+                m_shaderProgram->setUniformValue("lightPos", QVector3D(2.0f, 2.0f, 2.0f));
+                m_shaderProgram->setUniformValue("viewPos", viewPos);
+                m_shaderProgram->setUniformValue("lightColor", QVector3D(1.0f, 1.0f, 1.0f));
+                m_shaderProgram->setUniformValue("roughness", 0.5f);
+                m_shaderProgram->setUniformValue("metallic", 0.0f);
+                m_shaderProgram->setUniformValue("specular", 0.5f);
+                
+                // Check for animator component (on this entity or parent)
+                const DabozzEngine::ECS::Animator* animator = world.getComponent<DabozzEngine::ECS::Animator>(entity);
+                
+                // If not found, check parent
+                if (!animator) {
+                    const DabozzEngine::ECS::Hierarchy* hierarchy = world.getComponent<DabozzEngine::ECS::Hierarchy>(entity);
+                    if (hierarchy && hierarchy->parent != 0) {
+                        animator = world.getComponent<DabozzEngine::ECS::Animator>(hierarchy->parent);
                     }
-                    
-                    glBindVertexArray(0);
-                    
-                    // Upload texture if available
-                    if (mesh->hasTexture && mesh->textureID == 0) {
-                        DEBUG_LOG << "=== TEXTURE UPLOAD START ===" << std::endl;
-                        DEBUG_LOG << "Path: " << mesh->texturePath << std::endl;
-                        DEBUG_LOG << "Embedded data size: " << mesh->embeddedTextureData.size() << std::endl;
-
-                        glGenTextures(1, &mesh->textureID);
-                        glBindTexture(GL_TEXTURE_2D, mesh->textureID);
-
-                        int width = 0, height = 0, channels = 0;
-                        unsigned char* imageData = nullptr;
-                        bool loaded = false;
-
-                        if (!mesh->embeddedTextureData.empty()) {
-                            if (mesh->texturePath == "embedded_compressed") {
-                                DEBUG_LOG << "Loading compressed embedded texture with STB..." << std::endl;
-                                imageData = stbi_load_from_memory(
-                                    mesh->embeddedTextureData.data(),
-                                    mesh->embeddedTextureData.size(),
-                                    &width, &height, &channels, 4
-                                );
-                                loaded = (imageData != nullptr);
-                            } else if (mesh->texturePath == "embedded_raw") {
-                                DEBUG_LOG << "Using raw embedded texture data..." << std::endl;
-                                width = mesh->embeddedTextureWidth;
-                                height = mesh->embeddedTextureHeight;
-                                channels = 4;
-                                imageData = mesh->embeddedTextureData.data();
-                                loaded = true;
-                            }
-                        } else if (!mesh->texturePath.empty()) {
-                            DEBUG_LOG << "Loading external texture: " << mesh->texturePath << std::endl;
-                            imageData = stbi_load(mesh->texturePath.c_str(), &width, &height, &channels, 4);
-                            loaded = (imageData != nullptr);
-                        }
+                }
+                
+                if (m_animationEnabled && animator && mesh->hasAnimation) {
+                    // Upload bone matrices to shader (convert GLM to Qt)
+                    // Both GLM and QMatrix4x4 use column-major storage
+                    // GLM: glmMat[col][row], QMatrix4x4: qtMat(row, col)
+                    for (size_t i = 0; i < animator->boneMatrices.size() && i < 100; i++) {
+                        QString uniformName = QString("finalBonesMatrices[%1]").arg(i);
                         
-                        if (loaded && imageData) {
-                            DEBUG_LOG << "Texture loaded successfully: " << width << "x" << height << " channels: " << channels << std::endl;
-                            
-                            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, imageData);
-                            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-                            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-                            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-                            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-                            glGenerateMipmap(GL_TEXTURE_2D);
-                            
-                            GLenum err = glGetError();
-                            if (err != GL_NO_ERROR) {
-                                DEBUG_LOG << "OpenGL ERROR during texture upload: " << err << std::endl;
-                                mesh->hasTexture = false;
-                                glDeleteTextures(1, &mesh->textureID);
-                                mesh->textureID = 0;
-                            } else {
-                                DEBUG_LOG << "SUCCESS: Texture uploaded to GPU (ID: " << mesh->textureID << ")" << std::endl;
-                            }
-                            
-                            // Free STB allocated memory (but not raw embedded data)
-                            if (mesh->texturePath != "embedded_raw" && imageData) {
-                                stbi_image_free(imageData);
+                        const glm::mat4& glmMat = animator->boneMatrices[i];
+                        QMatrix4x4 qtMat;
+                        // GLM stores column-major: glmMat[col][row]
+                        // QMatrix4x4 operator(row, col) also expects column-major
+                        for (int col = 0; col < 4; col++) {
+                            for (int row = 0; row < 4; row++) {
+                                qtMat(row, col) = glmMat[col][row];
                             }
-                        } else {
-                            DEBUG_LOG << "=== TEXTURE LOAD FAILED ===" << std::endl;
-                            DEBUG_LOG << "Texture path: " << mesh->texturePath << std::endl;
-                            DEBUG_LOG << "Has embedded data: " << (!mesh->embeddedTextureData.empty() ? "yes" : "no") << std::endl;
-                            if (!mesh->embeddedTextureData.empty()) {
-                                DEBUG_LOG << "Embedded data size: " << mesh->embeddedTextureData.size() << " bytes" << std::endl;
-                            }
-                            if (mesh->texturePath != "embedded_raw" && mesh->texturePath != "embedded_compressed") {
-                                DEBUG_LOG << "STB Error: " << stbi_failure_reason() << std::endl;
-                            } else if (mesh->texturePath == "embedded_compressed") {
-                                DEBUG_LOG << "STB Error (compressed embedded): " << stbi_failure_reason() << std::endl;
-                            }
-                            mesh->hasTexture = false;
-                            glDeleteTextures(1, &mesh->textureID);
-                            mesh->textureID = 0;
                         }
                         
-                        glBindTexture(GL_TEXTURE_2D, 0);
-                        DEBUG_LOG << "=== TEXTURE UPLOAD END ===" << std::endl;
+                        m_shaderProgram->setUniformValue(uniformName.toStdString().c_str(), qtMat);
                     }
-                    
-                    mesh->isUploaded = true;
+                    m_shaderProgram->setUniformValue("hasAnimation", 1);
+                } else {
+                    m_shaderProgram->setUniformValue("hasAnimation", 0);
                 }
                 
-                if (mesh->isUploaded) {
-                    // Calculate world transform by multiplying parent transforms
-                    QMatrix4x4 modelMatrix = getWorldTransform(entity);
-                    
-                    m_shaderProgram->setUniformValue("model", modelMatrix);
-                    m_shaderProgram->setUniformValue("view", m_view);
-                    m_shaderProgram->setUniformValue("projection", m_projection);
-                    
-                    m_shaderProgram->setUniformValue("lightPos", QVector3D(2.0f, 2.0f, 2.0f));
-                    m_shaderProgram->setUniformValue("viewPos", viewPos);
-                    m_shaderProgram->setUniformValue("lightColor", QVector3D(1.0f, 1.0f, 1.0f));
-                    m_shaderProgram->setUniformValue("roughness", 0.5f);
-                    m_shaderProgram->setUniformValue("metallic", 0.0f);
-                    m_shaderProgram->setUniformValue("specular", 0.5f);
-                    
-                    // Check for animator component (on this entity or parent)
-                    DabozzEngine::ECS::Animator* animator = m_world->getComponent<DabozzEngine::ECS::Animator>(entity);
-                    
-                    // If not found, check parent
-                    if (!animator) {
-                        DabozzEngine::ECS::Hierarchy* hierarchy = m_world->getComponent<DabozzEngine::ECS::Hierarchy>(entity);
-                        if (hierarchy && hierarchy->parent != 0) {
-                            animator = m_world->getComponent<DabozzEngine::ECS::Animator>(hierarchy->parent);
-                        }
-                    }
-                    
-                    if (m_animationEnabled && animator && mesh->hasAnimation) {
-                        // Upload bone matrices to shader (convert GLM to Qt)
-                        // Both GLM and QMatrix4x4 use column-major storage
-                        // GLM: glmMat[col][row], QMatrix4x4: qtMat(row, col)
-                        for (size_t i = 0; i < animator->boneMatrices.size() && i < 100; i++) {
-                            QString uniformName = QString("finalBonesMatrices[%1]").arg(i);
-                            
-                            const glm::mat4& glmMat = animator->boneMatrices[i];
-                            QMatrix4x4 qtMat;
-                            // GLM stores column-major: glmMat[col][row]
-                            // QMatrix4x4 operator(row, col) also expects column-major
-                            for (int col = 0; col < 4; col++) {
-                                for (int row = 0; row < 4; row++) {
-                                    qtMat(row, col) = glmMat[col][row];
-                                }
-                            }
-                            
-                            m_shaderProgram->setUniformValue(uniformName.toStdString().c_str(), qtMat);
-                        }
-                        m_shaderProgram->setUniformValue("hasAnimation", 1);
-                    } else {
-                        m_shaderProgram->setUniformValue("hasAnimation", 0);
-                    }
-                    
-                    if (mesh->hasTexture && mesh->textureID != 0) {
-                        glActiveTexture(GL_TEXTURE0);
-                        glBindTexture(GL_TEXTURE_2D, mesh->textureID);
-                        m_shaderProgram->setUniformValue("useTexture", 1);
-                        m_shaderProgram->setUniformValue("textureSampler", 0);
-                    } else {
-                        m_shaderProgram->setUniformValue("useTexture", 0);
-                        m_shaderProgram->setUniformValue("objectColor", QVector3D(0.8f, 0.2f, 0.2f));
-                    }
-                    
-                    glBindVertexArray(mesh->vao);
-                    glDrawElements(GL_TRIANGLES, mesh->indices.size(), GL_UNSIGNED_INT, 0);
-                    glBindVertexArray(0);
-                    
-                    if (mesh->hasTexture) {
-                        glBindTexture(GL_TEXTURE_2D, 0);
-                    }
+                if (textureID != 0) {
+                    glActiveTexture(GL_TEXTURE0);
+                    glBindTexture(GL_TEXTURE_2D, textureID);
+                    m_shaderProgram->setUniformValue("useTexture", 1);
+                    m_shaderProgram->setUniformValue("textureSampler", 0);
+                } else {
+                    m_shaderProgram->setUniformValue("useTexture", 0);
+                    m_shaderProgram->setUniformValue("objectColor", QVector3D(0.8f, 0.2f, 0.2f));
+                }
+                
+                glBindVertexArray(gpu->vao);
+                glDrawElements(GL_TRIANGLES, gpu->indexCount, GL_UNSIGNED_INT, 0);
+                glBindVertexArray(0);
+                
+                if (mesh->hasTexture) {
+                    glBindTexture(GL_TEXTURE_2D, 0);
                 }
             }
-        }
+        });
     }
     
     m_shaderProgram->release();
@@ -719,8 +783,9 @@ void OpenGLRenderer::mousePressEvent(QMouseEvent* event)
             m_dragStartPosition = transform->position;
             m_dragStartScale = transform->scale;
             m_dragStartRotation = transform->rotation;
+            m_dragOrigin = getWorldTransform(m_selectedEntity).column(3).toVector3D();
             m_dragPlaneNormal = computeDragPlaneNormal(axisDirection(axis));
-            if (!computeAxisValue(event->position(), transform->position, axisDirection(axis), m_dragPlaneNormal, m_dragStartAxisValue)) {
+            if (!computeAxisValue(event->position(), m_dragOrigin, axisDirection(axis), m_dragPlaneNormal, m_dragStartAxisValue)) {
                 m_draggingGizmo = false;
                 m_activeAxis = GizmoAxis::None;
             }
@@ -757,7 +822,7 @@ void OpenGLRenderer::mouseMoveEvent(QMouseEvent* event)
         if (!transform) return;
 
         float axisValue = 0.0f;
-        if (computeAxisValue(event->position(), m_dragStartPosition, axisDirection(m_activeAxis), m_dragPlaneNormal, axisValue)) {
+        if (computeAxisValue(event->position(), m_dragOrigin, axisDirection(m_activeAxis), m_dragPlaneNormal, axisValue)) {
             const float delta = axisValue - m_dragStartAxisValue;
             
             switch (m_gizmoMode) {
@@ -789,6 +854,7 @@ void OpenGLRenderer::mouseMoveEvent(QMouseEvent* event)
                 }
             }
             
+            m_world->markChanged<DabozzEngine::ECS::Transform>(m_selectedEntity);
             emit selectedEntityTransformChanged(m_selectedEntity);
             update();
         }
@@ -879,21 +945,22 @@ void OpenGLRenderer::renderGizmo()
         return;
     }
 
+    const QVector3D position = getWorldTransform(m_selectedEntity).column(3).toVector3D();
     const QVector3D viewPos = m_hasCamera ? m_cameraPosition : QVector3D(0.0f, 0.0f, 3.0f);
-    float distanceToCamera = (transform->position - viewPos).length();
+    float distanceToCamera = (position - viewPos).length();
     float gizmoScale = distanceToCamera * 0.15f;
 
     glDisable(GL_DEPTH_TEST);
 
     switch (m_gizmoMode) {
         case GizmoMode::Translate:
-            renderTranslateGizmo(transform->position, gizmoScale);
+            renderTranslateGizmo(position, gizmoScale);
             break;
         case GizmoMode::Rotate:
-            renderRotateGizmo(transform->position, gizmoScale);
+            renderRotateGizmo(position, gizmoScale);
             break;
         case GizmoMode::Scale:
-            renderScaleGizmo(transform->position, gizmoScale);
+            renderScaleGizmo(position, gizmoScale);
             break;
     }
 
@@ -1177,9 +1244,10 @@ OpenGLRenderer::GizmoAxis OpenGLRenderer::pickGizmoAxis(const QPointF& mousePos)
     DabozzEngine::ECS::Transform* transform = m_world->getComponent<DabozzEngine::ECS::Transform>(m_selectedEntity);
     if (!transform) return GizmoAxis::None;
 
+    const QVector3D position = getWorldTransform(m_selectedEntity).column(3).toVector3D();
     const Ray ray = makeRayFromMouse(mousePos);
     const QVector3D viewPos = m_hasCamera ? m_cameraPosition : QVector3D(0.0f, 0.0f, 3.0f);
-    float distanceToCamera = (transform->position - viewPos).length();
+    float distanceToCamera = (position - viewPos).length();
     float gizmoScale = distanceToCamera * 0.15f;
     
     const float halfPick = kGizmoPickThickness * 0.5f * gizmoScale;
@@ -1202,10 +1270,10 @@ OpenGLRenderer::GizmoAxis OpenGLRenderer::pickGizmoAxis(const QPointF& mousePos)
             QVector3D planeNormal = axisDirection(axis);
             float denom = QVector3D::dotProduct(planeNormal, ray.direction);
             if (qAbs(denom) > 0.0001f) {
-                float t = QVector3D::dotProduct(transform->position - ray.origin, planeNormal) / denom;
+                float t = QVector3D::dotProduct(position - ray.origin, planeNormal) / denom;
                 if (t > 0) {
                     QVector3D hitPoint = ray.origin + ray.direction * t;
-                    float dist = (hitPoint - transform->position).length();
+                    float dist = (hitPoint - position).length();
                     if (qAbs(dist - radius) < thickness && t < bestHit.t) {
                         bestHit.axis = axis;
                         bestHit.t = t;
@@ -1221,7 +1289,7 @@ OpenGLRenderer::GizmoAxis OpenGLRenderer::pickGizmoAxis(const QPointF& mousePos)
     } else {
         // Pick translate/scale axes
         auto testAxis = [&](GizmoAxis axis, const QVector3D& halfExtents) {
-            const QVector3D center = transform->position + axisDirection(axis) * halfLength;
+            const QVector3D center = position + axisDirection(axis) * halfLength;
             const QVector3D boxMin = center - halfExtents;
             const QVector3D boxMax = center + halfExtents;
             float t = 0.0f;
@@ -1243,10 +1311,10 @@ OpenGLRenderer::GizmoAxis OpenGLRenderer::pickGizmoAxis(const QPointF& mousePos)
             auto testPlane = [&](GizmoAxis axis, const QVector3D& planeNormal) {
                 float denom = QVector3D::dotProduct(planeNormal, ray.direction);
                 if (qAbs(denom) > 0.0001f) {
-                    float t = QVector3D::dotProduct(transform->position - ray.origin, planeNormal) / denom;
+                    float t = QVector3D::dotProduct(position - ray.origin, planeNormal) / denom;
                     if (t > 0) {
                         QVector3D hitPoint = ray.origin + ray.direction * t;
-                        QVector3D localHit = hitPoint - transform->position;
+                        QVector3D localHit = hitPoint - position;
                         
                         if (axis == GizmoAxis::XY) {
                             if (localHit.x() > 0 && localHit.x() < planeSize * 2 &&
@@ -1268,8 +1336,8 @@ OpenGLRenderer::GizmoAxis OpenGLRenderer::pickGizmoAxis(const QPointF& mousePos)
         // Test center cube for scale mode
         if (m_gizmoMode == GizmoMode::Scale) {
             const float centerSize = kGizmoArrowSize * 0.7f * gizmoScale;
-            const QVector3D boxMin = transform->position - QVector3D(centerSize, centerSize, centerSize);
-            const QVector3D boxMax = transform->position + QVector3D(centerSize, centerSize, centerSize);
+            const QVector3D boxMin = position - QVector3D(centerSize, centerSize, centerSize);
+            const QVector3D boxMax = position + QVector3D(centerSize, centerSize, centerSize);
             float t = 0.0f;
             if (intersectRayAabb(ray.origin, ray.direction, boxMin, boxMax, t)) {
                 if (t < bestHit.t) {
@@ -1408,6 +1476,10 @@ void OpenGLRenderer::updateAnimation()
                 if (controller->moveDown) {
                     transform->position -= QVector3D(0.0f, 1.0f, 0.0f) * controller->moveSpeed * deltaTime;
                 }
+                if (controller->moveForward || controller->moveBackward || controller->moveRight ||
+                    controller->moveLeft || controller->moveUp || controller->moveDown) {
+                    m_world->markChanged<DabozzEngine::ECS::Transform>(entity);
+                }
                 
                 m_view.setToIdentity();
                 m_view.rotate(-controller->pitch, 1.0f, 0.0f, 0.0f);
@@ -1504,28 +1576,11 @@ void OpenGLRenderer::renderGrid()
 
 QMatrix4x4 OpenGLRenderer::getWorldTransform(DabozzEngine::ECS::EntityID entity) const
 {
-    if (!m_world) {
+    if (!m_world || !m_transforms) {
         return QMatrix4x4();
     }
-    
-    DabozzEngine::ECS::Transform* transform = m_world->getComponent<DabozzEngine::ECS::Transform>(entity);
-    if (!transform) {
-        return QMatrix4x4();
-    }
-    
-    // Get local transform
-    QMatrix4x4 localMatrix = transform->getModelMatrix();
-    
-    // Check if entity has a parent
-    DabozzEngine::ECS::Hierarchy* hierarchy = m_world->getComponent<DabozzEngine::ECS::Hierarchy>(entity);
-    if (hierarchy && hierarchy->parent != 0) {
-        // Recursively get parent's world transform and multiply
-        QMatrix4x4 parentMatrix = getWorldTransform(hierarchy->parent);
-        return parentMatrix * localMatrix;
-    }
-    
-    // No parent, return local transform
-    return localMatrix;
+
+    return m_transforms->renderMatrix(entity);
 }
 
 
@@ -0,0 +1,288 @@
+/**************************************************************************/
+/*  main.cpp (DabozzRuntime)                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                           DABOZZ ENGINE                                */
+/**************************************************************************/
+/* Copyright (c) 2026-present DabozzEngine contributors.                  */
+/**************************************************************************/
+
+/*
+ * Headless player: loads a .dabozz scene and runs scripts, physics,
+ * animation and audio at a fixed tick without any window, then prints how
+ * long the frames took. For dedicated-server style simulation and for
+ * performance regression runs:
+ *
+ *   DabozzRuntime level.dabozz --frames 600 --tick 60
+ *   DabozzRuntime level.dabozz --frames 600 --realtime
+ *   DabozzRuntime level.dabozz --frames 600 --stats
+ *   DabozzRuntime level.dabozz --replay session.dzinput
+ *   DabozzRuntime level.dabozz --broadphase sap
+ */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QFileInfo>
+#include "editor/scenefile.h"
+#include "ecs/world.h"
+#include "ecs/scheduler.h"
+#include "ecs/gameloop.h"
+#include "ecs/nameindex.h"
+#include "ecs/systems/transformsystem.h"
+#include "ecs/systems/animationsystem.h"
+#include "ecs/systems/audiosystem.h"
+#include "physics/simplephysics.h"
+#include "physics/physicssystem.h"
+#include "scripting/scriptengine.h"
+#include "scripting/scriptapi.h"
+#include "input/inputrecording.h"
+#include "jobs/jobsystem.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <utility>
+#include <vector>
+
+using namespace DabozzEngine;
+
+namespace {
+
+// Lua and AngelScript files in the project's Scripts folder, which sits next
+// to the scene or one level up
+void loadScripts(Scripting::ScriptEngine& scripts, const QString& scenePath, const QString& scriptsPath)
+{
+    QDir dir(scriptsPath);
+    if (scriptsPath.isEmpty()) {
+        QDir sceneDir = QFileInfo(scenePath).absoluteDir();
+        dir = QDir(sceneDir.filePath("Scripts"));
+        if (!dir.exists() && sceneDir.cdUp()) {
+            dir = QDir(sceneDir.filePath("Scripts"));
+        }
+    }
+    if (!dir.exists()) return;
+
+    const QFileInfoList files = dir.entryInfoList(QStringList() << "*.lua" << "*.as", QDir::Files);
+    for (const QFileInfo& file : files) {
+        const std::string path = file.absoluteFilePath().toStdString();
+        const bool loaded = file.suffix().toLower() == "lua"
+            ? scripts.loadLuaScript(path)
+            : scripts.loadAngelScript(path);
+        std::printf("%s script %s\n", loaded ? "Loaded" : "Failed to load", path.c_str());
+    }
+}
+
+double percentile(std::vector<double> values, double fraction)
+{
+    if (values.empty()) return 0.0;
+    const size_t index = std::min(values.size() - 1, static_cast<size_t>(fraction * values.size()));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("DabozzRuntime");
+    app.setOrganizationName("Dabozz Studios");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Runs a DabozzEngine scene without a window and reports frame timings.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("scene", "The .dabozz scene to run.");
+    QCommandLineOption framesOption("frames", "Number of simulation steps to run (default 600).", "count", "600");
+    QCommandLineOption tickOption("tick", "Simulation steps per second (default 60).", "hz", "60");
+    QCommandLineOption scriptsOption("scripts", "Folder to load .lua and .as scripts from.", "path");
+    QCommandLineOption realtimeOption("realtime", "Pace steps to the wall clock instead of running flat out.");
+    QCommandLineOption noAudioOption("no-audio", "Don't open an audio device.");
+    QCommandLineOption statsOption("stats", "Print the World's memory use after loading and at the end.");
+    QCommandLineOption replayOption("replay", "Drive the scene with input recorded in the editor (Play > Record Input). "
+                                              "Runs the whole recording at its tick unless --frames is given.", "file");
+    QCommandLineOption broadPhaseOption("broadphase", "Physics broad phase: tree (default) or sap (sweep and prune).", "type", "tree");
+    parser.addOptions({ framesOption, tickOption, scriptsOption, realtimeOption, noAudioOption, statsOption, replayOption,
+                        broadPhaseOption });
+    parser.process(app);
+
+    if (parser.positionalArguments().size() != 1) {
+        parser.showHelp(1);
+    }
+
+    const QString scenePath = parser.positionalArguments().first();
+    int frameCount = std::max(parser.value(framesOption).toInt(), 1);
+
+    const QString broadPhase = parser.value(broadPhaseOption).toLower();
+    if (broadPhase != "tree" && broadPhase != "sap") {
+        std::fprintf(stderr, "Unknown broad phase %s, expected tree or sap\n", qPrintable(broadPhase));
+        return 1;
+    }
+    float deltaTime = 1.0f / std::max(parser.value(tickOption).toFloat(), 1.0f);
+
+    Input::InputReplayer replayer;
+    const bool replaying = parser.isSet(replayOption);
+    if (replaying) {
+        if (!replayer.load(parser.value(replayOption))) {
+            std::fprintf(stderr, "Could not load input recording %s\n", qPrintable(parser.value(replayOption)));
+            return 1;
+        }
+        // The recording only plays back the same at its own tick
+        deltaTime = replayer.stepSeconds();
+        if (!parser.isSet(framesOption)) {
+            frameCount = static_cast<int>(std::max<uint64_t>(replayer.stepCount(), 1));
+        }
+        std::printf("Replaying %llu steps of input at %.1f Hz\n",
+                    static_cast<unsigned long long>(replayer.stepCount()), 1.0f / deltaTime);
+    }
+    Input::InputManager& input = Input::InputManager::getInstance();
+    input.setLiveInputEnabled(false);
+
+    // This thread owns main-thread jobs, i.e. the script VMs
+    Jobs::JobSystem::instance();
+
+    ECS::World world;
+    ECS::NameIndex names(&world);
+    if (!SceneFile::loadScene(&world, scenePath)) {
+        std::fprintf(stderr, "Could not load scene %s\n", qPrintable(scenePath));
+        return 1;
+    }
+    std::printf("Loaded %s: %zu entities\n", qPrintable(scenePath), world.getEntities().size());
+    if (parser.isSet(statsOption)) {
+        std::printf("\n%s\n", world.stats().format().c_str());
+    }
+
+    Systems::TransformSystem transforms(&world);
+    Systems::AnimationSystem animation(&world);
+
+    Systems::AudioSystem* audio = nullptr;
+    if (!parser.isSet(noAudioOption)) {
+        audio = new Systems::AudioSystem(&world, &transforms);
+        audio->initialize();
+    }
+
+    Physics::ButsuriEngine butsuri;
+    butsuri.initialize();
+    butsuri.setBroadPhase(broadPhase == "sap" ? Physics::BroadPhase::SweepAndPrune : Physics::BroadPhase::Tree);
+    Systems::PhysicsSystem physics(&world);
+    physics.initialize();
+
+    Scripting::ScriptEngine scripts;
+    Scripting::ScriptAPI::SetNameIndex(&names);
+    scripts.initialize(&world);
+    loadScripts(scripts, scenePath, parser.value(scriptsOption));
+    scripts.callLuaStart();
+    scripts.callAngelScriptStart();
+
+    // Same systems and access as the editor's play mode
+    using namespace ECS;
+    Scheduler scheduler;
+    scheduler.addSystem("Scripts", [&](float dt) {
+        Scripting::ScriptAPI::SetDeltaTime(dt);
+        scripts.callLuaUpdate(dt);
+        scripts.callAngelScriptUpdate(dt);
+    }).exclusive().mainThread();
+
+    scheduler.addSystem("Transforms", [&](float) {
+        transforms.update();
+    }).reads<Transform, Hierarchy>();
+
+    scheduler.addSystem("Audio", [&](float dt) {
+        if (!audio) return;
+
+        if (const Transform* camera = std::as_const(world).getComponent<Transform>(names.find("Camera"))) {
+            audio->setListenerPosition(camera->position);
+            audio->setListenerOrientation(camera->rotation.rotatedVector(QVector3D(0, 0, -1)),
+                                          camera->rotation.rotatedVector(QVector3D(0, 1, 0)));
+        }
+        audio->update(dt);
+    }).reads<Name, Transform>().writes<AudioSource>().after("Transforms");
+
+    scheduler.addSystem("Animation", [&](float dt) {
+        animation.update(dt);
+    }).writes<Animator>();
+
+    scheduler.addSystem("Physics", [&](float dt) {
+        physics.update(dt);
+    }).writes<Transform, RigidBody>().reads<BoxCollider, SphereCollider>();
+
+    // Per-step wall time, in total and per system
+    std::vector<double> frameMs;
+    std::map<std::string, std::vector<double>> systemMs;
+    frameMs.reserve(frameCount);
+    double broadPhaseMs = 0.0;
+    uint64_t pairCount = 0;
+
+    auto step = [&](float dt) {
+        if (replaying) {
+            replayer.replayStep(input);
+        }
+        input.beginStep();
+        scheduler.run(dt);
+        input.endStep();
+        frameMs.push_back(scheduler.lastFrameMs());
+        broadPhaseMs += butsuri.getStepStats().broadPhaseMs;
+        pairCount += butsuri.getStepStats().pairCount;
+        for (const Scheduler::SystemTiming& timing : scheduler.timings()) {
+            systemMs[timing.name].push_back(timing.lastMs);
+        }
+    };
+
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start = Clock::now();
+    uint64_t droppedSteps = 0;
+
+    if (parser.isSet(realtimeOption)) {
+        GameLoop loop(step, deltaTime);
+        loop.start();
+        while (loop.stepCount() < static_cast<uint64_t>(frameCount)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        loop.stop();
+        droppedSteps = loop.droppedSteps();
+    } else {
+        for (int frame = 0; frame < frameCount; ++frame) {
+            step(deltaTime);
+        }
+    }
+
+    const double wallMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    scripts.shutdown();
+    physics.shutdown();
+    butsuri.shutdown();
+    if (audio) {
+        audio->shutdown();
+        delete audio;
+    }
+
+    const size_t steps = frameMs.size();
+    double totalMs = 0.0;
+    for (double ms : frameMs) totalMs += ms;
+
+    std::printf("\n%zu steps of %.2f ms (%.1f simulated s) in %.1f ms wall, %zu entities at the end\n",
+                steps, deltaTime * 1000.0f, steps * deltaTime, wallMs, world.getEntities().size());
+    if (droppedSteps > 0) {
+        std::printf("%llu steps dropped to keep up\n", static_cast<unsigned long long>(droppedSteps));
+    }
+    std::printf("%-12s %9s %9s %9s %9s\n", "", "mean ms", "p50 ms", "p95 ms", "max ms");
+    std::printf("%-12s %9.3f %9.3f %9.3f %9.3f\n", "Step",
+                totalMs / steps, percentile(frameMs, 0.5), percentile(frameMs, 0.95),
+                *std::max_element(frameMs.begin(), frameMs.end()));
+    for (const auto& [name, samples] : systemMs) {
+        double sum = 0.0;
+        for (double ms : samples) sum += ms;
+        std::printf("%-12s %9.3f %9.3f %9.3f %9.3f\n", name.c_str(),
+                    sum / samples.size(), percentile(samples, 0.5), percentile(samples, 0.95),
+                    *std::max_element(samples.begin(), samples.end()));
+    }
+    std::printf("\nBroad phase (%s): %.3f ms and %.0f pairs per step, %.2f M pairs/s\n", qPrintable(broadPhase),
+                broadPhaseMs / steps, static_cast<double>(pairCount) / steps,
+                broadPhaseMs > 0.0 ? pairCount / broadPhaseMs / 1000.0 : 0.0);
+
+    if (parser.isSet(statsOption)) {
+        std::printf("\n%s", world.stats().format().c_str());
+    }
+
+    return 0;
+}
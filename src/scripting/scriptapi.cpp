@@ -14,6 +14,9 @@
 #include "scripting/scriptapi.h"
 #include "input/inputmanager.h"
 #include "ecs/world.h"
+#include "ecs/commandbuffer.h"
+#include "ecs/nameindex.h"
+#include "ecs/prefab.h"
 #include "ecs/components/transform.h"
 #include "ecs/components/rigidbody.h"
 #include "ecs/components/name.h"
@@ -22,16 +25,57 @@
 #include "ecs/components/spherecollider.h"
 #include "ecs/components/audiosource.h"
 #include "physics/simplephysics.h"
+#include "editor/scenefile.h"
 #include "debug/logger.h"
 #include <iostream>
+#include <unordered_map>
 
 namespace DabozzEngine {
 namespace Scripting {
 
 ECS::World* ScriptAPI::s_world = nullptr;
+ECS::CommandBuffer* ScriptAPI::s_commands = nullptr;
+ECS::NameIndex* ScriptAPI::s_names = nullptr;
 float ScriptAPI::s_deltaTime = 0.0f;
 std::function<void(const std::string&)> ScriptAPI::s_logCallback = nullptr;
 
+namespace {
+
+// Velocities set on the component also go to the entity's body, which
+// wakes it if it was sleeping
+void SetBodyVelocity(const ECS::RigidBody& rb, const QVector3D& velocity)
+{
+    Physics::ButsuriEngine* butsuri = Physics::ButsuriEngine::getInstance();
+    if (butsuri && rb.bodyId >= 0) {
+        butsuri->setBodyVelocity(rb.bodyId, velocity);
+    }
+}
+
+void AddBodyVelocity(const ECS::RigidBody& rb, const QVector3D& change)
+{
+    Physics::ButsuriEngine* butsuri = Physics::ButsuriEngine::getInstance();
+    if (!butsuri) return;
+    Physics::RigidBodyState body;
+    if (butsuri->getBody(rb.bodyId, body)) {
+        butsuri->setBodyVelocity(rb.bodyId, body.velocity + change);
+    }
+}
+
+}
+
+template<typename T>
+T* ScriptAPI::GetComponent(ECS::EntityID entity)
+{
+    if (T* component = s_world->getComponent<T>(entity)) return component;
+    return s_commands->getPending<T>(entity);
+}
+
+template<typename T>
+bool ScriptAPI::HasComponent(ECS::EntityID entity)
+{
+    return GetComponent<T>(entity) != nullptr;
+}
+
 void ScriptAPI::RegisterLuaAPI(lua_State* L, ECS::World* world)
 {
     s_world = world;
@@ -213,8 +257,8 @@ int ScriptAPI::Lua_CreateEntity(lua_State* L)
         return 1;
     }
 
-    ECS::EntityID entity = s_world->createEntity();
-    s_world->addComponent<ECS::Transform>(entity);
+    ECS::EntityID entity = s_commands->createEntity();
+    s_commands->addComponent<ECS::Transform>(entity);
     
     lua_pushinteger(L, entity);
     return 1;
@@ -225,7 +269,7 @@ int ScriptAPI::Lua_DestroyEntity(lua_State* L)
     if (!s_world) return 0;
 
     ECS::EntityID entity = static_cast<ECS::EntityID>(luaL_checkinteger(L, 1));
-    s_world->destroyEntity(entity);
+    s_commands->destroyEntity(entity);
     return 0;
 }
 
@@ -239,7 +283,7 @@ int ScriptAPI::Lua_GetEntityPosition(lua_State* L)
     }
 
     ECS::EntityID entity = static_cast<ECS::EntityID>(luaL_checkinteger(L, 1));
-    ECS::Transform* transform = s_world->getComponent<ECS::Transform>(entity);
+    ECS::Transform* transform = GetComponent<ECS::Transform>(entity);
 
     if (transform) {
         lua_pushnumber(L, transform->position.x());
@@ -262,9 +306,10 @@ int ScriptAPI::Lua_SetEntityPosition(lua_State* L)
     float y = static_cast<float>(luaL_checknumber(L, 3));
     float z = static_cast<float>(luaL_checknumber(L, 4));
 
-    ECS::Transform* transform = s_world->getComponent<ECS::Transform>(entity);
+    ECS::Transform* transform = GetComponent<ECS::Transform>(entity);
     if (transform) {
         transform->position = QVector3D(x, y, z);
+        s_world->markChanged<ECS::Transform>(entity);
     }
     return 0;
 }
@@ -279,7 +324,7 @@ int ScriptAPI::Lua_GetEntityRotation(lua_State* L)
     }
 
     ECS::EntityID entity = static_cast<ECS::EntityID>(luaL_checkinteger(L, 1));
-    ECS::Transform* transform = s_world->getComponent<ECS::Transform>(entity);
+    ECS::Transform* transform = GetComponent<ECS::Transform>(entity);
 
     if (transform) {
         QVector3D euler = transform->rotation.toEulerAngles();
@@ -303,9 +348,10 @@ int ScriptAPI::Lua_SetEntityRotation(lua_State* L)
     float y = static_cast<float>(luaL_checknumber(L, 3));
     float z = static_cast<float>(luaL_checknumber(L, 4));
 
-    ECS::Transform* transform = s_world->getComponent<ECS::Transform>(entity);
+    ECS::Transform* transform = GetComponent<ECS::Transform>(entity);
     if (transform) {
         transform->rotation = QQuaternion::fromEulerAngles(x, y, z);
+        s_world->markChanged<ECS::Transform>(entity);
     }
     return 0;
 }
@@ -325,24 +371,25 @@ DabozzEngine::ECS::EntityID ScriptAPI::AS_CreateEntity()
 {
     if (!s_world) return ECS::INVALID_ENTITY;
 
-    ECS::EntityID entity = s_world->createEntity();
-    s_world->addComponent<ECS::Transform>(entity);
+    ECS::EntityID entity = s_commands->createEntity();
+    s_commands->addComponent<ECS::Transform>(entity);
     return entity;
 }
 
 void ScriptAPI::AS_DestroyEntity(DabozzEngine::ECS::EntityID entity)
 {
     if (!s_world) return;
-    s_world->destroyEntity(entity);
+    s_commands->destroyEntity(entity);
 }
 
 void ScriptAPI::AS_SetEntityPosition(DabozzEngine::ECS::EntityID entity, float x, float y, float z)
 {
     if (!s_world) return;
 
-    ECS::Transform* transform = s_world->getComponent<ECS::Transform>(entity);
+    ECS::Transform* transform = GetComponent<ECS::Transform>(entity);
     if (transform) {
         transform->position = QVector3D(x, y, z);
+        s_world->markChanged<ECS::Transform>(entity);
     }
 }
 
@@ -353,7 +400,7 @@ void ScriptAPI::AS_GetEntityPosition(DabozzEngine::ECS::EntityID entity, float&
         return;
     }
 
-    ECS::Transform* transform = s_world->getComponent<ECS::Transform>(entity);
+    ECS::Transform* transform = GetComponent<ECS::Transform>(entity);
     if (transform) {
         x = transform->position.x();
         y = transform->position.y();
@@ -379,7 +426,7 @@ int ScriptAPI::Lua_GetEntityScale(lua_State* L)
     }
 
     ECS::EntityID entity = static_cast<ECS::EntityID>(luaL_checkinteger(L, 1));
-    ECS::Transform* transform = s_world->getComponent<ECS::Transform>(entity);
+    ECS::Transform* transform = GetComponent<ECS::Transform>(entity);
 
     if (transform) {
         lua_pushnumber(L, transform->scale.x());
@@ -402,9 +449,10 @@ int ScriptAPI::Lua_SetEntityScale(lua_State* L)
     float y = static_cast<float>(luaL_checknumber(L, 3));
     float z = static_cast<float>(luaL_checknumber(L, 4));
 
-    ECS::Transform* transform = s_world->getComponent<ECS::Transform>(entity);
+    ECS::Transform* transform = GetComponent<ECS::Transform>(entity);
     if (transform) {
         transform->scale = QVector3D(x, y, z);
+        s_world->markChanged<ECS::Transform>(entity);
     }
     return 0;
 }
@@ -417,7 +465,7 @@ int ScriptAPI::Lua_AddRigidbody(lua_State* L)
     float mass = static_cast<float>(luaL_checknumber(L, 2));
     bool isStatic = lua_toboolean(L, 3);
 
-    s_world->addComponent<ECS::RigidBody>(entity, mass, isStatic);
+    s_commands->addComponent<ECS::RigidBody>(entity, mass, isStatic);
     return 0;
 }
 
@@ -430,9 +478,10 @@ int ScriptAPI::Lua_SetVelocity(lua_State* L)
     float y = static_cast<float>(luaL_checknumber(L, 3));
     float z = static_cast<float>(luaL_checknumber(L, 4));
 
-    ECS::RigidBody* rb = s_world->getComponent<ECS::RigidBody>(entity);
+    ECS::RigidBody* rb = GetComponent<ECS::RigidBody>(entity);
     if (rb) {
         rb->velocity = QVector3D(x, y, z);
+        SetBodyVelocity(*rb, rb->velocity);
     }
     return 0;
 }
@@ -447,7 +496,7 @@ int ScriptAPI::Lua_GetVelocity(lua_State* L)
     }
 
     ECS::EntityID entity = static_cast<ECS::EntityID>(luaL_checkinteger(L, 1));
-    ECS::RigidBody* rb = s_world->getComponent<ECS::RigidBody>(entity);
+    ECS::RigidBody* rb = GetComponent<ECS::RigidBody>(entity);
 
     if (rb) {
         lua_pushnumber(L, rb->velocity.x());
@@ -470,9 +519,10 @@ int ScriptAPI::Lua_ApplyForce(lua_State* L)
     float y = static_cast<float>(luaL_checknumber(L, 3));
     float z = static_cast<float>(luaL_checknumber(L, 4));
 
-    ECS::RigidBody* rb = s_world->getComponent<ECS::RigidBody>(entity);
+    ECS::RigidBody* rb = GetComponent<ECS::RigidBody>(entity);
     if (rb) {
         rb->velocity += QVector3D(x, y, z);
+        AddBodyVelocity(*rb, QVector3D(x, y, z));
     }
     return 0;
 }
@@ -486,7 +536,7 @@ int ScriptAPI::Lua_AddBoxCollider(lua_State* L)
     float sizeY = static_cast<float>(luaL_checknumber(L, 3));
     float sizeZ = static_cast<float>(luaL_checknumber(L, 4));
 
-    s_world->addComponent<ECS::BoxCollider>(entity, QVector3D(sizeX, sizeY, sizeZ));
+    s_commands->addComponent<ECS::BoxCollider>(entity, QVector3D(sizeX, sizeY, sizeZ));
     return 0;
 }
 
@@ -497,7 +547,7 @@ int ScriptAPI::Lua_AddSphereCollider(lua_State* L)
     ECS::EntityID entity = static_cast<ECS::EntityID>(luaL_checkinteger(L, 1));
     float radius = static_cast<float>(luaL_checknumber(L, 2));
 
-    s_world->addComponent<ECS::SphereCollider>(entity, radius);
+    s_commands->addComponent<ECS::SphereCollider>(entity, radius);
     return 0;
 }
 
@@ -508,7 +558,7 @@ int ScriptAPI::Lua_LoadMesh(lua_State* L)
     ECS::EntityID entity = static_cast<ECS::EntityID>(luaL_checkinteger(L, 1));
     const char* path = luaL_checkstring(L, 2);
 
-    ECS::Mesh* mesh = s_world->addComponent<ECS::Mesh>(entity);
+    ECS::Mesh* mesh = s_commands->addComponent<ECS::Mesh>(entity);
     if (mesh) {
         mesh->modelPath = std::string(path);
     }
@@ -522,11 +572,12 @@ int ScriptAPI::Lua_CreateCube(lua_State* L)
     ECS::EntityID entity = static_cast<ECS::EntityID>(luaL_checkinteger(L, 1));
     float size = static_cast<float>(luaL_checknumber(L, 2));
 
-    ECS::Mesh* mesh = s_world->addComponent<ECS::Mesh>(entity);
+    ECS::Mesh* mesh = s_commands->addComponent<ECS::Mesh>(entity);
     if (mesh) {
         float halfSize = size / 2.0f;
         
-        mesh->vertices = {
+        auto data = std::make_shared<ECS::MeshData>();
+        data->vertices = {
             -halfSize, -halfSize, -halfSize,  halfSize, -halfSize, -halfSize,  halfSize,  halfSize, -halfSize, -halfSize,  halfSize, -halfSize,
             -halfSize, -halfSize,  halfSize,  halfSize, -halfSize,  halfSize,  halfSize,  halfSize,  halfSize, -halfSize,  halfSize,  halfSize,
             -halfSize,  halfSize,  halfSize, -halfSize,  halfSize, -halfSize, -halfSize, -halfSize, -halfSize, -halfSize, -halfSize,  halfSize,
@@ -535,7 +586,7 @@ int ScriptAPI::Lua_CreateCube(lua_State* L)
             -halfSize,  halfSize, -halfSize,  halfSize,  halfSize, -halfSize,  halfSize,  halfSize,  halfSize, -halfSize,  halfSize,  halfSize
         };
         
-        mesh->normals = {
+        data->normals = {
             0,0,-1, 0,0,-1, 0,0,-1, 0,0,-1,
             0,0,1, 0,0,1, 0,0,1, 0,0,1,
             -1,0,0, -1,0,0, -1,0,0, -1,0,0,
@@ -544,7 +595,7 @@ int ScriptAPI::Lua_CreateCube(lua_State* L)
             0,1,0, 0,1,0, 0,1,0, 0,1,0
         };
         
-        mesh->indices = {
+        data->indices = {
             0,1,2, 2,3,0,
             4,5,6, 6,7,4,
             8,9,10, 10,11,8,
@@ -552,6 +603,7 @@ int ScriptAPI::Lua_CreateCube(lua_State* L)
             16,17,18, 18,19,16,
             20,21,22, 22,23,20
         };
+        mesh->data = std::move(data);
     }
     return 0;
 }
@@ -567,9 +619,10 @@ void ScriptAPI::AS_SetEntityRotation(DabozzEngine::ECS::EntityID entity, float x
 {
     if (!s_world) return;
 
-    ECS::Transform* transform = s_world->getComponent<ECS::Transform>(entity);
+    ECS::Transform* transform = GetComponent<ECS::Transform>(entity);
     if (transform) {
         transform->rotation = QQuaternion::fromEulerAngles(x, y, z);
+        s_world->markChanged<ECS::Transform>(entity);
     }
 }
 
@@ -577,25 +630,27 @@ void ScriptAPI::AS_SetEntityScale(DabozzEngine::ECS::EntityID entity, float x, f
 {
     if (!s_world) return;
 
-    ECS::Transform* transform = s_world->getComponent<ECS::Transform>(entity);
+    ECS::Transform* transform = GetComponent<ECS::Transform>(entity);
     if (transform) {
         transform->scale = QVector3D(x, y, z);
+        s_world->markChanged<ECS::Transform>(entity);
     }
 }
 
 void ScriptAPI::AS_AddRigidbody(DabozzEngine::ECS::EntityID entity, float mass, bool isStatic)
 {
     if (!s_world) return;
-    s_world->addComponent<ECS::RigidBody>(entity, mass, isStatic);
+    s_commands->addComponent<ECS::RigidBody>(entity, mass, isStatic);
 }
 
 void ScriptAPI::AS_SetVelocity(DabozzEngine::ECS::EntityID entity, float x, float y, float z)
 {
     if (!s_world) return;
 
-    ECS::RigidBody* rb = s_world->getComponent<ECS::RigidBody>(entity);
+    ECS::RigidBody* rb = GetComponent<ECS::RigidBody>(entity);
     if (rb) {
         rb->velocity = QVector3D(x, y, z);
+        SetBodyVelocity(*rb, rb->velocity);
     }
 }
 
@@ -603,23 +658,24 @@ void ScriptAPI::AS_ApplyForce(DabozzEngine::ECS::EntityID entity, float x, float
 {
     if (!s_world) return;
 
-    ECS::RigidBody* rb = s_world->getComponent<ECS::RigidBody>(entity);
+    ECS::RigidBody* rb = GetComponent<ECS::RigidBody>(entity);
     if (rb) {
         rb->velocity += QVector3D(x, y, z);
+        AddBodyVelocity(*rb, QVector3D(x, y, z));
     }
 }
 
 void ScriptAPI::AS_AddBoxCollider(DabozzEngine::ECS::EntityID entity, float sizeX, float sizeY, float sizeZ)
 {
     if (!s_world) return;
-    s_world->addComponent<ECS::BoxCollider>(entity, QVector3D(sizeX, sizeY, sizeZ));
+    s_commands->addComponent<ECS::BoxCollider>(entity, QVector3D(sizeX, sizeY, sizeZ));
 }
 
 void ScriptAPI::AS_LoadMesh(DabozzEngine::ECS::EntityID entity, const std::string& path)
 {
     if (!s_world) return;
 
-    ECS::Mesh* mesh = s_world->addComponent<ECS::Mesh>(entity);
+    ECS::Mesh* mesh = s_commands->addComponent<ECS::Mesh>(entity);
     if (mesh) {
         mesh->modelPath = path;
     }
@@ -629,11 +685,12 @@ void ScriptAPI::AS_CreateCube(DabozzEngine::ECS::EntityID entity, float size)
 {
     if (!s_world) return;
 
-    ECS::Mesh* mesh = s_world->addComponent<ECS::Mesh>(entity);
+    ECS::Mesh* mesh = s_commands->addComponent<ECS::Mesh>(entity);
     if (mesh) {
         float halfSize = size / 2.0f;
         
-        mesh->vertices = {
+        auto data = std::make_shared<ECS::MeshData>();
+        data->vertices = {
             -halfSize, -halfSize, -halfSize,  halfSize, -halfSize, -halfSize,  halfSize,  halfSize, -halfSize, -halfSize,  halfSize, -halfSize,
             -halfSize, -halfSize,  halfSize,  halfSize, -halfSize,  halfSize,  halfSize,  halfSize,  halfSize, -halfSize,  halfSize,  halfSize,
             -halfSize,  halfSize,  halfSize, -halfSize,  halfSize, -halfSize, -halfSize, -halfSize, -halfSize, -halfSize, -halfSize,  halfSize,
@@ -642,7 +699,7 @@ void ScriptAPI::AS_CreateCube(DabozzEngine::ECS::EntityID entity, float size)
             -halfSize,  halfSize, -halfSize,  halfSize,  halfSize, -halfSize,  halfSize,  halfSize,  halfSize, -halfSize,  halfSize,  halfSize
         };
         
-        mesh->normals = {
+        data->normals = {
             0,0,-1, 0,0,-1, 0,0,-1, 0,0,-1,
             0,0,1, 0,0,1, 0,0,1, 0,0,1,
             -1,0,0, -1,0,0, -1,0,0, -1,0,0,
@@ -651,7 +708,7 @@ void ScriptAPI::AS_CreateCube(DabozzEngine::ECS::EntityID entity, float size)
             0,1,0, 0,1,0, 0,1,0, 0,1,0
         };
         
-        mesh->indices = {
+        data->indices = {
             0,1,2, 2,3,0,
             4,5,6, 6,7,4,
             8,9,10, 10,11,8,
@@ -659,6 +716,7 @@ void ScriptAPI::AS_CreateCube(DabozzEngine::ECS::EntityID entity, float size)
             16,17,18, 18,19,16,
             20,21,22, 22,23,20
         };
+        mesh->data = std::move(data);
     }
 }
 
@@ -675,14 +733,11 @@ int ScriptAPI::Lua_FindEntityByName(lua_State* L)
     }
 
     const char* name = luaL_checkstring(L, 1);
-    QString qname = QString::fromUtf8(name);
 
-    for (ECS::EntityID entity : s_world->getEntities()) {
-        ECS::Name* nameComp = s_world->getComponent<ECS::Name>(entity);
-        if (nameComp && nameComp->name == qname) {
-            lua_pushinteger(L, entity);
-            return 1;
-        }
+    ECS::EntityID entity = s_names ? s_names->find(QString::fromUtf8(name)) : ECS::INVALID_ENTITY;
+    if (entity != ECS::INVALID_ENTITY) {
+        lua_pushinteger(L, entity);
+        return 1;
     }
 
     lua_pushnil(L);
@@ -696,12 +751,13 @@ int ScriptAPI::Lua_SetEntityName(lua_State* L)
     ECS::EntityID entity = static_cast<ECS::EntityID>(luaL_checkinteger(L, 1));
     const char* name = luaL_checkstring(L, 2);
 
-    ECS::Name* nameComp = s_world->getComponent<ECS::Name>(entity);
+    ECS::Name* nameComp = GetComponent<ECS::Name>(entity);
     if (!nameComp) {
-        nameComp = s_world->addComponent<ECS::Name>(entity);
+        nameComp = s_commands->addComponent<ECS::Name>(entity);
     }
     if (nameComp) {
         nameComp->name = QString::fromUtf8(name);
+        s_world->markChanged<ECS::Name>(entity);
     }
     return 0;
 }
@@ -714,7 +770,7 @@ int ScriptAPI::Lua_GetEntityName(lua_State* L)
     }
 
     ECS::EntityID entity = static_cast<ECS::EntityID>(luaL_checkinteger(L, 1));
-    ECS::Name* nameComp = s_world->getComponent<ECS::Name>(entity);
+    ECS::Name* nameComp = GetComponent<ECS::Name>(entity);
 
     if (nameComp) {
         lua_pushstring(L, nameComp->name.toUtf8().constData());
@@ -794,11 +850,11 @@ int ScriptAPI::Lua_HasComponent(lua_State* L)
     QString compName = QString::fromUtf8(componentName);
 
     bool hasComp = false;
-    if (compName == "Transform") hasComp = s_world->hasComponent<ECS::Transform>(entity);
-    else if (compName == "RigidBody") hasComp = s_world->hasComponent<ECS::RigidBody>(entity);
-    else if (compName == "Mesh") hasComp = s_world->hasComponent<ECS::Mesh>(entity);
-    else if (compName == "BoxCollider") hasComp = s_world->hasComponent<ECS::BoxCollider>(entity);
-    else if (compName == "SphereCollider") hasComp = s_world->hasComponent<ECS::SphereCollider>(entity);
+    if (compName == "Transform") hasComp = HasComponent<ECS::Transform>(entity);
+    else if (compName == "RigidBody") hasComp = HasComponent<ECS::RigidBody>(entity);
+    else if (compName == "Mesh") hasComp = HasComponent<ECS::Mesh>(entity);
+    else if (compName == "BoxCollider") hasComp = HasComponent<ECS::BoxCollider>(entity);
+    else if (compName == "SphereCollider") hasComp = HasComponent<ECS::SphereCollider>(entity);
 
     lua_pushboolean(L, hasComp);
     return 1;
@@ -831,8 +887,30 @@ int ScriptAPI::Lua_SaveScene(lua_State* L)
 int ScriptAPI::Lua_InstantiatePrefab(lua_State* L)
 {
     const char* prefabPath = luaL_checkstring(L, 1);
-    DEBUG_LOG << "[Prefab] Instantiating: " << prefabPath << std::endl;
-    lua_pushnil(L);
+    if (!s_world) {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    // Loaded once per path; every instance shares its mesh data
+    static std::unordered_map<std::string, std::shared_ptr<const ECS::Prefab>> prefabs;
+    auto it = prefabs.find(prefabPath);
+    if (it == prefabs.end()) {
+        auto prefab = std::make_shared<ECS::Prefab>();
+        if (!SceneFile::loadScene(&prefab->world(), QString::fromUtf8(prefabPath))) {
+            DEBUG_LOG << "[Prefab] Failed to load: " << prefabPath << std::endl;
+            lua_pushnil(L);
+            return 1;
+        }
+        it = prefabs.emplace(prefabPath, std::move(prefab)).first;
+    }
+
+    ECS::EntityID root = s_commands->instantiate(it->second);
+    if (root == ECS::INVALID_ENTITY) {
+        lua_pushnil(L);
+        return 1;
+    }
+    lua_pushinteger(L, root);
     return 1;
 }
 
@@ -845,7 +923,7 @@ int ScriptAPI::Lua_LookAt(lua_State* L)
     float targetY = static_cast<float>(luaL_checknumber(L, 3));
     float targetZ = static_cast<float>(luaL_checknumber(L, 4));
 
-    ECS::Transform* transform = s_world->getComponent<ECS::Transform>(entity);
+    ECS::Transform* transform = GetComponent<ECS::Transform>(entity);
     if (transform) {
         QVector3D direction = QVector3D(targetX, targetY, targetZ) - transform->position;
         direction.normalize();
@@ -854,6 +932,7 @@ int ScriptAPI::Lua_LookAt(lua_State* L)
         float pitch = asin(-direction.y()) * 180.0f / 3.14159f;
         
         transform->rotation = QQuaternion::fromEulerAngles(pitch, yaw, 0);
+        s_world->markChanged<ECS::Transform>(entity);
     }
     return 0;
 }
@@ -890,26 +969,22 @@ DabozzEngine::ECS::EntityID ScriptAPI::AS_FindEntityByName(const std::string& na
 {
     if (!s_world) return ECS::INVALID_ENTITY;
 
-    QString qname = QString::fromStdString(name);
-    for (ECS::EntityID entity : s_world->getEntities()) {
-        ECS::Name* nameComp = s_world->getComponent<ECS::Name>(entity);
-        if (nameComp && nameComp->name == qname) {
-            return entity;
-        }
-    }
-    return ECS::INVALID_ENTITY;
+    if (!s_names) return ECS::INVALID_ENTITY;
+
+    return s_names->find(QString::fromStdString(name));
 }
 
 void ScriptAPI::AS_SetEntityName(DabozzEngine::ECS::EntityID entity, const std::string& name)
 {
     if (!s_world) return;
 
-    ECS::Name* nameComp = s_world->getComponent<ECS::Name>(entity);
+    ECS::Name* nameComp = GetComponent<ECS::Name>(entity);
     if (!nameComp) {
-        nameComp = s_world->addComponent<ECS::Name>(entity);
+        nameComp = s_commands->addComponent<ECS::Name>(entity);
     }
     if (nameComp) {
         nameComp->name = QString::fromStdString(name);
+        s_world->markChanged<ECS::Name>(entity);
     }
 }
 
@@ -923,11 +998,11 @@ bool ScriptAPI::AS_HasComponent(DabozzEngine::ECS::EntityID entity, const std::s
     if (!s_world) return false;
 
     QString compName = QString::fromStdString(componentName);
-    if (compName == "Transform") return s_world->hasComponent<ECS::Transform>(entity);
-    if (compName == "RigidBody") return s_world->hasComponent<ECS::RigidBody>(entity);
-    if (compName == "Mesh") return s_world->hasComponent<ECS::Mesh>(entity);
-    if (compName == "BoxCollider") return s_world->hasComponent<ECS::BoxCollider>(entity);
-    if (compName == "SphereCollider") return s_world->hasComponent<ECS::SphereCollider>(entity);
+    if (compName == "Transform") return HasComponent<ECS::Transform>(entity);
+    if (compName == "RigidBody") return HasComponent<ECS::RigidBody>(entity);
+    if (compName == "Mesh") return HasComponent<ECS::Mesh>(entity);
+    if (compName == "BoxCollider") return HasComponent<ECS::BoxCollider>(entity);
+    if (compName == "SphereCollider") return HasComponent<ECS::SphereCollider>(entity);
     return false;
 }
 
@@ -1000,9 +1075,9 @@ int ScriptAPI::Lua_AddSphereRigidbody(lua_State* L)
     float mass = luaL_checknumber(L, 3);
     bool isStatic = lua_toboolean(L, 4);
     
-    auto* rb = s_world->addComponent<ECS::RigidBody>(entity, mass, isStatic, false);
+    auto* rb = s_commands->addComponent<ECS::RigidBody>(entity, mass, isStatic, false);
     if (rb) {
-        auto* sphereCol = s_world->addComponent<ECS::SphereCollider>(entity);
+        auto* sphereCol = s_commands->addComponent<ECS::SphereCollider>(entity);
         if (sphereCol) {
             sphereCol->radius = radius;
         }
@@ -1019,7 +1094,7 @@ int ScriptAPI::Lua_PlayAudio(lua_State* L)
     
     ECS::EntityID entity = luaL_checkinteger(L, 1);
     
-    auto* audio = s_world->getComponent<ECS::AudioSource>(entity);
+    auto* audio = GetComponent<ECS::AudioSource>(entity);
     if (audio) {
         audio->playOnStart = true;
     }
@@ -1033,7 +1108,7 @@ int ScriptAPI::Lua_StopAudio(lua_State* L)
     
     ECS::EntityID entity = luaL_checkinteger(L, 1);
     
-    auto* audio = s_world->getComponent<ECS::AudioSource>(entity);
+    auto* audio = GetComponent<ECS::AudioSource>(entity);
     if (audio) {
         audio->isPlaying = false;
     }
@@ -1047,7 +1122,7 @@ int ScriptAPI::Lua_PauseAudio(lua_State* L)
     
     ECS::EntityID entity = luaL_checkinteger(L, 1);
     
-    auto* audio = s_world->getComponent<ECS::AudioSource>(entity);
+    auto* audio = GetComponent<ECS::AudioSource>(entity);
     if (audio) {
         audio->isPlaying = false;
     }
@@ -1062,9 +1137,10 @@ int ScriptAPI::Lua_SetAudioVolume(lua_State* L)
     ECS::EntityID entity = luaL_checkinteger(L, 1);
     float volume = luaL_checknumber(L, 2);
     
-    auto* audio = s_world->getComponent<ECS::AudioSource>(entity);
+    auto* audio = GetComponent<ECS::AudioSource>(entity);
     if (audio) {
         audio->volume = volume;
+        s_world->markChanged<ECS::AudioSource>(entity);
     }
     
     return 0;
@@ -1077,9 +1153,10 @@ int ScriptAPI::Lua_SetAudioSpatial(lua_State* L)
     ECS::EntityID entity = luaL_checkinteger(L, 1);
     bool spatial = lua_toboolean(L, 2);
     
-    auto* audio = s_world->getComponent<ECS::AudioSource>(entity);
+    auto* audio = GetComponent<ECS::AudioSource>(entity);
     if (audio) {
         audio->spatial = spatial;
+        s_world->markChanged<ECS::AudioSource>(entity);
     }
     
     return 0;
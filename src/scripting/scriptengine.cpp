@@ -32,6 +32,7 @@
 
 #include "scripting/scriptengine.h"
 #include "scripting/scriptapi.h"
+#include "ecs/commandbuffer.h"
 #include "debug/logger.h"
 #include <fstream>
 #include <sstream>
@@ -75,6 +76,8 @@ bool ScriptEngine::initialize(ECS::World* world)
     luaL_openlibs(m_luaState);
 
     if (world) {
+        m_commands = std::make_unique<ECS::CommandBuffer>(world);
+        ScriptAPI::SetCommandBuffer(m_commands.get());
         ScriptAPI::RegisterLuaAPI(m_luaState, world);
     }
 
@@ -117,13 +120,28 @@ void ScriptEngine::shutdown()
         lua_close(m_luaState);
         m_luaState = nullptr;
     }
+
+    if (m_commands) {
+        flushCommands();
+        ScriptAPI::SetCommandBuffer(nullptr);
+        m_commands.reset();
+    }
+}
+
+void ScriptEngine::flushCommands()
+{
+    if (m_commands) {
+        m_commands->playback();
+    }
 }
 
 bool ScriptEngine::loadLuaScript(const std::string& filepath)
 {
     if (!m_luaState) return false;
 
-    if (luaL_dofile(m_luaState, filepath.c_str()) != LUA_OK) {
+    int status = luaL_dofile(m_luaState, filepath.c_str());
+    flushCommands();
+    if (status != LUA_OK) {
         DEBUG_LOG << "Lua error: " << lua_tostring(m_luaState, -1) << std::endl;
         lua_pop(m_luaState, 1);
         return false;
@@ -136,7 +154,9 @@ bool ScriptEngine::executeLuaString(const std::string& code)
 {
     if (!m_luaState) return false;
 
-    if (luaL_dostring(m_luaState, code.c_str()) != LUA_OK) {
+    int status = luaL_dostring(m_luaState, code.c_str());
+    flushCommands();
+    if (status != LUA_OK) {
         DEBUG_LOG << "Lua error: " << lua_tostring(m_luaState, -1) << std::endl;
         lua_pop(m_luaState, 1);
         return false;
@@ -151,7 +171,9 @@ void ScriptEngine::callLuaStart()
     
     lua_getglobal(m_luaState, "Start");
     if (lua_isfunction(m_luaState, -1)) {
-        if (lua_pcall(m_luaState, 0, 0, 0) != LUA_OK) {
+        int status = lua_pcall(m_luaState, 0, 0, 0);
+        flushCommands();
+        if (status != LUA_OK) {
             DEBUG_LOG << "Lua Start() error: " << lua_tostring(m_luaState, -1) << std::endl;
             lua_pop(m_luaState, 1);
         }
@@ -167,7 +189,9 @@ void ScriptEngine::callLuaUpdate(float deltaTime)
     lua_getglobal(m_luaState, "Update");
     if (lua_isfunction(m_luaState, -1)) {
         lua_pushnumber(m_luaState, deltaTime);
-        if (lua_pcall(m_luaState, 1, 0, 0) != LUA_OK) {
+        int status = lua_pcall(m_luaState, 1, 0, 0);
+        flushCommands();
+        if (status != LUA_OK) {
             DEBUG_LOG << "Lua Update() error: " << lua_tostring(m_luaState, -1) << std::endl;
             lua_pop(m_luaState, 1);
         }
@@ -225,6 +249,7 @@ bool ScriptEngine::executeAngelScriptString(const std::string& code)
 
     m_asContext->Prepare(func);
     int r = m_asContext->Execute();
+    flushCommands();
     if (r != asEXECUTION_FINISHED) {
         DEBUG_LOG << "ERROR: AngelScript execution failed" << std::endl;
         return false;
@@ -245,6 +270,7 @@ void ScriptEngine::callAngelScriptStart()
     
     m_asContext->Prepare(func);
     int r = m_asContext->Execute();
+    flushCommands();
     if (r != asEXECUTION_FINISHED) {
         DEBUG_LOG << "ERROR: AngelScript Start() execution failed" << std::endl;
     }
@@ -263,6 +289,7 @@ void ScriptEngine::callAngelScriptUpdate(float deltaTime)
     m_asContext->Prepare(func);
     m_asContext->SetArgFloat(0, deltaTime);
     int r = m_asContext->Execute();
+    flushCommands();
     if (r != asEXECUTION_FINISHED) {
         DEBUG_LOG << "ERROR: AngelScript Update() execution failed" << std::endl;
     }